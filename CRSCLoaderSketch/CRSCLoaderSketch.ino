@@ -50,6 +50,7 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <IFTTTMessage.h>
 
 #include "CRSCConfig.h"
+#include "CRSCScheduler.h"
 
 
 // Configuration values that are the same for all boards
@@ -61,8 +62,8 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 IFTTTMessageClass IFTTTSender;   // Communicates with ifttt.com
 
 
-// How often to run out main loop (milliseconds)
-#define UPDATE_INTERVAL    50
+// Runs the loader only when characters arrive, rather than waking every 50 ms to look
+CRSCScheduler TheScheduler;
 
 // Configuration object to load/store information in EEPROM
 CRSCConfigClass TheConfiguration;
@@ -92,7 +93,7 @@ void setup()
   
   
     // We can now initialize fields to be sent to IFTTT
-    IFTTTSender.Initialize (TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID()); // have to make last one printable
+    IFTTTSender.Initialize (TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID(), "CRSCLoader"); // have to make last one printable
 
     // Turn LED on so we know it works
     pinMode (LED_BUILTIN, OUTPUT);
@@ -101,10 +102,36 @@ void setup()
     Serial.print (F("\nMake sure the LED works. It should be on now\n\n"));
     Serial.print (F("\nEnter board ID: "));
     Serial.flush();
+
+    TheScheduler.AddTask (SerialTask, NULL, SerialInputWaiting);
 }
 
 // -------------------------------------------------------
 void loop() 
+{
+    // Run the serial task if there's input for it, otherwise sleep
+    TheScheduler.RunOnce();
+}
+
+// -------------------------------------------------------
+// Returns true when characters are waiting on the serial port and we still want them.
+// Once a board ID is loaded anything else typed is left unread.
+bool SerialInputWaiting (void* arg)
+{
+    return ((Serial.available() > 0) && (BoardIDIndex < BOARD_ID_BYTES+BOARD_ID_CHECK_BYTES));
+}
+
+// -------------------------------------------------------
+// Collect the board ID as it is typed and load it once it's all there
+void SerialTask (void* arg)
+{
+    serialEvent();           // Should be called automatically - isn't
+    LoadBoardID();
+}
+
+// -------------------------------------------------------
+// Once the user has typed a complete board ID, check it, store it and tell ifttt.com
+void LoadBoardID (void) 
 {
     static bool weAreDone = false;
 
@@ -127,16 +154,25 @@ void loop()
             if (WiFi.status() == WL_CONNECTED)
             {
                // And send an appropriate message to ifttt.com
-               IFTTTSender.Initialize(TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID());
+               IFTTTSender.Initialize(TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID(), "CRSCLoader");
 
-               if (IFTTTSender.Send ("Board Configuration and Test Complete") == true)
+               // There's nothing else for the loader to do in the mean time, so just wait
+               // for the send to finish
+               IFTTTSender.StartSend ("Board Configuration and Test Complete");
+               while (IFTTTSender.Update() != IFTTTMessageClass::IFTTT_STATE_IDLE)
+               {
+                   delay (10);
+               }
+
+               if (IFTTTSender.GetResult() == IFTTTMessageClass::IFTTT_RESULT_SUCCESS)
                {
                    // We have successfully sent our message
                    Serial.println (F("Message successfully sent to ifttt.com\n"));
                }
                else
                {
-                    Serial.print (F("*** ERROR: Unable to send message via ifttt.com ***\n")); 
+                    Serial.print (F("*** ERROR: Unable to send message via ifttt.com (HTTP ")); Serial.print (IFTTTSender.GetHTTPCode());
+                    Serial.print (F(") ***\n")); 
                 }
             }
             else
@@ -164,13 +200,11 @@ void loop()
         }
       
     }
-    serialEvent();           // Should be called automatically - isn't
-    delay (UPDATE_INTERVAL);
 }
 
 
 // -------------------------------------------------------
-// This function is automatically called between repetitions of loop()
+// Called by the serial task - isn't called automatically on the 8266
 void serialEvent() 
 {
 
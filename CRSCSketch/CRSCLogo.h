@@ -0,0 +1,140 @@
+#ifndef _CRSCLOGO_H
+#define _CRSCLOGO_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Generated by CRSCBannerGen from CRSCSketch/CRSCLogo.txt - edit that and run it again rather than
+// changing this. 4349 bytes of text in 1583.
+
+#include <Arduino.h>
+
+static const uint8_t CRSCLogo[] PROGMEM =
+{
+    0x0d,0x0a,0x0d,0x0a,0x0d,0x0a,0xe0,0x40,0x0d,0x0a,0x8f,0x40,0x26,0x28,0x2f,0x23,
+    0x96,0x40,0x28,0x2f,0x28,0x97,0x40,0x25,0x2f,0x2f,0x25,0x90,0x40,0x0d,0x0a,0x8d,
+    0x40,0x2e,0x84,0x20,0x2c,0x90,0x40,0x2e,0x84,0x20,0x2a,0x91,0x40,0x23,0x85,0x20,
+    0x26,0x8d,0x40,0x0d,0x0a,0x8b,0x40,0x26,0x2e,0x20,0x20,0x26,0x80,0x25,0x28,0x20,
+    0x20,0x2c,0x8e,0x40,0x2e,0x20,0x20,0x82,0x2c,0x80,0x20,0x8f,0x40,0x25,0x20,0x20,
+    0x2a,0x81,0x28,0x2e,0x20,0x20,0x26,0x8c,0x40,0x0d,0x0a,0x8b,0x40,0x26,0x20,0x20,
+    0x2e,0x82,0x25,0x2e,0x20,0x2e,0x8e,0x40,0x80,0x20,0x82,0x2c,0x80,0x20,0x8f,0x40,
+    0x2f,0x20,0x20,0x82,0x28,0x2a,0x20,0x20,0x26,0x8c,0x40,0x0d,0x0a,0x82,0x40,0x2f,
+    0x88,0x20,0x2e,0x82,0x25,0x2e,0x93,0x20,0x82,0x2c,0x95,0x20,0x82,0x28,0x2a,0x87,
+    0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,0x94,0x25,0x2f,0x20,
+    0x20,0x98,0x2c,0x20,0x20,0x2a,0x94,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,
+    0x82,0x40,0x2f,0x20,0x20,0x28,0x94,0x25,0x2f,0x20,0x20,0x98,0x2c,0x20,0x20,0x2c,
+    0x94,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,
+    0x94,0x25,0x2f,0x20,0x20,0x98,0x2c,0x20,0x20,0x2c,0x94,0x28,0x2a,0x20,0x20,0x26,
+    0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,0x94,0x25,0x2f,0x84,0x20,0x8e,
+    0x2c,0x84,0x20,0x2c,0x94,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,
+    0x2f,0x20,0x20,0x28,0x9a,0x25,0x2c,0x20,0x20,0x8c,0x2c,0x20,0x20,0x2e,0x9a,0x28,
+    0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,0x9b,0x25,
+    0x80,0x20,0x8a,0x2c,0x80,0x20,0x9b,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,
+    0x82,0x40,0x2f,0x20,0x20,0x28,0x99,0x25,0x26,0x28,0x20,0x20,0x2e,0x8a,0x2c,0x2e,
+    0x20,0x20,0x2a,0x9a,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,
+    0x20,0x20,0x28,0x94,0x25,0x2f,0x84,0x20,0x8e,0x2c,0x84,0x20,0x2c,0x94,0x28,0x2a,
+    0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,0x94,0x25,0x2f,
+    0x20,0x20,0x98,0x2c,0x20,0x20,0x2c,0x94,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,
+    0x0a,0x82,0x40,0x2f,0x20,0x20,0x28,0x94,0x25,0x2f,0x20,0x20,0x98,0x2c,0x20,0x20,
+    0x2c,0x94,0x28,0x2a,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,
+    0x28,0x94,0x25,0x2f,0x20,0x20,0x98,0x2c,0x20,0x20,0x2c,0x94,0x28,0x2a,0x20,0x20,
+    0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x23,0x87,0x20,0x2c,0x26,0x80,0x25,0x28,0x97,
+    0x20,0x2e,0x81,0x2c,0x2e,0x92,0x20,0x82,0x28,0x2e,0x87,0x20,0x26,0x84,0x40,0x0d,
+    0x0a,0x87,0x40,0x26,0x80,0x25,0x28,0x80,0x20,0x2c,0x26,0x25,0x28,0x20,0x20,0x2a,
+    0x85,0x25,0x40,0x40,0x25,0x87,0x2c,0x20,0x20,0x2e,0x2c,0x2c,0x2e,0x80,0x20,0x2e,
+    0x81,0x2c,0x2f,0x40,0x40,0x26,0x85,0x28,0x2c,0x20,0x20,0x80,0x28,0x2e,0x80,0x20,
+    0x2f,0x80,0x28,0x25,0x89,0x40,0x0d,0x0a,0x88,0x40,0x26,0x81,0x25,0x23,0x80,0x20,
+    0x2f,0x28,0x20,0x20,0x2a,0x85,0x25,0x26,0x40,0x40,0x2a,0x86,0x2c,0x20,0x20,0x2e,
+    0x2e,0x80,0x20,0x2e,0x83,0x2c,0x26,0x40,0x40,0x86,0x28,0x2c,0x20,0x20,0x28,0x2a,
+    0x80,0x20,0x2f,0x81,0x28,0x26,0x8a,0x40,0x0d,0x0a,0x8a,0x40,0x26,0x81,0x25,0x23,
+    0x82,0x20,0x2a,0x86,0x25,0x40,0x40,0x23,0x86,0x2c,0x82,0x20,0x2e,0x84,0x2c,0x2a,
+    0x40,0x40,0x26,0x86,0x28,0x2c,0x82,0x20,0x2f,0x81,0x28,0x25,0x8c,0x40,0x0d,0x0a,
+    0x8b,0x40,0x26,0x82,0x25,0x23,0x80,0x2e,0x2f,0x86,0x25,0x26,0x40,0x40,0x2a,0x85,
+    0x2c,0x80,0x20,0x2e,0x86,0x2c,0x25,0x40,0x40,0x87,0x28,0x2a,0x80,0x2e,0x2f,0x82,
+    0x28,0x26,0x8d,0x40,0x0d,0x0a,0x8d,0x40,0x26,0x82,0x25,0x26,0x26,0x88,0x25,0x40,
+    0x40,0x23,0x91,0x2c,0x2a,0x40,0x40,0x23,0x8f,0x28,0x23,0x8f,0x40,0x0d,0x0a,0x8e,
+    0x40,0x26,0x25,0x2e,0x83,0x20,0x2e,0x85,0x25,0x26,0x40,0x26,0x2a,0x82,0x2c,0x86,
+    0x20,0x82,0x2c,0x28,0x40,0x26,0x85,0x28,0x2f,0x84,0x20,0x2e,0x2f,0x25,0x90,0x40,
+    0x0d,0x0a,0x8d,0x40,0x25,0x80,0x20,0x2e,0x28,0x23,0x23,0x2f,0x2e,0x80,0x20,0x23,
+    0x83,0x25,0x26,0x40,0x25,0x2c,0x2c,0x2e,0x81,0x20,0x2e,0x80,0x2c,0x2e,0x81,0x20,
+    0x2e,0x2c,0x2c,0x40,0x40,0x84,0x28,0x2c,0x81,0x20,0x2a,0x2f,0x2f,0x2c,0x81,0x20,
+    0x25,0x8f,0x40,0x0d,0x0a,0x8c,0x40,0x28,0x20,0x20,0x2c,0x40,0x26,0x83,0x25,0x2e,
+    0x20,0x20,0x2c,0x83,0x25,0x40,0x40,0x2a,0x80,0x20,0x2e,0x86,0x2c,0x2e,0x80,0x20,
+    0x28,0x40,0x25,0x83,0x28,0x2e,0x20,0x20,0x2e,0x82,0x28,0x2c,0x82,0x20,0x28,0x8e,
+    0x40,0x0d,0x0a,0x8b,0x40,0x26,0x20,0x20,0x2e,0x81,0x40,0x82,0x25,0x26,0x80,0x20,
+    0x23,0x82,0x25,0x26,0x40,0x2c,0x20,0x20,0x8a,0x2c,0x20,0x20,0x2c,0x40,0x83,0x28,
+    0x2f,0x88,0x20,0x2a,0x40,0x2e,0x20,0x2e,0x8e,0x40,0x0d,0x0a,0x8b,0x40,0x26,0x20,
+    0x20,0x2e,0x82,0x40,0x26,0x80,0x25,0x26,0x2e,0x20,0x20,0x23,0x83,0x25,0x26,0x80,
+    0x20,0x8a,0x2c,0x80,0x20,0x25,0x83,0x28,0x2f,0x83,0x20,0x2e,0x2f,0x26,0x81,0x40,
+    0x2e,0x20,0x20,0x8e,0x40,0x0d,0x0a,0x8b,0x40,0x26,0x20,0x20,0x2e,0x83,0x40,0x26,
+    0x25,0x25,0x26,0x2e,0x20,0x20,0x23,0x84,0x25,0x80,0x20,0x8a,0x2c,0x80,0x20,0x84,
+    0x28,0x2f,0x20,0x20,0x2c,0x80,0x28,0x26,0x83,0x40,0x2e,0x20,0x20,0x8e,0x40,0x0d,
+    0x0a,0x8c,0x40,0x2a,0x20,0x20,0x28,0x84,0x40,0x26,0x28,0x80,0x20,0x26,0x84,0x25,
+    0x80,0x20,0x8a,0x2c,0x80,0x20,0x85,0x28,0x80,0x20,0x2f,0x23,0x84,0x40,0x23,0x20,
+    0x20,0x2a,0x8e,0x40,0x0d,0x0a,0x8d,0x40,0x2c,0x80,0x20,0x26,0x81,0x40,0x26,0x80,
+    0x20,0x2c,0x26,0x85,0x25,0x80,0x20,0x8a,0x2c,0x80,0x20,0x86,0x28,0x81,0x20,0x26,
+    0x81,0x40,0x26,0x80,0x20,0x2c,0x8f,0x40,0x0d,0x0a,0x8e,0x40,0x28,0x20,0x20,0x25,
+    0x81,0x40,0x28,0x20,0x20,0x28,0x87,0x25,0x80,0x20,0x89,0x2c,0x2a,0x2e,0x20,0x20,
+    0x86,0x28,0x23,0x2c,0x20,0x20,0x28,0x81,0x40,0x25,0x20,0x20,0x28,0x90,0x40,0x0d,
+    0x0a,0x8e,0x40,0x28,0x20,0x20,0x25,0x81,0x40,0x28,0x20,0x20,0x23,0x40,0x26,0x85,
+    0x25,0x84,0x20,0x82,0x2c,0x84,0x20,0x85,0x28,0x26,0x40,0x2a,0x20,0x20,0x28,0x81,
+    0x40,0x25,0x20,0x20,0x28,0x90,0x40,0x0d,0x0a,0x8c,0x40,0x26,0x2c,0x80,0x20,0x25,
+    0x81,0x40,0x28,0x80,0x20,0x2c,0x25,0x40,0x26,0x85,0x25,0x2f,0x81,0x20,0x82,0x2c,
+    0x81,0x20,0x2a,0x86,0x28,0x40,0x25,0x2e,0x80,0x20,0x28,0x81,0x40,0x25,0x80,0x20,
+    0x2c,0x26,0x8e,0x40,0x0d,0x0a,0x88,0x40,0x2f,0x84,0x20,0x26,0x84,0x40,0x84,0x20,
+    0x2a,0x26,0x28,0x2e,0x86,0x20,0x80,0x2c,0x86,0x20,0x2e,0x2f,0x28,0x2c,0x84,0x20,
+    0x26,0x40,0x25,0x20,0x20,0x26,0x40,0x26,0x84,0x20,0x2f,0x8a,0x40,0x0d,0x0a,0x85,
+    0x40,0x2e,0x82,0x20,0x28,0x40,0x28,0x80,0x20,0x2f,0x80,0x26,0x80,0x20,0x28,0x40,
+    0x28,0x84,0x20,0x2c,0x23,0x25,0x25,0x26,0x85,0x20,0x2e,0x40,0x28,0x28,0x2f,0x2e,
+    0x84,0x20,0x28,0x40,0x80,0x20,0x26,0x82,0x20,0x2e,0x26,0x20,0x20,0x2e,0x40,0x2f,
+    0x82,0x20,0x2e,0x89,0x40,0x0d,0x0a,0x83,0x40,0x2e,0x80,0x20,0x25,0x84,0x40,0x28,
+    0x85,0x20,0x2a,0x80,0x40,0x26,0x80,0x20,0x2f,0x26,0x83,0x25,0x26,0x2a,0x84,0x2c,
+    0x25,0x23,0x83,0x28,0x25,0x28,0x80,0x20,0x26,0x40,0x83,0x20,0x26,0x25,0x82,0x20,
+    0x2e,0x82,0x40,0x25,0x80,0x20,0x2a,0x85,0x40,0x0d,0x0a,0x82,0x40,0x28,0x20,0x20,
+    0x2a,0x93,0x40,0x2e,0x20,0x20,0x80,0x40,0x26,0x83,0x25,0x26,0x83,0x2c,0x2a,0x25,
+    0x83,0x28,0x81,0x40,0x20,0x20,0x2e,0x83,0x40,0x80,0x26,0x8a,0x40,0x2a,0x20,0x20,
+    0x26,0x84,0x40,0x0d,0x0a,0x82,0x40,0x2f,0x20,0x20,0x2f,0x93,0x40,0x2e,0x20,0x2e,
+    0x82,0x40,0x26,0x81,0x25,0x26,0x2a,0x82,0x2c,0x83,0x28,0x23,0x82,0x40,0x2e,0x20,
+    0x2e,0x83,0x40,0x23,0x20,0x20,0x25,0x89,0x40,0x2f,0x20,0x20,0x26,0x84,0x40,0x0d,
+    0x0a,0x82,0x40,0x2f,0x20,0x20,0x2f,0x84,0x40,0x83,0x26,0x86,0x40,0x2e,0x20,0x2e,
+    0x83,0x40,0x26,0x82,0x25,0x82,0x2c,0x23,0x81,0x28,0x26,0x83,0x40,0x2e,0x20,0x2e,
+    0x83,0x40,0x23,0x20,0x20,0x25,0x89,0x40,0x2f,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,
+    0x82,0x40,0x2f,0x20,0x20,0x2f,0x84,0x40,0x2e,0x81,0x20,0x2a,0x86,0x40,0x2e,0x20,
+    0x2e,0x85,0x40,0x80,0x25,0x26,0x2f,0x80,0x2c,0x2f,0x81,0x28,0x85,0x40,0x2e,0x20,
+    0x2e,0x83,0x40,0x23,0x20,0x20,0x25,0x89,0x40,0x2f,0x20,0x20,0x26,0x84,0x40,0x0d,
+    0x0a,0x82,0x40,0x2f,0x20,0x20,0x2f,0x40,0x40,0x80,0x25,0x8e,0x40,0x2e,0x20,0x2e,
+    0x40,0x40,0x80,0x25,0x26,0x80,0x40,0x26,0x80,0x25,0x80,0x2c,0x23,0x28,0x28,0x25,
+    0x80,0x40,0x26,0x25,0x25,0x26,0x40,0x40,0x2e,0x20,0x2e,0x83,0x40,0x23,0x20,0x20,
+    0x25,0x84,0x40,0x80,0x25,0x40,0x40,0x2f,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x82,
+    0x40,0x2f,0x20,0x20,0x2f,0x40,0x40,0x20,0x20,0x2a,0x8e,0x40,0x2e,0x20,0x2e,0x40,
+    0x40,0x2c,0x20,0x20,0x25,0x81,0x40,0x26,0x25,0x25,0x2f,0x2c,0x2a,0x28,0x28,0x82,
+    0x40,0x26,0x20,0x20,0x2f,0x40,0x40,0x2e,0x20,0x2e,0x83,0x40,0x23,0x20,0x20,0x25,
+    0x84,0x40,0x80,0x20,0x40,0x40,0x2f,0x20,0x20,0x26,0x84,0x40,0x0d,0x0a,0x00
+};
+
+#endif
@@ -56,6 +56,12 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * be initialized using the 'R' command, which does not appear in the online help. The 'R' command
  * also requires a security code so that participants playing around can't easily reconfigure their boards.
  * 
+ * The configuration is backed by a journal in the 4 flash sectors (16 KB) just below the EEPROM
+ * sector, which is where the core puts the end of the file system. Build with a flash layout that
+ * has no file system - on a 4 MB NodeMCU, Tools > Flash Size > "4MB (FS:none OTA:~1019KB)". With a
+ * file system there the board says so at boot and writes the whole EEPROM sector for every change
+ * instead, which wears the flash and stalls loop() for each write.
+ * 
  * There is also a 'W' command which is intented for production/test use and is similarly
  * undocumented. The 'W' command sends a test message to ifttt.com, validating both the
  * ifttt credentials and wifi connectivity.
@@ -72,32 +78,61 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Send a message to ifttt.com, to send an email when this board's scavenger hunt is complete
 #include "IFTTTMessage.h"
+#include "CRSCDatagram.h"
 
 // Other functionality specific to the CRSC scavenger hunt
 #include "CRSCConfig.h"
 #include "CRSCSerialInterface.h"
 #include "CRSCLED.h"
+#include "CRSCScheduler.h"
+#include "CRSCWifiConnector.h"
+#include "CRSCMetrics.h"
+#include "CRSCTrace.h"
+#include "CRSCBanner.h"
+#include "CRSCConsole.h"
+
+#include "CRSCLogo.h"
 
 // -------------------------------------------------------
 
 // Remember to update this just before the commit
 #define FIRMWARE_VERSION "1.2"
 
-// How often to run out main loop (milliseconds)
+// How often to move the Wifi connection and ifttt.com send along while they're in
+// progress (milliseconds)
 #define UPDATE_INTERVAL    50
 
-IFTTTMessageClass IFTTTSender (UPDATE_INTERVAL);   // Object to communicate with ifttt.com
+// How often to top up the console while the logo is going out (milliseconds). Its
+// buffer holds 2 KB, about 180 ms worth at 115200 baud.
+#define BANNER_POLL_INTERVAL 20
+
+// How long to hold configuration changes before writing them to flash (milliseconds).
+// A burst of 'A' commands typed or pasted in this window costs a single write.
+#define CONFIG_WRITE_BACK_WINDOW 2000
+
+// Size of the serial receive buffer (bytes). When nothing has happened for a while the
+// scheduler only looks for input every 50 ms; 2 KB takes 180 ms to arrive at 115200
+// baud, so a pasted batch of 'A' commands isn't cut short. The core's default is 256.
+#define SERIAL_RX_BUFFER_SIZE 2048
+
+IFTTTMessageClass IFTTTSender;   // Object to communicate with ifttt.com
+CRSCDatagramTransport DatagramTransport;   // Used instead of HTTP for a udp:// collector
 
 // Messages to send to ifttt when scavenger hunt has been completed or if we are in test mode
 const char* DoneMsg = "Scavenger hunt is complete!";
 const char* TestMsg = "Connectivity test";
-char* CurrMsg;
+
+// The notification being sent, with its sequence number so a repeat after a power cut can
+// be spotted. CurrSequence is 0 when we aren't working on one.
+char CurrMsg[48];
+outbox_message_t CurrEvent;
+uint32_t CurrSequence = 0;
 
 // LED stuff - use built-in LED connected to D2
 const int TheLEDPin = LED_BUILTIN;
 
 // Define the object that controls the LED
-CRSCLED TheLED (TheLEDPin, (float)UPDATE_INTERVAL);
+CRSCLED TheLED (TheLEDPin);
 
 // Configuration object to load/store information in EEPROM, including our own Board ID and the other Board IDs we
 // have collected.
@@ -106,45 +141,91 @@ CRSCConfigClass TheConfiguration;
 // Make a serial interface so user can communicate with us from a computer
 CRSCSerialInterface TheSerialInterface (&TheConfiguration);
 
+// Connects to the access point a little at a time, so the serial interface and LED keep
+// working while we wait
+CRSCWifiConnector TheWifiConnector;
+
+// Runs the tasks below only when they have something to do
+CRSCScheduler TheScheduler;
+int ConsoleTaskID;
+int BannerTaskID;
+int SerialTaskID;
+int ConfigTaskID;
+int ReportTaskID;
+
+// Prints the logo from loop() a little at a time, so setup() doesn't wait for it
+CRSCBanner TheBanner;
+
+// A flag which, when set, indicates that the configuration loaded
+bool ConfigOkay = false;
+
+// A flag which, when set, indicates that the logo and welcome have been printed
+bool Welcomed = false;
+
+// Timings and failure counts from the libraries, printed by the M command
+CRSCMetrics TheMetrics;
+
 // -------------------------------------------------------
 void setup() 
 {
+  // Pick up the trace from before the reset, and note why we reset. Done first so a
+  // board that hangs in setup() still leaves something behind.
+  TheTrace.Begin();
 
-  // Start serial communication for terminal interface
+  // Power the radio down straight away - it's not needed until there's something to send
+  TheWifiConnector.Begin();
+
+  // Start serial communication for terminal interface. Everything printed from here on
+  // is queued and sent by ConsoleTask as the UART makes room.
+  Serial.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
   Serial.begin(115200); 
+  TheConsole.Begin();
 
   // Seems to reduce (but not eliminate) garbage characters on reset
   while (! Serial );
 
-  // Compromise with Marketing department :)
-  PrintLogo();
+  // Compromise with Marketing department :) The logo goes out from loop(), and the
+  // welcome after it, so nothing here waits for the serial port.
+  TheBanner.Begin (CRSCLogo);
 
   // Load our configuration here. If anything goes wrong, turn the
   // LED off and give up.
   bool okay = TheConfiguration.Load();
+  TheConfiguration.SetWriteBackWindow (CONFIG_WRITE_BACK_WINDOW);
+  ConfigOkay = okay;
 
   // If the configuration checksum test passed and all stored board IDs are valid ...
   if (okay == true)
   {
-    Serial.print (F("\nWelcome to CANARIE's CRSC Scavenger Hunt (Firmware Version "));Serial.print (FIRMWARE_VERSION); Serial.println(")\n\n");
-
     // We can now initialize fields to be sent to IFTTT that were in the personality
-    IFTTTSender.Initialize (TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID(), "CRSCGadget"); 
+    // Messages go to ifttt.com unless a collector has been set with the C command
+    if (TheConfiguration.GetCollectorTransport() == COLLECTOR_UDP)
+        IFTTTSender.SetTransport (&DatagramTransport);
+    IFTTTSender.Initialize (TheConfiguration.GetIFTTTKey(), TheConfiguration.GetBoardID(), "CRSCGadget",
+                            TheConfiguration.GetCollectorHost(), TheConfiguration.GetCollectorPort());
+
+    // Boards that finish together shouldn't all retry together
+    TheWifiConnector.SetRetrySeed (TheConfiguration.GetBoardID());
+
+    // Everything that takes time or can fail reports to the same place
+    TheScheduler.SetMetrics (&TheMetrics);
+    TheConfiguration.SetMetrics (&TheMetrics);
+    TheSerialInterface.SetMetrics (&TheMetrics);
+    TheWifiConnector.SetMetrics (&TheMetrics);
+    IFTTTSender.SetMetrics (&TheMetrics);
 
     // If our board ID has not yet been set ...
     if (memcmp (TheConfiguration.GetBoardID(), UninitializedID, BOARD_ID_LEN) == 0) 
     {
-        Serial.print(F("*** I'm so sorry. It seems that your board ID is missing. Please get help from CANARIE staff - but only the techies\n\n"));
         TheLED.SetOff();
     }
     else
     {
-           // If we get this far, then the configuration is valid. Check to see if the scavenger hunt has been completed. If it has been, just
-           // print a friendly message. To avoid spamming ifttt.com on every power up, we will also disable the ability to send to ifttt in loop() 
-           // under this condition.
+           // If we get this far, then the configuration is valid. Check to see if the scavenger hunt has been completed. If it has been,
+           // PrintWelcome() just prints a friendly message. To avoid spamming ifttt.com on every power up, we will also disable the ability
+           // to send to ifttt in loop() under this condition.
            if (TheConfiguration.GetHuntComplete() == true)
            {
-              PrintClosingMessage();
               TheLED.SetOn();   
            }
            else
@@ -152,97 +233,203 @@ void setup()
               // The game is still afoot
               // Tell the LED object about our fingerprint so it can flash accordingly
               TheLED.SetFingerprint (TheConfiguration.GetFingerprint());
-
-              // As a courtesy, display board ID on startup
-              Serial.print(F("Your board ID is ")); Serial.print(TheConfiguration.GetBoardID());Serial.println(F("\n\n"));
-        
-              // Tell the user what they can do
-              TheSerialInterface.DisplayHelp();
            }
      }
  
   }
   else
   {
-      Serial.print (F("\nWell, this is embarassing! Your board seems to be corrupted. Please contact CANARIE staff - but only the techies\n\n"));
       TheLED.SetOff();
   }
 
 
-  Serial.flush();
+  // Each task runs once straight away, then when it next has something to do
+  ConsoleTaskID = TheScheduler.AddTask (ConsoleTask, NULL, ConsoleCanSend);
+  BannerTaskID = TheScheduler.AddTask (BannerTask);
+  SerialTaskID = TheScheduler.AddTask (SerialTask, NULL, SerialInputWaiting);
+  ConfigTaskID = TheScheduler.AddTask (ConfigTask);
+  ReportTaskID = TheScheduler.AddTask (ReportTask);
+
+  TheTrace.Record (CRSCTrace::TRACE_SETUP_DONE, okay ? 1 : 0);
 }
 
 // -------------------------------------------------------
 void loop() 
 {
-    // Flag which, when set, indicates that we have sent a message to ifttt.com and
-    // don't need to do it again
-    static bool done = false;
+    // Run whatever is due, then sleep until something else is
+    TheScheduler.RunOnce();
+}
+
+// -------------------------------------------------------
+// Returns true when there's output queued and the UART has room for some of it
+bool ConsoleCanSend (void* arg)
+{
+    (void)arg;
+    return (TheConsole.CanSend());
+}
+
+// -------------------------------------------------------
+// Move queued output on to the UART, as much as it can take without waiting
+void ConsoleTask (void* arg)
+{
+    (void)arg;
+    TheConsole.Update();
+}
+
+// -------------------------------------------------------
+// Queue the logo as the console makes room for it, then the welcome once there's room
+// for that too. Commands and reports wait until it's done, so their output doesn't land
+// in the middle of it.
+void BannerTask (void* arg)
+{
+    (void)arg;
+    if ((TheBanner.Update (&TheConsole) == false) || (TheConsole.GetPending() > CRSCConsole::BufferLen / 2))
+    {
+        TheScheduler.RunIn (BannerTaskID, BANNER_POLL_INTERVAL);
+    }
+    else
+    {
+        PrintWelcome();
+        Welcomed = true;
+        TheScheduler.Wake (SerialTaskID);
+        TheScheduler.Wake (ReportTaskID);
+    }
+}
 
-    // Check the serial interface for a complete command and, if there is one, execute it
+// -------------------------------------------------------
+// Returns true when characters are waiting on the serial port, once the welcome is out
+bool SerialInputWaiting (void* arg)
+{
+    (void)arg;
+    return (Welcomed && (Serial.available() > 0));
+}
+
+// -------------------------------------------------------
+// Read what has arrived on the serial port and act on any complete commands
+void SerialTask (void* arg)
+{
+    (void)arg;
+    if (Welcomed == false)
+        return;
+
+    serialEvent();
     TheSerialInterface.Update();
 
-    // If we now have all the scavenged board ID's we need, or if we're in production and a Wifi test
-    // has been requested ...
-    done |= TheConfiguration.GetHuntComplete();
-    if (((TheConfiguration.GetNumScavengedBoardIDs() == SCAVENGED_BOARD_LIST_LEN) && (done == false)) || TheConfiguration.WifiTestRequested())
+    // A command may have changed the configuration, finished the hunt or asked
+    // for a Wifi test
+    TheScheduler.Wake (ConfigTaskID);
+    TheScheduler.Wake (ReportTaskID);
+}
+
+// -------------------------------------------------------
+// Write configuration changes back to flash once they've had a chance to pile up
+void ConfigTask (void* arg)
+{
+    (void)arg;
+    TheConfiguration.Update();
+
+    if (TheConfiguration.IsDirty())
+        TheScheduler.RunIn (ConfigTaskID, TheConfiguration.GetWriteBackDelay());
+}
+
+// -------------------------------------------------------
+// Put anything new in the outbox - the hunt being finished, or a Wifi test asked for
+// over serial. The outbox is in flash, so what's queued is sent even if the board is
+// unplugged before the network can be reached.
+void QueueMessages (void)
+{
+    if ((TheConfiguration.GetNumScavengedBoardIDs() >= SCAVENGED_BOARD_LIST_LEN) &&
+        (TheConfiguration.GetHuntComplete() == false))
+    {
+        // Both changes go to flash in the same write, so after a power cut the hunt is
+        // either complete with the message waiting, or not complete at all
+        TheConfiguration.SetHuntComplete();
+        TheConfiguration.QueueMessage (OUTBOX_HUNT_COMPLETE);
+
+        // Set LED on as an indication to the user
+        TheLED.SetOn();
+        PrintClosingMessage();
+    }
+
+    if (TheConfiguration.WifiTestRequested() == true)
     {
-        // If we are just testing the wifi
-        if (TheConfiguration.WifiTestRequested() == true)
-        {
-          CurrMsg = (char*)TestMsg;
-        }
-        else
-        {
-           // This is real. Scavenger hunt has been completed
-           CurrMsg = (char*)DoneMsg;
-           
-           // Set LED on as an indication to the user
-           TheLED.SetOn();   
-        }
-
-       // Connect to Wifi
-       ConnectWifi(TheConfiguration.GetWifiSSID(), TheConfiguration.GetWifiPassword()); 
+        TheConfiguration.QueueMessage (OUTBOX_WIFI_TEST);
+        TheConfiguration.ClearWifiTestMode();
+    }
+}
+
+// -------------------------------------------------------
+// Send whatever is in the outbox to ifttt.com, oldest first. Runs every UPDATE_INTERVAL
+// while there is something to send, otherwise waits for the serial task to wake it.
+void ReportTask (void* arg)
+{
+    (void)arg;
+    // BannerTask wakes us once the logo is out
+    if (Welcomed == false)
+        return;
+
+    QueueMessages();
+
+    if (TheConfiguration.GetQueuedMessages() > 0)
+    {
+       // Connect to Wifi. This doesn't wait - the connection is made over several
+       // runs of this task. If we've joined before, try the fast way first.
+       wifi_cache_t cache;
+       bool haveCache = TheConfiguration.GetWifiCache(&cache);
+       TheWifiConnector.Connect(TheConfiguration.GetWifiSSID(), TheConfiguration.GetWifiPassword(),
+                                haveCache ? &cache : NULL); 
+
+       CRSCWifiConnector::WifiState_t wifiState = TheWifiConnector.Update();
+
+       // The access point has moved or our address has gone - don't bother trying
+       // the fast way again
+       if (TheWifiConnector.CacheFailed())
+          TheConfiguration.ClearWifiCache();
 
        // If wifi connected,
-       if (WiFi.status() == WL_CONNECTED)
+       if (wifiState == CRSCWifiConnector::WIFI_STATE_CONNECTED)
        {
-          // Send an appropriate message to ifttt.com
-          done = IFTTTSender.SendMessage(CurrMsg);
-
-          // If send to ifttt failed ...
-          if (done == false)
+          // Pick up the oldest notification if we aren't already working on one
+          if (CurrSequence == 0)
           {
-              Serial.println(F("Unable to send to ifttt - will keep trying"));
+              TheConfiguration.GetQueuedMessage (&CurrEvent, &CurrSequence);
+              snprintf (CurrMsg, sizeof (CurrMsg), "%s (#%lu)",
+                        (CurrEvent == OUTBOX_HUNT_COMPLETE) ? DoneMsg : TestMsg, (unsigned long)CurrSequence);
           }
-          else    // send was successful
+
+          // Send it to ifttt.com. This also moves the send along a step at a time, so it
+          // returns false until ifttt.com has accepted the message. Failures are reported,
+          // and retried, by the sender.
+          if (IFTTTSender.SendMessage(CurrMsg, CurrEvent, CurrSequence) == true)
           {
-              // If this was just a Wifi test, set done back to false so the hunt can
-              // continue if someone forgets to reboot the board.
-              if (TheConfiguration.WifiTestRequested())
-              {
-                 TheConfiguration.ClearWifiTestMode();
-                 done = false;
-              }
-              else
+              // Delivered. The write-back window collects the rest of the batch, so
+              // emptying the outbox costs a single write to flash.
+              TheConfiguration.SetMessageSent (CurrSequence);
+              CurrSequence = 0;
+
+              if (TheConfiguration.GetQueuedMessages() == 0)
               {
-                // It't the real thing. Flag that we have sent a message to ifttt.com so it
-                // doesn't happen again when the board is power-cycled
-                TheConfiguration.SetHuntComplete();
-                PrintClosingMessage();
+                  // Remember where we joined, so next time can skip the scan - and DHCP,
+                  // while the lease is fresh. A rejoin with the cached address leaves
+                  // the cache as it is, as the lease is timed from when DHCP gave it.
+                  if (TheWifiConnector.GetWifiCache(&cache))
+                     TheConfiguration.SetWifiCache(&cache);
+
+                  // That's all we need the network for - power the radio back down
+                  TheWifiConnector.Disconnect();
               }
+              TheScheduler.Wake (ConfigTaskID);
           }
        }        
     }
 
-
-    // serialEvent isn't auto-called on 8266 for some reason, so do it ourselves
-    serialEvent();
-    delay (UPDATE_INTERVAL);
+    // Keep the connection and sends moving until the outbox is empty
+    if (TheConfiguration.GetQueuedMessages() > 0)
+        TheScheduler.RunIn (ReportTaskID, UPDATE_INTERVAL);
 }
 
 // -------------------------------------------------------
-// This function is called during each repetition of loop()
+// Called by the serial task - serialEvent isn't auto-called on 8266 for some reason
 void serialEvent() 
 {
   while (Serial.available()) 
@@ -255,116 +442,48 @@ void serialEvent()
   }
 }
 
-// --------------------------------------------------------------------------------------------------
-// Tries to connect to the wireless access point with the credentials provided.  The idea is to call
-// this multiple times, until connection is established, so that the board can continue to do other
-// things. Also, because some of the features of the Wifi class seem to require background processing.
-void ConnectWifi(char* ssid, char* password)  
-{  
-    // After a timeout, number of millisecons to wait until trying again
-    static int millisecondsToRetry = UPDATE_INTERVAL;
-    
-    byte attempts = 0;   // Counter for the number of attempts to connect to wireless AP before giving up 
-                         // temporarily
-
-    millisecondsToRetry -= UPDATE_INTERVAL;
-
-    if (millisecondsToRetry <= 0)
-    {
-      Serial.print(F("Connecting to ")); Serial.println(ssid);
-  
-      WiFi.begin(ssid, password); // Connect to WiFi network
-
-      while (WiFi.status() != WL_CONNECTED) // Test to see if we're connected
-      {
-          Serial.print('.');
-          attempts++;
-    
-          if(attempts > 20) // Give up after 20 tries 
-          {
-            Serial.println (F("\nWifi connection failed. Will try again in 10 seconds."));
-            Serial.println (F("In the mean time, please notify one of the CANARIE staff that you have completed the scavenger hunt\n\n"));
-            millisecondsToRetry = 10000;
-            break; 
-          }
-          else 
-          {
-            delay(500);      // Check again after 500ms
-          }
-      }
-  
-      if (WiFi.status() == WL_CONNECTED)  // We're connected
-      {
-         Serial.println(F("\nWiFi connected ...\n"));
-      }
-      else  // Unable to connect. Leave ourselves in a good state.
-      {
-         WiFi.disconnect();
-      }
-   }
-}
-
-
 // --------------------------------------------------------------------------------------------------------
-void PrintLogo(void)
+// What the user sees once the logo is out, depending on how setup() found the board
+void PrintWelcome(void)
 {
-  Serial.print ("\n\n\n");
-  Serial.println(F("@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@@@&(/#@@@@@@@@@@@@@@@@@@@@@@@@@(/(@@@@@@@@@@@@@@@@@@@@@@@@@@%//%@@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@.       ,@@@@@@@@@@@@@@@@@@@.       *@@@@@@@@@@@@@@@@@@@@#        &@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&.  &%%%(  ,@@@@@@@@@@@@@@@@@.  ,,,,,   @@@@@@@@@@@@@@@@@@%  *((((.  &@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&  .%%%%%. .@@@@@@@@@@@@@@@@@   ,,,,,   @@@@@@@@@@@@@@@@@@/  (((((*  &@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@/           .%%%%%.                      ,,,,,                        (((((*          &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  *(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/       ,,,,,,,,,,,,,,,,,       ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%%%%%%%,  ,,,,,,,,,,,,,,,  .(((((((((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%   ,,,,,,,,,,,,,   ((((((((((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%%%%%%&(  .,,,,,,,,,,,,,.  *(((((((((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/       ,,,,,,,,,,,,,,,,,       ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  (%%%%%%%%%%%%%%%%%%%%%%%/  ,,,,,,,,,,,,,,,,,,,,,,,,,,,  ,(((((((((((((((((((((((*  &@@@@@@@"));
-  Serial.println(F("@@@@@#          ,&%%%(                          .,,,,.                     (((((.          &@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@&%%%(   ,&%(  *%%%%%%%%@@%,,,,,,,,,,  .,,.   .,,,,/@@&((((((((,  (((.   /(((%@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@&%%%%#   /(  *%%%%%%%%&@@*,,,,,,,,,  ..   .,,,,,,&@@(((((((((,  (*   /((((&@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@&%%%%#     *%%%%%%%%%@@#,,,,,,,,,     .,,,,,,,*@@&(((((((((,     /((((%@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&%%%%%#.../%%%%%%%%%&@@*,,,,,,,,   .,,,,,,,,,%@@((((((((((*.../(((((&@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@&%%%%%&&%%%%%%%%%%%@@#,,,,,,,,,,,,,,,,,,,,*@@#((((((((((((((((((#@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@@&%.      .%%%%%%%%&@&*,,,,,         ,,,,,(@&((((((((/       ./%@@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@%   .(##/.   #%%%%%%&@%,,.    .,,,.    .,,@@(((((((,    *//,    %@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@(  ,@&%%%%%%.  ,%%%%%%@@*   .,,,,,,,,,.   (@%((((((.  .(((((,     (@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&  .@@@@%%%%%&   #%%%%%&@,  ,,,,,,,,,,,,,  ,@((((((/           *@. .@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&  .@@@@@&%%%&.  #%%%%%%&   ,,,,,,,,,,,,,   %((((((/      ./&@@@@.  @@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@&  .@@@@@@&%%&.  #%%%%%%%   ,,,,,,,,,,,,,   (((((((/  ,(((&@@@@@@.  @@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@*  (@@@@@@@&(   &%%%%%%%   ,,,,,,,,,,,,,   ((((((((   /#@@@@@@@#  *@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@,   &@@@@&   ,&%%%%%%%%   ,,,,,,,,,,,,,   (((((((((    &@@@@&   ,@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@@(  %@@@@(  (%%%%%%%%%%   ,,,,,,,,,,,,*.  (((((((((#,  (@@@@%  (@@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@@@(  %@@@@(  #@&%%%%%%%%       ,,,,,       ((((((((&@*  (@@@@%  (@@@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@@@@@&,   %@@@@(   ,%@&%%%%%%%%/    ,,,,,    *(((((((((@%.   (@@@@%   ,&@@@@@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@@@@/       &@@@@@@@       *&(.         ,,,         ./(,       &@%  &@&       /@@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@@@.     (@(   /&&&   (@(       ,#%%&        .@((/.       (@   &     .&  .@/     .@@@@@@@@@@@@"));
-  Serial.println(F("@@@@@@.   %@@@@@@@(        *@@@&   /&%%%%%%&*,,,,,,,%#((((((%(   &@      &%     .@@@@@%   *@@@@@@@@"));
-  Serial.println(F("@@@@@(  *@@@@@@@@@@@@@@@@@@@@@@.  @@@&%%%%%%&,,,,,,*%((((((@@@@  .@@@@@@&&&@@@@@@@@@@@@@*  &@@@@@@@"));
-  Serial.println(F("@@@@@/  /@@@@@@@@@@@@@@@@@@@@@@. .@@@@@&%%%%&*,,,,,((((((#@@@@@. .@@@@@@#  %@@@@@@@@@@@@/  &@@@@@@@"));
-  Serial.println(F("@@@@@/  /@@@@@@@&&&&&&@@@@@@@@@. .@@@@@@&%%%%%,,,,,#((((&@@@@@@. .@@@@@@#  %@@@@@@@@@@@@/  &@@@@@@@"));
-  Serial.println(F("@@@@@/  /@@@@@@@.    *@@@@@@@@@. .@@@@@@@@%%%&/,,,/((((@@@@@@@@. .@@@@@@#  %@@@@@@@@@@@@/  &@@@@@@@"));
-  Serial.println(F("@@@@@/  /@@%%%@@@@@@@@@@@@@@@@@. .@@%%%&@@@&%%%,,,#((%@@@&%%&@@. .@@@@@@#  %@@@@@@@%%%@@/  &@@@@@@@"));
-  Serial.println(F("@@@@@/  /@@  *@@@@@@@@@@@@@@@@@. .@@,  %@@@@&%%/,*((@@@@@&  /@@. .@@@@@@#  %@@@@@@@   @@/  &@@@@@@@"));
+  if (ConfigOkay == false)
+  {
+      TheConsole.print (F("\nWell, this is embarassing! Your board seems to be corrupted. Please contact CANARIE staff - but only the techies\n\n"));
+      return;
+  }
+
+  TheConsole.print (F("\nWelcome to CANARIE's CRSC Scavenger Hunt (Firmware Version "));TheConsole.print (FIRMWARE_VERSION); TheConsole.println(F(")\n\n"));
+
+  if (memcmp (TheConfiguration.GetBoardID(), UninitializedID, BOARD_ID_LEN) == 0) 
+  {
+      TheConsole.print(F("*** I'm so sorry. It seems that your board ID is missing. Please get help from CANARIE staff - but only the techies\n\n"));
+  }
+  else if (TheConfiguration.GetHuntComplete() == true)
+  {
+      PrintClosingMessage();
+  }
+  else
+  {
+      // As a courtesy, display board ID on startup
+      TheConsole.print(F("Your board ID is ")); TheConsole.print(TheConfiguration.GetBoardID());TheConsole.println(F("\n\n"));
+
+      // Tell the user what they can do
+      TheSerialInterface.DisplayHelp();
+  }
 }
 
 // --------------------------------------------------------------------------------------------------------
+// Kept in flash with F() - as plain strings the ESP8266 would copy them all to RAM at boot
 void PrintClosingMessage(void)
 {
-  Serial.println ("\n\n");
+  TheConsole.println (F("\n\n"));
 
-  Serial.println ("Congratulations!!! You have completed the CRSC2019 Scavenger Hunt!\n");
-  Serial.println ("This board has now been disabled to prevent spamming the email service on power up\n");
+  TheConsole.println (F("Congratulations!!! You have completed the CRSC2019 Scavenger Hunt!\n"));
+  TheConsole.println (F("This board has now been disabled to prevent spamming the email service on power up\n"));
 
-  Serial.println ("We encourage you to reuse this board for something cool - and let us know about it\n");
-  Serial.println ("There's additional information about programming these devices at http://researchsoftware.ca/NodeMCU\n");
+  TheConsole.println (F("We encourage you to reuse this board for something cool - and let us know about it\n"));
+  TheConsole.println (F("There's additional information about programming these devices at http://researchsoftware.ca/NodeMCU\n"));
 
-  Serial.println ("and the source code used for this event is available at https://github.com/shensicle/CRSC2019\n\n"); 
+  TheConsole.println (F("and the source code used for this event is available at https://github.com/shensicle/CRSC2019\n\n")); 
 
 }
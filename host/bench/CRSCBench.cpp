@@ -0,0 +1,620 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Micro-benchmarks for the hot paths of the CRSC libraries, run against the
+// host shims. Numbers are host nanoseconds per operation - they won't match
+// the board, but a change that makes one of these slower here will almost
+// certainly make it slower on the NodeMCU too.
+//
+// Usage: CRSCBench [name filter]
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include "CRSCCmdParser.h"
+#include "CRSCConfig.h"
+#include "CRSCMetrics.h"
+#include "CRSCSerialInterface.h"
+#include "CRSCTrace.h"
+#include "CRSCWifiConnector.h"
+#include "IFTTTMessage.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// How long to run each benchmark for
+static const double MinimumRunSeconds = 0.25;
+
+// Somewhere to put results so the compiler can't throw the work away
+static volatile unsigned long Sink;
+
+// The characters board IDs are made from
+static const char IDChars[] = BOARD_ID_CHARS;
+
+// ----------------------------------------------------------------------
+// Gives the benchmark access to the protected parts of the configuration
+class BenchConfigClass : public CRSCConfigClass
+{
+public:
+    using CRSCConfigClass::IsValidBoardID;
+};
+
+// ----------------------------------------------------------------------
+// Lets a benchmark time only part of what it does, so it can do untimed
+// setup between operations. Flash erases and writes are counted over the same region.
+class BenchTimer
+{
+public:
+    BenchTimer (void) : Seconds (0.0), Erases (0), Writes (0), Used (false) {}
+
+    void Start (void)
+    {
+        HostFlashStats_t stats;
+        HostFlashGetStats (&stats);
+        StartErases = stats.SectorErases;
+        StartWrites = stats.Writes;
+        StartTime = std::chrono::steady_clock::now ();
+    }
+
+    void Stop (void)
+    {
+        HostFlashStats_t stats;
+        Seconds += std::chrono::duration<double> (std::chrono::steady_clock::now () - StartTime).count ();
+        HostFlashGetStats (&stats);
+        Erases += stats.SectorErases - StartErases;
+        Writes += stats.Writes - StartWrites;
+        Used = true;
+    }
+
+    double Seconds;
+    unsigned long Erases;
+    unsigned long Writes;
+    bool Used;
+
+private:
+    std::chrono::steady_clock::time_point StartTime;
+    unsigned long StartErases;
+    unsigned long StartWrites;
+};
+
+// Everything a benchmark reports
+typedef struct
+{
+    unsigned long long Operations;
+    double Seconds;
+    unsigned long FlashErases;
+    unsigned long FlashWrites;
+} BenchResult_t;
+
+// Run body() - which performs opsPerCall operations each time - until
+// MinimumRunSeconds have passed. If body() uses the timer it is passed, only
+// the time between its Start() and Stop() calls is counted.
+static BenchResult_t RunBenchmark (unsigned opsPerCall, std::function<void (BenchTimer* timer)> body)
+{
+    typedef std::chrono::steady_clock clock;
+
+    BenchResult_t result;
+    BenchTimer timer;
+    HostFlashStats_t before, after;
+
+    HostFlashGetStats (&before);
+
+    result.Operations = 0;
+    result.Seconds = 0.0;
+
+    clock::time_point start = clock::now ();
+    double elapsed = 0.0;
+    unsigned batch = 1;
+
+    while (elapsed < MinimumRunSeconds)
+    {
+        clock::time_point batchStart = clock::now ();
+        for (unsigned i = 0; i < batch; i++)
+            body (&timer);
+        clock::time_point batchEnd = clock::now ();
+
+        result.Operations += (unsigned long long)batch * opsPerCall;
+        result.Seconds += std::chrono::duration<double> (batchEnd - batchStart).count ();
+        elapsed = std::chrono::duration<double> (batchEnd - start).count ();
+
+        if (batch < (1u << 20))
+            batch *= 2;
+    }
+
+    HostFlashGetStats (&after);
+    result.FlashErases = after.SectorErases - before.SectorErases;
+    result.FlashWrites = after.Writes - before.Writes;
+
+    if (timer.Used)
+    {
+        result.Seconds = timer.Seconds;
+        result.FlashErases = timer.Erases;
+        result.FlashWrites = timer.Writes;
+    }
+    return (result);
+}
+
+static void Report (const char* filter, const char* name, unsigned opsPerCall,
+                    std::function<void (BenchTimer* timer)> body)
+{
+    if ((filter != NULL) && (strstr (name, filter) == NULL))
+        return;
+
+    BenchResult_t result = RunBenchmark (opsPerCall, body);
+
+    printf ("%-52s %12llu %10.1f ns/op %8.2f erases/op %8.2f writes/op\n", name, result.Operations,
+            result.Seconds * 1e9 / result.Operations,
+            (double)result.FlashErases / result.Operations,
+            (double)result.FlashWrites / result.Operations);
+}
+
+// ----------------------------------------------------------------------
+// Make a valid board ID (with check bytes) whose fingerprint is thePrint.
+// Different serial numbers give different IDs.
+static void MakeBoardID (CRSCConfigClass* config, unsigned long thePrint, unsigned serial, char* theID)
+{
+    for (int i = 0; i < BOARD_ID_BYTES; i++)
+    {
+        // Pick from only the characters whose low bit matches the fingerprint bit
+        unsigned wantedBit = (thePrint >> (BOARD_ID_BYTES - 1 - i)) & 0x01;
+        char candidates[sizeof (IDChars)];
+        unsigned numCandidates = 0;
+
+        for (const char* c = IDChars; *c != 0x00; c++)
+        {
+            if ((*c & 0x01) == wantedBit)
+                candidates[numCandidates++] = *c;
+        }
+
+        theID[i] = candidates[serial % numCandidates];
+        serial /= numCandidates;
+    }
+    config->CalculateCheckBytes (theID, theID + BOARD_ID_BYTES);
+    theID[BOARD_ID_LEN] = 0x00;
+}
+
+// ----------------------------------------------------------------------
+// Feed a command line to the serial interface and run it
+static void RunCommand (CRSCSerialInterface* theInterface, const char* line)
+{
+    while (*line != 0x00)
+        theInterface->Add (*line++);
+    theInterface->Update ();
+}
+
+// ----------------------------------------------------------------------
+// A stand-in for maker.ifttt.com on the loopback interface. It reads each
+// request through to the end of its body and answers 200 OK.
+static void ServeHTTPStandIn (int listener)
+{
+    for (;;)
+    {
+        int connection = accept (listener, NULL, NULL);
+        if (connection < 0)
+            continue;
+
+        char request[1024];
+        size_t received = 0;
+        const char* body = NULL;
+        long contentLength = 0;
+
+        // Headers first - older firmware used bare line feeds, so accept either ending
+        while ((body == NULL) && (received < sizeof (request) - 1))
+        {
+            ssize_t n = recv (connection, request + received, sizeof (request) - 1 - received, 0);
+            if (n <= 0)
+                break;
+            received += n;
+            request[received] = 0x00;
+
+            const char* end = strstr (request, "\n\n");
+            const char* crlfEnd = strstr (request, "\r\n\r\n");
+            if ((crlfEnd != NULL) && ((end == NULL) || (crlfEnd < end)))
+                body = crlfEnd + 4;
+            else if (end != NULL)
+                body = end + 2;
+        }
+
+        const char* length = strcasestr (request, "Content-Length:");
+        if (length != NULL)
+            contentLength = atol (length + 15);
+
+        // Then the rest of the body
+        while ((body != NULL) && ((long)(request + received - body) < contentLength) &&
+               (received < sizeof (request) - 1))
+        {
+            ssize_t n = recv (connection, request + received, sizeof (request) - 1 - received, 0);
+            if (n <= 0)
+                break;
+            received += n;
+        }
+
+        const char response[] = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 0\r\n"
+                                "Connection: close\r\n\r\n";
+        send (connection, response, sizeof (response) - 1, MSG_NOSIGNAL);
+        close (connection);
+    }
+}
+
+// Start the stand-in on a free loopback port and return the port
+static uint16_t StartHTTPStandIn (void)
+{
+    int listener = socket (AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof (address);
+
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+    bind (listener, (struct sockaddr*)&address, sizeof (address));
+    listen (listener, 64);
+    getsockname (listener, (struct sockaddr*)&address, &addressLength);
+
+    std::thread (ServeHTTPStandIn, listener).detach ();
+    return (ntohs (address.sin_port));
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    const char* filter = (argc > 1) ? argv[1] : NULL;
+
+    // Command output would swamp the results
+    HostSerialSetOutputEnabled (false);
+
+    BenchConfigClass config;
+    const unsigned long myPrint = 0x05;
+    char myID[BOARD_ID_BUF_LEN];
+
+    HostFlashEraseAll ();
+    config.Initialize ("BenchSSID", "BenchPassword", "BenchKey");
+    MakeBoardID (&config, myPrint, 0, myID);
+    config.SetBoardID (myID);
+    config.Load ();
+
+    // A pool of other boards' IDs, all valid, half of them with our fingerprint
+    const unsigned poolSize = 2 * SCAVENGED_BOARD_STORE_LEN;
+    static char idPool[poolSize][BOARD_ID_BUF_LEN];
+    for (unsigned i = 0; i < poolSize; i++)
+        MakeBoardID (&config, (i & 1) ? myPrint : (myPrint ^ 0x03), i + 1, idPool[i]);
+
+    printf ("%-52s %12s %16s\n", "benchmark", "operations", "time");
+
+    // --- Board ID validation -----------------------------------------
+    unsigned next = 0;
+    Report (filter, "CRSCConfigClass::CalculateCheckBytes", 1, [&] (BenchTimer*)
+    {
+        char checkBytes[BOARD_ID_CHECK_BYTES];
+        config.CalculateCheckBytes (idPool[next++ % poolSize], checkBytes);
+        Sink += checkBytes[0];
+    });
+
+    Report (filter, "CRSCConfigClass::IsValidBoardID", 1, [&] (BenchTimer*)
+    {
+        Sink += config.IsValidBoardID (idPool[next++ % poolSize]);
+    });
+
+    Report (filter, "CRSCConfigClass::HasSameFingerprint", 1, [&] (BenchTimer*)
+    {
+        Sink += config.HasSameFingerprint (idPool[next++ % poolSize]);
+    });
+
+    // --- Adding scavenged IDs ------------------------------------------
+    // Fill the list, then clear it again outside the timed region
+    Report (filter, "CRSCConfigClass::AddNewScavengedID", SCAVENGED_BOARD_LIST_LEN, [&] (BenchTimer* timer)
+    {
+        timer->Start ();
+        for (int i = 0; i < SCAVENGED_BOARD_LIST_LEN; i++)
+        {
+            next += 2;
+            Sink += config.AddNewScavengedID (idPool[(next | 1) % poolSize]);
+        }
+        timer->Stop ();
+
+        config.SetBoardID (myID);
+    });
+
+    // The same, with the changes held and written back together
+    config.SetWriteBackWindow (60000);
+    Report (filter, "CRSCConfigClass::AddNewScavengedID (write-back)", SCAVENGED_BOARD_LIST_LEN, [&] (BenchTimer* timer)
+    {
+        timer->Start ();
+        for (int i = 0; i < SCAVENGED_BOARD_LIST_LEN; i++)
+        {
+            next += 2;
+            Sink += config.AddNewScavengedID (idPool[(next | 1) % poolSize]);
+        }
+        config.Flush ();
+        timer->Stop ();
+
+        config.SetBoardID (myID);
+        config.Flush ();
+    });
+    config.SetWriteBackWindow (0);
+
+    Report (filter, "CRSCConfigClass::AddNewScavengedID (rejected)", 1, [&] (BenchTimer*)
+    {
+        Sink += config.AddNewScavengedID (myID);
+    });
+
+    // A duplicate check against a store with one space left, so the search is what's timed
+    for (unsigned i = 1; i < poolSize - 2; i += 2)
+        config.AddNewScavengedID (idPool[i]);
+
+    Report (filter, "CRSCConfigClass::AddNewScavengedID (dup of 499)", 1, [&] (BenchTimer*)
+    {
+        next += 2;
+        Sink += config.AddNewScavengedID (idPool[(next | 1) % (poolSize - 2)]);
+    });
+
+    Report (filter, "CRSCConfigClass::IsScavengedID (499 stored)", 1, [&] (BenchTimer*)
+    {
+        Sink += config.IsScavengedID (idPool[next++ % poolSize]);
+    });
+
+    config.SetBoardID (myID);
+
+    // Loading has to play back the journal of IDs added since the last full write
+    for (int i = 0; i < SCAVENGED_BOARD_LIST_LEN; i++)
+        config.AddNewScavengedID (idPool[(2 * i + 1) % poolSize]);
+
+    Report (filter, "CRSCConfigClass::Load (full list in journal)", 1, [&] (BenchTimer*)
+    {
+        Sink += config.Load ();
+    });
+
+    config.SetBoardID (myID);
+
+    // Two notifications through the outbox - each is written as it's queued, and
+    // the acknowledgements for the batch are written back together
+    config.SetWriteBackWindow (60000);
+    Report (filter, "CRSCConfigClass outbox queue+drain (2 messages)", 1, [&] (BenchTimer*)
+    {
+        outbox_message_t theMessage;
+        uint32_t theSequence;
+
+        config.QueueMessage (OUTBOX_HUNT_COMPLETE);
+        config.QueueMessage (OUTBOX_WIFI_TEST);
+        while (config.GetQueuedMessage (&theMessage, &theSequence))
+            config.SetMessageSent (theSequence);
+        config.Flush ();
+        Sink += theSequence;
+    });
+    config.SetWriteBackWindow (0);
+
+    config.SetBoardID (myID);
+
+    // --- Parser entry points ---------------------------------------------
+    const char addLine[] = "a 12ab34\n";
+    CRSCCmdParser addParser;
+    addParser.SetLine (addLine, sizeof (addLine) - 1);
+    Report (filter, "CRSCCmdParser::GetChar+GetStringToWhitespace", 1, [&] (BenchTimer*)
+    {
+        char buf[BOARD_ID_BUF_LEN];
+        addParser.Reset ();
+        Sink += addParser.GetChar ();
+        addParser.GetStringToWhitespace (buf, BOARD_ID_BUF_LEN);
+        Sink += buf[0] + addParser.IsMoreCommandLine ();
+    });
+
+    const char rLine[] = "R XNY556 12AB34\n";
+    CRSCCmdParser rParser;
+    rParser.SetLine (rLine, sizeof (rLine) - 1);
+    Report (filter, "CRSCCmdParser::GetChar+GetString", 1, [&] (BenchTimer*)
+    {
+        char buf[BOARD_ID_BUF_LEN];
+        char id[BOARD_ID_BUF_LEN];
+        rParser.Reset ();
+        Sink += rParser.GetChar ();
+        rParser.GetStringToWhitespace (buf, BOARD_ID_BUF_LEN);
+        rParser.GetString (id, BOARD_ID_BUF_LEN);
+        Sink += id[0];
+    });
+
+    const char numberLine[] = "   123456789 \n";
+    CRSCCmdParser numberParser;
+    numberParser.SetLine (numberLine, sizeof (numberLine) - 1);
+    Report (filter, "CRSCCmdParser::GetUnsignedLong", 1, [&] (BenchTimer*)
+    {
+        numberParser.Reset ();
+        Sink += numberParser.GetUnsignedLong ();
+    });
+
+    // A session recorded from a provisioning run and from players at an event,
+    // replayed a line at a time
+    static const char* const RecordedSession[] =
+    {
+        "G\n", "h\n", "a 12ab34\n", "A 7XK2Q9MP\n", "L\n", "d XNY556\n", "W xny556\n",
+        "a12AB34\n", "  A   12AB34   \n", "G extra words\n", "\n", "x\n", "D wrong\n",
+        "R XNY556 12AB34\n", "I 12AB34\n", "L\r\n"
+    };
+    const unsigned numRecorded = sizeof (RecordedSession) / sizeof (RecordedSession[0]);
+    unsigned recordedLength[numRecorded];
+    for (unsigned i = 0; i < numRecorded; i++)
+        recordedLength[i] = strlen (RecordedSession[i]);
+
+    CRSCCmdParser sessionParser;
+    Report (filter, "CRSCCmdParser::GetChar+Tokenize (recorded session)", numRecorded, [&] (BenchTimer*)
+    {
+        CmdToken_t tokens[2];
+        for (unsigned i = 0; i < numRecorded; i++)
+        {
+            sessionParser.SetLine (RecordedSession[i], recordedLength[i]);
+            Sink += sessionParser.GetChar ();
+            Sink += sessionParser.Tokenize (tokens, 2);
+        }
+    });
+
+    // --- Whole commands through the serial interface ---------------------
+    CRSCSerialInterface serialInterface (&config);
+
+    Report (filter, "CRSCSerialInterface::Add+Update (G)", 1, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "G\n");
+    });
+
+    Report (filter, "CRSCSerialInterface::Add+Update (A, rejected)", 1, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "A 12AB34\n");
+    });
+
+    Report (filter, "CRSCSerialInterface::Add+Update (L)", 1, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "L\n");
+    });
+
+    Report (filter, "CRSCSerialInterface::Add+Update (H)", 1, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "H\n");
+    });
+
+    // The recorded session less the commands that reboot the board, all
+    // queued before Update() runs
+    std::string sessionLines;
+    for (unsigned i = 0; i < numRecorded; i++)
+    {
+        if ((toupper (RecordedSession[i][0]) != 'R') && (toupper (RecordedSession[i][0]) != 'I'))
+            sessionLines += RecordedSession[i];
+    }
+    Report (filter, "CRSCSerialInterface::Add+Update (recorded session)", numRecorded - 2, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, sessionLines.c_str ());
+    });
+
+    // A provisioning script doesn't wait for each command to finish before
+    // sending the next, so several lines are queued by the time Update() runs
+    Report (filter, "CRSCSerialInterface::Add+Update (8 x G pipelined)", 8, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "G\nG\nG\nG\nG\nG\nG\nG\n");
+    });
+
+    // --- Metrics ----------------------------------------------------------
+    // Record() is on every hot path it measures, so it has to stay cheap
+    CRSCMetrics metrics;
+
+    Report (filter, "CRSCMetrics::Record", 1, [&] (BenchTimer*)
+    {
+        metrics.Record (CRSCMetrics::METRIC_LOOP_MICROS, next++ & 0x3ff);
+    });
+
+    serialInterface.SetMetrics (&metrics);
+
+    Report (filter, "CRSCSerialInterface::Add+Update (M, with metrics)", 1, [&] (BenchTimer*)
+    {
+        RunCommand (&serialInterface, "M XNY556 J\n");
+    });
+
+    serialInterface.SetMetrics (NULL);
+
+    // --- Trace -------------------------------------------------------------
+    // Record() runs on the same paths as the metrics, and from Ticker callbacks
+    TheTrace.Begin ();
+
+    Report (filter, "CRSCTrace::Record", 1, [&] (BenchTimer*)
+    {
+        TheTrace.Record (CRSCTrace::TRACE_COMMAND, next++);
+    });
+
+    Report (filter, "CRSCTrace::Begin (full ring)", 1, [&] (BenchTimer*)
+    {
+        TheTrace.Begin ();
+    });
+
+    // --- Wifi connection, as seen from loop() -----------------------------
+    // With the access point out of reach, Update() is what every pass through
+    // loop() pays while we wait for it.
+    CRSCWifiConnector wifiConnector;
+    HostWiFiSetAccessPointAvailable (false);
+    wifiConnector.Connect ("BenchSSID", "BenchPassword");
+
+    Report (filter, "CRSCWifiConnector::Update (connecting)", 1, [&] (BenchTimer*)
+    {
+        Sink += wifiConnector.Update ();
+    });
+
+    wifiConnector.Disconnect ();
+    HostWiFiSetAccessPointAvailable (true);
+
+    // --- A complete IFTTT send against a loopback stand-in ----------------
+    HostWiFiSetConnectDelay (0);
+    WiFi.forceSleepWake ();     // Disconnect() left the radio powered down
+    WiFi.begin ("BenchSSID", "BenchPassword");
+    HostWiFiSetConnectRedirect ("127.0.0.1", StartHTTPStandIn ());
+
+    HostHeapStats_t senderHeapStats;
+    HostHeapResetStats ();
+    IFTTTMessageClass sender;
+    sender.Initialize ("BenchKey", myID, "CRSCBench");
+    HostHeapGetStats (&senderHeapStats);
+
+    Report (filter, "IFTTTMessageClass send (loopback stand-in)", 1, [&] (BenchTimer*)
+    {
+        sender.StartSend ("Scavenger hunt is complete!");
+        while (sender.Update () != IFTTTMessageClass::IFTTT_STATE_IDLE)
+            yield ();
+
+        if (sender.GetResult () != IFTTTMessageClass::IFTTT_RESULT_SUCCESS)
+            fprintf (stderr, "IFTTT send failed - result %d, HTTP %d\n", (int)sender.GetResult (), sender.GetHTTPCode ());
+        Sink += sender.GetHTTPCode ();
+    });
+
+    // What one send costs the heap and the TCP stack, rather than how long it takes
+    const char perMessageName[] = "IFTTTMessageClass send (per message)";
+    if ((filter == NULL) || (strstr (perMessageName, filter) != NULL))
+    {
+        const unsigned messages = 100;
+        HostClientStats_t clientStats;
+        HostHeapStats_t heapStats;
+
+        HostWiFiClientResetStats ();
+        HostHeapResetStats ();
+        for (unsigned i = 0; i < messages; i++)
+        {
+            sender.StartSend ("Scavenger hunt is complete!");
+            while (sender.Update () != IFTTTMessageClass::IFTTT_STATE_IDLE)
+                yield ();
+        }
+        HostWiFiClientGetStats (&clientStats);
+        HostHeapGetStats (&heapStats);
+
+        printf ("%-52s %7.1f bytes %6.2f writes %6.2f allocs %7.1f heap bytes\n", perMessageName,
+                (double)clientStats.Bytes / messages, (double)clientStats.Writes / messages,
+                (double)heapStats.Allocations / messages, (double)heapStats.Bytes / messages);
+        printf ("%-52s %6llu allocs %7llu heap bytes\n", "IFTTTMessageClass construct+Initialize",
+                senderHeapStats.Allocations, senderHeapStats.Bytes);
+    }
+
+    return (0);
+}
@@ -0,0 +1,148 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Boot time taken by the logo, before and after CRSCBanner. Both print the same
+// text through a model of the ESP8266 UART at 115200 baud - a 128 character
+// FIFO that writes wait on when it's full - against a simulated clock.
+//
+// Before, setup() printed the logo with Serial.println(), so it couldn't go on
+// until all but the last FIFO-full had been sent. After, setup() only starts
+// the banner and loop() tops up the FIFO every few milliseconds, as the sketch's
+// BannerTask does.
+//
+//   CRSCBoot [-i interval ms]
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include "CRSCBanner.h"
+#include "CRSCLogo.h"
+
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Collects what's printed to it, with no limit on what it takes
+class StringPrint : public Print
+{
+public:
+    std::string Text;
+
+    size_t write (uint8_t c)
+        { Text += (char)c; return (1); }
+};
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCBoot [-i interval ms]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned long interval = 5;
+    int option;
+
+    while ((option = getopt (argc, argv, "i:")) != -1)
+    {
+        switch (option)
+        {
+            case 'i': interval = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if (interval == 0)
+        Usage ();
+
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+    HostSerialSetBaud (115200);
+
+    // The text itself, which the old sketch kept as F() strings
+    CRSCBanner theBanner;
+    StringPrint logo;
+    theBanner.Begin (CRSCLogo);
+    theBanner.Finish (&logo);
+
+    printf ("Logo: %zu characters, %zu bytes encoded (%.0f%%)\n\n", logo.Text.size (), sizeof (CRSCLogo),
+            100.0 * sizeof (CRSCLogo) / logo.Text.size ());
+    printf ("%-24s %14s %14s %14s %8s\n", "", "setup() held", "longest stall", "logo sent", "calls");
+
+    // --- Before: a line at a time with Serial.println() ----------------
+    unsigned long startMicros = micros ();
+    size_t lineStart = 0;
+    unsigned calls = 0;
+
+    while (lineStart < logo.Text.size ())
+    {
+        size_t lineEnd = logo.Text.find ("\r\n", lineStart);
+        Serial.println (logo.Text.substr (lineStart, lineEnd - lineStart).c_str ());
+        lineStart = lineEnd + 2;
+        calls++;
+    }
+    unsigned long heldMicros = micros () - startMicros;
+    Serial.flush ();
+    unsigned long sentMicros = micros () - startMicros;
+
+    printf ("%-24s %11.1f ms %11.1f ms %11.1f ms %8u\n", "Serial.println()", heldMicros / 1000.0,
+            heldMicros / 1000.0, sentMicros / 1000.0, calls);
+
+    // --- After: CRSCBanner from loop() -----------------------------------
+    startMicros = micros ();
+    unsigned long longestMicros = 0;
+    calls = 0;
+
+    theBanner.Begin (CRSCLogo);
+    heldMicros = micros () - startMicros;
+
+    while (theBanner.IsDone () == false)
+    {
+        unsigned long callMicros = micros ();
+        theBanner.Update (&Serial);
+        calls++;
+
+        if (micros () - callMicros > longestMicros)
+            longestMicros = micros () - callMicros;
+
+        if (theBanner.IsDone () == false)
+            delay (interval);
+    }
+    Serial.flush ();
+    sentMicros = micros () - startMicros;
+
+    char label[48];
+    snprintf (label, sizeof (label), "CRSCBanner (%lu ms poll)", interval);
+    printf ("%-24s %11.1f ms %11.1f ms %11.1f ms %8u\n", label, heldMicros / 1000.0,
+            longestMicros / 1000.0, sentMicros / 1000.0, calls);
+
+    return (0);
+}
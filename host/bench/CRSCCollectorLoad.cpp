@@ -0,0 +1,321 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Load test for CRSCCollector. Each thread runs a set of real IFTTTMessageClass
+// senders, the same code the boards run, round-robin from one loop - just as a
+// board's loop() moves its one sender along - and points them at the collector.
+// Every board gets its own valid ID and is initialized the way the sketch does
+// it at power up. The first message from each board is its completion; any more
+// are that completion sent again, as the outbox does when a reply goes missing,
+// so the collector should end up with one place per board and the rest counted
+// as repeats.
+//
+// With -u the senders use CRSCDatagramTransport instead of HTTP, as a board
+// with a udp:// collector does, so the two can be compared on the same loopback.
+//
+//   CRSCCollectorLoad [-u] [-b boards] [-n messages] [-t threads] [-c senders] [-k key] [host[:port]]
+//
+//   -u           send datagrams instead of HTTP requests
+//
+//   -b boards    distinct boards (default 10000)
+//   -n messages  messages from each board (default 1)
+//   -t threads   sending threads (default one per core)
+//   -c senders   sends in flight per thread (default 32)
+//   -k key       IFTTT key to send with (default CRSCLoadKey)
+//
+// The collector defaults to 127.0.0.1:8080.
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include "CRSCConfig.h"
+#include "CRSCDatagram.h"
+#include "IFTTTMessage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// What the sketch sends when the hunt is complete
+static const char DoneMsg[] = "Scavenger hunt is complete! (#1)";
+
+// What one thread did
+typedef struct
+{
+    std::vector<unsigned long> Latencies;   // Microseconds, start of send to status line
+    unsigned long Failures[IFTTTMessageClass::IFTTT_RESULT_REQUEST_TOO_LONG + 1];
+    unsigned long Resends;                  // Datagrams sent again for want of an acknowledgement
+} ThreadResult_t;
+
+// One sender and the board it's currently sending for
+typedef struct
+{
+    IFTTTMessageClass Sender;
+    CRSCDatagramTransport Datagrams;
+    size_t Board;                           // Index into the board IDs
+    unsigned MessagesLeft;
+    std::chrono::steady_clock::time_point StartTime;
+} Slot_t;
+
+// ----------------------------------------------------------------------
+// Send every message for boards first, first + step, first + 2 * step ...
+static void SendForBoards (const std::vector<std::string>* boardIDs, size_t first, size_t step, unsigned messages,
+                           unsigned numSlots, bool useDatagrams, const char* key, const char* host, uint16_t port,
+                           ThreadResult_t* result)
+{
+    Slot_t* slots = new Slot_t[numSlots];
+    size_t nextBoard = first;
+    unsigned busy = 0;
+
+    memset (result->Failures, 0, sizeof (result->Failures));
+    for (unsigned i = 0; i < numSlots; i++)
+    {
+        if (useDatagrams)
+            slots[i].Sender.SetTransport (&slots[i].Datagrams);
+    }
+
+    // Start a board's next message, moving on to a new board if need be. Returns
+    // false when there's nothing left to send.
+    auto startNext = [&] (Slot_t* theSlot) -> bool
+    {
+        if (theSlot->MessagesLeft == 0)
+        {
+            if (nextBoard >= boardIDs->size ())
+                return (false);
+
+            theSlot->Board = nextBoard;
+            theSlot->MessagesLeft = messages;
+            nextBoard += step;
+            theSlot->Sender.Initialize (key, (*boardIDs)[theSlot->Board].c_str (), "CRSCGadget", host, port);
+        }
+
+        theSlot->MessagesLeft--;
+        theSlot->StartTime = std::chrono::steady_clock::now ();
+        theSlot->Sender.StartSend (DoneMsg, OUTBOX_HUNT_COMPLETE, 1);
+        return (true);
+    };
+
+    for (unsigned i = 0; i < numSlots; i++)
+    {
+        slots[i].MessagesLeft = 0;
+        if (startNext (&slots[i]))
+            busy++;
+    }
+
+    while (busy > 0)
+    {
+        // lwIP calls back between passes, as it does between the board's
+        // passes through loop()
+        yield ();
+
+        for (unsigned i = 0; i < numSlots; i++)
+        {
+            Slot_t* theSlot = &slots[i];
+
+            if ((theSlot->Sender.IsBusy () == false) ||
+                (theSlot->Sender.Update () != IFTTTMessageClass::IFTTT_STATE_IDLE))
+                continue;
+
+            if (theSlot->Sender.GetResult () == IFTTTMessageClass::IFTTT_RESULT_SUCCESS)
+            {
+                result->Latencies.push_back (std::chrono::duration_cast<std::chrono::microseconds> (
+                    std::chrono::steady_clock::now () - theSlot->StartTime).count ());
+            }
+            else
+            {
+                result->Failures[theSlot->Sender.GetResult ()]++;
+            }
+
+            if (startNext (theSlot) == false)
+                busy--;
+        }
+    }
+
+    result->Resends = 0;
+    for (unsigned i = 0; i < numSlots; i++)
+        result->Resends += slots[i].Datagrams.GetResends ();
+
+    delete[] slots;
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCCollectorLoad [-u] [-b boards] [-n messages] [-t threads] [-c senders] [-k key] [host[:port]]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    bool useDatagrams = false;
+    unsigned long numBoards = 10000;
+    unsigned messages = 1;
+    unsigned numThreads = std::thread::hardware_concurrency ();
+    unsigned numSlots = 32;
+    const char* key = "CRSCLoadKey";
+    std::string host = "127.0.0.1";
+    unsigned long port = 8080;
+    int option;
+
+    while ((option = getopt (argc, argv, "ub:n:t:c:k:")) != -1)
+    {
+        switch (option)
+        {
+            case 'u': useDatagrams = true; break;
+            case 'b': numBoards = strtoul (optarg, NULL, 10); break;
+            case 'n': messages = strtoul (optarg, NULL, 10); break;
+            case 't': numThreads = strtoul (optarg, NULL, 10); break;
+            case 'c': numSlots = strtoul (optarg, NULL, 10); break;
+            case 'k': key = optarg; break;
+            default:  Usage ();
+        }
+    }
+
+    if (optind == argc - 1)
+    {
+        const char* colon = strchr (argv[optind], ':');
+        host.assign (argv[optind], (colon != NULL) ? (size_t)(colon - argv[optind]) : strlen (argv[optind]));
+        if (colon != NULL)
+            port = strtoul (colon + 1, NULL, 10);
+    }
+    else if (optind != argc)
+    {
+        Usage ();
+    }
+
+    if ((numBoards == 0) || (messages == 0) || (numSlots == 0) || (port == 0) || (port > 65535))
+        Usage ();
+    if (numThreads == 0)
+        numThreads = 1;
+
+    // Every board gets a different ID, with check bytes, from the configuration
+    unsigned long long idSpace = 1;
+    for (int i = 0; i < BOARD_ID_BYTES; i++)
+        idSpace *= BOARD_ID_RADIX;
+    if (numBoards > idSpace)
+    {
+        fprintf (stderr, "There are only %llu board IDs\n", idSpace);
+        return (2);
+    }
+
+    CRSCConfigClass config;
+    std::vector<std::string> boardIDs;
+    boardIDs.reserve (numBoards);
+    for (unsigned long i = 0; i < numBoards; i++)
+    {
+        char theID[BOARD_ID_BUF_LEN];
+        config.UnpackBoardID ((uint32_t)((i * 7919ULL) % idSpace), theID);
+        boardIDs.push_back (theID);
+    }
+
+    // The senders print as they connect, as they do on the board
+    HostSerialSetOutputEnabled (false);
+    HostWiFiSetConnectDelay (0);
+    WiFi.forceSleepWake ();
+    WiFi.mode (WIFI_STA);
+    WiFi.begin ("LoadSSID", "LoadPassword");
+    if (WiFi.status () != WL_CONNECTED)
+    {
+        fprintf (stderr, "Host WiFi didn't connect\n");
+        return (1);
+    }
+
+    HostWiFiClientResetStats ();
+    HostWiFiUdpResetStats ();
+
+    std::vector<ThreadResult_t> results (numThreads);
+    std::vector<std::thread> threads;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+    for (unsigned t = 0; t < numThreads; t++)
+        threads.push_back (std::thread (SendForBoards, &boardIDs, t, numThreads, messages, numSlots, useDatagrams, key,
+                                        host.c_str (), (uint16_t)port, &results[t]));
+    for (std::thread& theThread : threads)
+        theThread.join ();
+
+    double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+    // Put everything together
+    std::vector<unsigned long> latencies;
+    unsigned long failures[IFTTTMessageClass::IFTTT_RESULT_REQUEST_TOO_LONG + 1] = {0};
+    unsigned long totalFailures = 0;
+    unsigned long resends = 0;
+    for (ThreadResult_t& theResult : results)
+    {
+        resends += theResult.Resends;
+        latencies.insert (latencies.end (), theResult.Latencies.begin (), theResult.Latencies.end ());
+        for (unsigned i = 0; i < sizeof (failures) / sizeof (failures[0]); i++)
+        {
+            failures[i] += theResult.Failures[i];
+            totalFailures += theResult.Failures[i];
+        }
+    }
+    std::sort (latencies.begin (), latencies.end ());
+
+    printf ("%lu boards x %u messages to %s%s:%lu, %u threads x %u senders\n", numBoards, messages,
+            useDatagrams ? "udp://" : "", host.c_str (), port, numThreads, numSlots);
+    printf ("%zu delivered, %lu failed in %.2f s - %.0f messages/s\n", latencies.size (), totalFailures, seconds,
+            latencies.size () / seconds);
+    if (latencies.empty () == false)
+    {
+        printf ("Latency (ms)  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n", latencies[latencies.size () / 2] / 1000.0,
+                latencies[(latencies.size () * 90) / 100] / 1000.0, latencies[(latencies.size () * 99) / 100] / 1000.0,
+                latencies.back () / 1000.0);
+    }
+
+    // What each message cost the board in writes to the stack
+    HostClientStats_t clientStats;
+    HostUdpStats_t udpStats;
+    unsigned long long sent = latencies.size () + totalFailures;
+    HostWiFiClientGetStats (&clientStats);
+    HostWiFiUdpGetStats (&udpStats);
+    if (useDatagrams)
+        printf ("Per message  %.2f datagrams  %.1f bytes  (%lu resends)\n", (double)udpStats.Datagrams / sent,
+                (double)udpStats.Bytes / sent, resends);
+    else
+        printf ("Per message  %.2f TCP writes  %.1f bytes, plus connection set up and tear down\n",
+                (double)clientStats.Writes / sent, (double)clientStats.Bytes / sent);
+
+    static const char* ResultNames[] = {"none", "success", "connect failed", "write failed", "timeout",
+                                        "bad response", "HTTP error", "request too long"};
+    for (unsigned i = 0; i < sizeof (failures) / sizeof (failures[0]); i++)
+    {
+        if (failures[i] != 0)
+            printf ("  %-18s %lu\n", ResultNames[i], failures[i]);
+    }
+
+    return ((totalFailures == 0) ? 0 : 1);
+}
@@ -0,0 +1,156 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// How long the serial commands with the most to say hold up loop(), with
+// output written straight to Serial and through CRSCConsole's ring buffer.
+// Both go through a model of the ESP8266 UART at 115200 baud - a 128 character
+// FIFO that writes wait on when it's full - against a simulated clock.
+//
+// Straight to Serial, a command doesn't return until all but the last
+// FIFO-full of its reply has gone. Through the console it returns once the
+// reply has been copied, and the sketch's ConsoleTask sends it a FIFO-full at
+// a time while loop() gets on with everything else.
+//
+//   CRSCConsoleStall [-i interval ms]
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include "CRSCConfig.h"
+#include "CRSCConsole.h"
+#include "CRSCMetrics.h"
+#include "CRSCSerialInterface.h"
+#include "CRSCTrace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// The commands timed, in the order a curious player might type them
+static const char* Commands[] =
+{
+    "H\n",
+    "D XNY556\n",
+    "L\n",
+    "M XNY556 J\n",
+    "T XNY556\n"
+};
+static const unsigned NumCommands = sizeof (Commands) / sizeof (Commands[0]);
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCConsoleStall [-i interval ms]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+// Feed a command line to the serial interface and run it. Returns how long
+// Update() held the loop, in microseconds.
+static unsigned long RunCommand (CRSCSerialInterface* theInterface, const char* line)
+{
+    while (*line != 0x00)
+        theInterface->Add (*line++);
+
+    unsigned long startMicros = micros ();
+    theInterface->Update ();
+    return (micros () - startMicros);
+}
+
+// ----------------------------------------------------------------------
+// Run every command, then wait until the last of the output has left the
+// UART, polling the console every interval milliseconds as the sketch does.
+static void Run (const char* label, CRSCSerialInterface* theInterface, unsigned long interval)
+{
+    unsigned long long startBytes = HostSerialBytesWritten ();
+    unsigned long startMicros = micros ();
+    unsigned long heldMicros = 0;
+    unsigned long longestMicros = 0;
+
+    for (unsigned i = 0; i < NumCommands; i++)
+    {
+        unsigned long commandMicros = RunCommand (theInterface, Commands[i]);
+
+        heldMicros += commandMicros;
+        if (commandMicros > longestMicros)
+            longestMicros = commandMicros;
+
+        // Give the console a chance between commands, as loop() would
+        while (TheConsole.Update ())
+            delay (interval);
+    }
+    TheConsole.Flush ();
+
+    unsigned long sentMicros = micros () - startMicros;
+    unsigned long long bytes = HostSerialBytesWritten () - startBytes;
+
+    printf ("%-16s %8llu %11.1f ms %11.1f ms %11.1f ms %7lu %7u\n", label, bytes, heldMicros / 1000.0,
+            longestMicros / 1000.0, sentMicros / 1000.0, TheConsole.GetStalls (), TheConsole.GetHighWater ());
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned long interval = 5;
+    int option;
+
+    while ((option = getopt (argc, argv, "i:")) != -1)
+    {
+        switch (option)
+        {
+            case 'i': interval = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if (interval == 0)
+        Usage ();
+
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+
+    CRSCConfigClass config;
+    HostFlashEraseAll ();
+    config.Initialize ("StallSSID", "StallPassword", "StallKey");
+    config.Load ();
+
+    CRSCMetrics metrics;
+    CRSCSerialInterface serialInterface (&config);
+    serialInterface.SetMetrics (&metrics);
+    TheTrace.Begin ();
+
+    HostSerialSetBaud (115200);
+
+    printf ("%-16s %8s %14s %14s %14s %7s %7s\n", "", "bytes", "loop held", "longest", "all sent", "stalls", "high");
+
+    Run ("Serial", &serialInterface, interval);
+
+    TheConsole.Begin ();
+    Run ("CRSCConsole", &serialInterface, interval);
+
+    return (0);
+}
@@ -0,0 +1,302 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Runs the scavenger hunt sketch itself - setup() and then loop() - through
+// days of a conference against a simulated clock, and counts every heap
+// allocation made after setup() returns. The board has no way to compact its
+// heap, so an allocation that comes and goes in the steady state is a hole
+// waiting to happen over a multi-day event. Exits 1 if there were any.
+//
+// Along the way the board is typed at every few minutes - help, lists, dumps,
+// metrics, the trace, and commands that are turned away - collects a full
+// list of IDs on the first day, and is asked for a Wifi test every day after,
+// so every path that prints, writes flash or sends a message has been run.
+// Messages go to an HTTP stand-in on the loopback interface.
+//
+// With -a, the first allocation aborts instead, so a debugger stops in the
+// code that made it.
+//
+//   CRSCHeapAudit [-d days] [-a]
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include <thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// The Arduino builder declares the sketch's functions for it
+bool ConsoleCanSend (void* arg);
+void ConsoleTask (void* arg);
+void BannerTask (void* arg);
+bool SerialInputWaiting (void* arg);
+void SerialTask (void* arg);
+void ConfigTask (void* arg);
+void QueueMessages (void);
+void ReportTask (void* arg);
+void serialEvent (void);
+void PrintWelcome (void);
+void PrintClosingMessage (void);
+
+#include "CRSCSketch.ino"
+
+// How often someone types at the board, and how often one of those is a new
+// scavenged ID on the first day (milliseconds)
+static const unsigned long CommandIntervalMillis = 10UL * 60UL * 1000UL;
+static const unsigned long ScavengeIntervalMillis = 60UL * 60UL * 1000UL;
+static const unsigned long DayMillis = 24UL * 60UL * 60UL * 1000UL;
+
+// What gets typed, in turn
+static const char* Commands[] =
+{
+    "G\n",
+    "H\n",
+    "L\n",
+    "M XNY556\n",
+    "M XNY556 J\n",
+    "T XNY556\n",
+    "D XNY556\n",
+    "A 12AB34\n",       // Not a valid ID
+    "D WRONG1\n",       // Wrong security code
+    "Q\n"               // No such command
+};
+static const unsigned NumCommands = sizeof (Commands) / sizeof (Commands[0]);
+
+// The characters board IDs are made from
+static const char IDChars[] = BOARD_ID_CHARS;
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCHeapAudit [-d days] [-a]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+// Make a valid board ID (with check bytes) whose fingerprint is thePrint.
+// Different serial numbers give different IDs.
+static void MakeBoardID (CRSCConfigClass* config, unsigned long thePrint, unsigned serial, char* theID)
+{
+    for (int i = 0; i < BOARD_ID_BYTES; i++)
+    {
+        // Pick from only the characters whose low bit matches the fingerprint bit
+        unsigned wantedBit = (thePrint >> (BOARD_ID_BYTES - 1 - i)) & 0x01;
+        char candidates[sizeof (IDChars)];
+        unsigned numCandidates = 0;
+
+        for (const char* c = IDChars; *c != 0x00; c++)
+        {
+            if ((*c & 0x01) == wantedBit)
+                candidates[numCandidates++] = *c;
+        }
+
+        theID[i] = candidates[serial % numCandidates];
+        serial /= numCandidates;
+    }
+    config->CalculateCheckBytes (theID, theID + BOARD_ID_BYTES);
+    theID[BOARD_ID_LEN] = 0x00;
+}
+
+// ----------------------------------------------------------------------
+// A stand-in for maker.ifttt.com on the loopback interface. It reads the
+// request and answers 200 OK.
+static void ServeHTTPStandIn (int listener)
+{
+    for (;;)
+    {
+        int connection = accept (listener, NULL, NULL);
+        if (connection < 0)
+            continue;
+
+        char request[1024];
+        size_t received = 0;
+
+        // The sketch sends the request in one go, so the blank line after the
+        // headers and the short body arrive together
+        while (received < sizeof (request) - 1)
+        {
+            ssize_t n = recv (connection, request + received, sizeof (request) - 1 - received, 0);
+            if (n <= 0)
+                break;
+            received += n;
+            request[received] = 0x00;
+
+            const char* body = strstr (request, "\r\n\r\n");
+            const char* length = strcasestr (request, "Content-Length:");
+            if ((body != NULL) && (length != NULL) && ((long)(request + received - (body + 4)) >= atol (length + 15)))
+                break;
+        }
+
+        const char response[] = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 0\r\n"
+                                "Connection: close\r\n\r\n";
+        send (connection, response, sizeof (response) - 1, MSG_NOSIGNAL);
+        close (connection);
+    }
+}
+
+// Start the stand-in on a free loopback port and return the port
+static uint16_t StartHTTPStandIn (void)
+{
+    int listener = socket (AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof (address);
+
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+    bind (listener, (struct sockaddr*)&address, sizeof (address));
+    listen (listener, 8);
+    getsockname (listener, (struct sockaddr*)&address, &addressLength);
+
+    std::thread (ServeHTTPStandIn, listener).detach ();
+    return (ntohs (address.sin_port));
+}
+
+// ----------------------------------------------------------------------
+// Run loop() until untilMillis. While the radio is up the stand-in is answering
+// in real time, so give it a moment each pass rather than let simulated time
+// run past the sender's timeouts.
+static unsigned long RunUntil (unsigned long untilMillis)
+{
+    unsigned long passes = 0;
+
+    while ((long)(millis () - untilMillis) < 0)
+    {
+        loop ();
+        passes++;
+
+        if (TheWifiConnector.IsRadioOn ())
+            usleep (100);
+    }
+    return (passes);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned long days = 3;
+    bool trap = false;
+    int option;
+
+    while ((option = getopt (argc, argv, "d:a")) != -1)
+    {
+        switch (option)
+        {
+            case 'd': days = strtoul (optarg, NULL, 0); break;
+            case 'a': trap = true; break;
+            default: Usage ();
+        }
+    }
+    if ((days == 0) || (days > 30))
+        Usage ();
+
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+    HostSerialSetBaud (115200);
+    HostWiFiSetConnectRedirect ("127.0.0.1", StartHTTPStandIn ());
+
+    // Configure the board as the loader sketch would, with a full list's worth
+    // of other boards that share its fingerprint
+    const unsigned long myPrint = 0x05;
+    char myID[BOARD_ID_BUF_LEN];
+    static char others[SCAVENGED_BOARD_LIST_LEN][BOARD_ID_BUF_LEN];
+    {
+        CRSCConfigClass loader;
+
+        HostFlashEraseAll ();
+        loader.Initialize ("AuditSSID", "AuditPassword", "AuditKey");
+        MakeBoardID (&loader, myPrint, 0, myID);
+        loader.SetBoardID (myID);
+        loader.Flush ();
+
+        for (unsigned i = 0; i < SCAVENGED_BOARD_LIST_LEN; i++)
+            MakeBoardID (&loader, myPrint, i + 1, others[i]);
+    }
+
+    // Power on
+    setup ();
+
+    HostHeapStats_t stats;
+    HostHeapResetStats ();
+    HostHeapSetTrap (trap);
+
+    unsigned long passes = 0;
+    unsigned long commands = 0;
+    unsigned scavenged = 0;
+    unsigned long startMillis = millis ();
+    unsigned long nextMillis = startMillis;
+
+    for (unsigned long day = 0; day < days; day++)
+    {
+        unsigned long dayStartMillis = startMillis + day * DayMillis;
+
+        while ((long)(nextMillis - (dayStartMillis + DayMillis)) < 0)
+        {
+            passes += RunUntil (nextMillis);
+
+            char line[32];
+            unsigned long sinceStart = nextMillis - dayStartMillis;
+
+            if ((day == 0) && (sinceStart % ScavengeIntervalMillis == 0) && (scavenged < SCAVENGED_BOARD_LIST_LEN))
+                snprintf (line, sizeof (line), "A %s\n", others[scavenged++]);
+            else if ((day > 0) && (sinceStart == DayMillis / 2))
+                snprintf (line, sizeof (line), "W XNY556\n");
+            else
+                snprintf (line, sizeof (line), "%s", Commands[commands % NumCommands]);
+
+            HostSerialFeed (line);
+            commands++;
+            nextMillis += CommandIntervalMillis;
+        }
+    }
+    passes += RunUntil (nextMillis);
+
+    HostHeapSetTrap (false);
+    HostHeapGetStats (&stats);
+
+    printf ("%lu days, %lu commands, %lu passes through loop()\n", days, commands, passes);
+    printf ("Hunt complete: %s, messages delivered: %lu, still queued: %u\n",
+            TheConfiguration.GetHuntComplete () ? "yes" : "no",
+            (unsigned long)TheMetrics.GetCount (CRSCMetrics::METRIC_SEND_MILLIS),
+            (unsigned)TheConfiguration.GetQueuedMessages ());
+    printf ("Heap after setup(): %llu allocations, %llu frees, %llu bytes\n", stats.Allocations, stats.Frees, stats.Bytes);
+
+    if (stats.Allocations > 0)
+    {
+        printf ("FAIL - the steady state uses the heap (run with -a under a debugger to find where)\n");
+        return (1);
+    }
+    printf ("PASS\n");
+    return (0);
+}
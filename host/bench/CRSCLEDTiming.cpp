@@ -0,0 +1,139 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Plays every fingerprint's flash sequence on the LED against a simulated
+// clock and checks each edge against the game policy, to the microsecond.
+// Also counts how many times the LED's timer fired per sequence, next to how
+// many times a ticker at a fixed interval would have.
+//
+//   CRSCLEDTiming [-n sequences] [-i interval ms]
+
+#include <Arduino.h>
+#include <HostShim.h>
+#include <Ticker.h>
+
+#include "CRSCLED.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCLEDTiming [-n sequences] [-i interval ms]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned sequences = 10;
+    unsigned long interval = 50;
+    int option;
+
+    while ((option = getopt (argc, argv, "n:i:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': sequences = strtoul (optarg, NULL, 0); break;
+            case 'i': interval = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if ((sequences == 0) || (interval == 0))
+        Usage ();
+
+    HostUseSimulatedClock (true);
+
+    CRSCLED theLED (LED_BUILTIN);
+    const unsigned long numPrints = 1UL << CRSCGame::FingerprintBits;
+    unsigned long long fired = 0;
+    unsigned long long sequenceMillis = 0;
+    unsigned long long fixedTicks = 0;
+    unsigned long maxError = 0;
+    unsigned long badEdges = 0;
+
+    for (unsigned long thePrint = 0; thePrint < numPrints; thePrint++)
+    {
+        // What the policy says the runs should be, starting with the gap
+        unsigned long expected[CRSCGame::FlashListLen];
+        unsigned long period = 0;
+        for (int i = 0; i < CRSCGame::FingerprintBits; i++)
+        {
+            expected[2 * i] = ((thePrint >> i) & 0x01) ? CRSCGame::LEDLongPulse : CRSCGame::LEDShortPulse;
+            expected[2 * i + 1] = CRSCGame::LEDOffPulse;
+        }
+        expected[CRSCGame::FlashListLen - 1] += CRSCGame::LEDGapPulse;
+        for (int i = 0; i < CRSCGame::FlashListLen; i++)
+            period += expected[i];
+
+        theLED.SetFingerprint (thePrint);
+
+        unsigned long firedBefore = Ticker::FiredCount ();
+        unsigned long lastEdge = micros ();
+        int level = HostPinLevel (LED_BUILTIN);
+        unsigned run = CRSCGame::FlashListLen - 1;
+
+        // Step straight to each timer deadline and see what the pin did
+        for (unsigned edge = 0; edge < sequences * CRSCGame::FlashListLen; edge++)
+        {
+            unsigned long due;
+            if (Ticker::NextDue (&due) == false)
+            {
+                fprintf (stderr, "Fingerprint %lu: LED timer stopped\n", thePrint);
+                return (1);
+            }
+            HostAdvanceMicros (due - micros ());
+
+            unsigned long width = micros () - lastEdge;
+            unsigned long error = (width > expected[run] * 1000UL) ? width - expected[run] * 1000UL
+                                                                   : expected[run] * 1000UL - width;
+            if (error > maxError)
+                maxError = error;
+            if (HostPinLevel (LED_BUILTIN) == level)
+                badEdges++;
+
+            level = HostPinLevel (LED_BUILTIN);
+            lastEdge = micros ();
+            run = (run + 1) % CRSCGame::FlashListLen;
+        }
+
+        fired += Ticker::FiredCount () - firedBefore;
+        sequenceMillis += (unsigned long long)period * sequences;
+        fixedTicks += ((unsigned long long)period * sequences) / interval;
+        theLED.SetOff ();
+    }
+
+    printf ("%lu fingerprints x %u sequences\n", numPrints, sequences);
+    printf ("timer interrupts per sequence: %.1f (a %lu ms ticker: %.1f)\n",
+            (double)fired / (numPrints * sequences), interval, (double)fixedTicks / (numPrints * sequences));
+    printf ("worst edge error: %lu us, edges without a level change: %lu\n", maxError, badEdges);
+
+    return (((maxError == 0) && (badEdges == 0)) ? 0 : 1);
+}
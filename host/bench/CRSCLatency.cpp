@@ -0,0 +1,328 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Measures how long a serial command waits before the board acts on it, and how
+// often the board wakes up when nothing is happening, for two ways of running
+// the sketch:
+//
+//   fixed      the old loop() - serial, configuration and Wifi work every pass,
+//              then delay(UPDATE_INTERVAL)
+//   scheduler  the tasks the sketch now gives CRSCScheduler
+//
+// Commands are either typed - a key, then Enter a moment later - or pasted, the
+// whole line at once. They come a few seconds apart, so the scheduler has often
+// gone back to polling slowly by the time the next one starts. Latency is
+// measured from the end of the line. Wakeups are every return from delay(),
+// counted once the board has been left alone for a while.
+//
+// The scheduler polls less often once the board has been quiet for a while, so
+// the mean hides what matters: the longest any command waits. For each kind of
+// input that is checked against the old loop()'s sleep - the longest it ever
+// went without looking at the serial port - and the program exits 1 if any
+// command waited longer.
+//
+// Board time is simulated, so an hour of commands replays in well under a
+// second and the numbers don't depend on how busy the host is. Commands
+// arrive at random moments, to the microsecond, from a Ticker.
+//
+//   CRSCLatency [-n commands] [-s seed]
+
+#include <Arduino.h>
+#include <HostShim.h>
+#include <Ticker.h>
+
+#include "CRSCConfig.h"
+#include "CRSCScheduler.h"
+#include "CRSCSerialInterface.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// How often the old loop() ran (milliseconds)
+static const unsigned long UpdateInterval = 50;
+
+// How long to leave the board alone before counting wakeups, and how long to
+// count them for (milliseconds)
+static const unsigned long SettleMillis = 5000;
+static const unsigned long IdleMillis = 60000;
+
+// How long a typist takes between the key and Enter (milliseconds)
+static const unsigned long KeyGapMillis = 150;
+
+// The command sent, how, and when the end of it arrived
+static const char Command[] = "G\n";
+static bool Typed;
+static unsigned long ArrivalMicros;
+static bool Waiting;
+
+// Gaps between commands (microseconds)
+static std::mt19937_64 Random;
+static std::uniform_int_distribution<unsigned long> Gap (500000, 5000000);
+
+static Ticker Arrival;
+
+// What one run measured
+typedef struct
+{
+    std::vector<unsigned long> Latencies;    // microseconds
+    double IdleWakeupsPerSecond;
+} LatencyResult_t;
+
+// ----------------------------------------------------------------------
+// Ticker callback - a command has just finished arriving
+static void CommandArrives (void)
+{
+    HostSerialFeed (Typed ? Command + 1 : Command);
+    ArrivalMicros = micros ();
+    Waiting = true;
+}
+
+// Ticker callback - the first key of a typed command
+static void CommandStarts (void)
+{
+    HostSerialFeed (Command, 1);
+    Arrival.once_ms (KeyGapMillis, CommandArrives);
+}
+
+// ----------------------------------------------------------------------
+// Arrange for the next command to arrive some random time from now
+static void ScheduleArrival (void)
+{
+    Arrival.once (Gap (Random) / 1000000.0f, Typed ? CommandStarts : CommandArrives);
+}
+
+// ----------------------------------------------------------------------
+// Called once a pass has run the serial interface. If the command got a reply,
+// note how long it waited and send the next one.
+static void CheckReply (unsigned long long* bytesBefore, LatencyResult_t* result, unsigned commands)
+{
+    if (Waiting && (HostSerialBytesWritten () != *bytesBefore))
+    {
+        result->Latencies.push_back (micros () - ArrivalMicros);
+        Waiting = false;
+        if (result->Latencies.size () < commands)
+            ScheduleArrival ();
+    }
+    *bytesBefore = HostSerialBytesWritten ();
+}
+
+// ----------------------------------------------------------------------
+// Drain the serial port into the interface, as the sketch's serialEvent() does
+static void ReadSerial (CRSCSerialInterface* theInterface)
+{
+    while (Serial.available ())
+        theInterface->Add ((char)Serial.read ());
+}
+
+// ----------------------------------------------------------------------
+// The old loop(): act on anything read last pass, read more, then sleep
+static void RunFixedLoop (CRSCConfigClass* config, unsigned commands, LatencyResult_t* result)
+{
+    CRSCSerialInterface theInterface (config);
+    unsigned long long bytes = HostSerialBytesWritten ();
+
+    ScheduleArrival ();
+    while (result->Latencies.size () < commands)
+    {
+        theInterface.Update ();
+        CheckReply (&bytes, result, commands);
+        config->Update ();
+        ReadSerial (&theInterface);
+        delay (UpdateInterval);
+    }
+
+    // Every pass runs everything, whether or not there is anything to do, and
+    // wakes once from delay()
+    delay (SettleMillis);
+    unsigned long passes = 0;
+    unsigned long start = millis ();
+    while (millis () - start < IdleMillis)
+    {
+        theInterface.Update ();
+        config->Update ();
+        ReadSerial (&theInterface);
+        delay (UpdateInterval);
+        passes++;
+    }
+    result->IdleWakeupsPerSecond = passes * 1000.0 / IdleMillis;
+}
+
+// ----------------------------------------------------------------------
+// The sketch's tasks, as far as the serial interface and configuration go
+static CRSCScheduler* TheScheduler;
+static CRSCSerialInterface* TheInterface;
+static CRSCConfigClass* TheConfig;
+static LatencyResult_t* TheResult;
+static unsigned long long BytesBefore;
+static unsigned TheCommands;
+static int ConfigTaskID;
+
+static bool SerialInputWaiting (void* arg)
+{
+    (void)arg;
+    return (Serial.available () > 0);
+}
+
+static void SerialTask (void* arg)
+{
+    (void)arg;
+    ReadSerial (TheInterface);
+    TheInterface->Update ();
+    CheckReply (&BytesBefore, TheResult, TheCommands);
+    TheScheduler->Wake (ConfigTaskID);
+}
+
+static void ConfigTask (void* arg)
+{
+    (void)arg;
+    TheConfig->Update ();
+    if (TheConfig->IsDirty ())
+        TheScheduler->RunIn (ConfigTaskID, TheConfig->GetWriteBackDelay ());
+}
+
+static void RunScheduler (CRSCConfigClass* config, unsigned commands, LatencyResult_t* result)
+{
+    CRSCScheduler scheduler;
+    CRSCSerialInterface theInterface (config);
+
+    TheScheduler = &scheduler;
+    TheInterface = &theInterface;
+    TheConfig = config;
+    TheResult = result;
+    TheCommands = commands;
+    BytesBefore = HostSerialBytesWritten ();
+
+    scheduler.AddTask (SerialTask, NULL, SerialInputWaiting);
+    ConfigTaskID = scheduler.AddTask (ConfigTask);
+
+    ScheduleArrival ();
+    while (result->Latencies.size () < commands)
+        scheduler.RunOnce ();
+
+    unsigned long start = millis ();
+    while (millis () - start < SettleMillis)
+        scheduler.RunOnce ();
+
+    unsigned long wakeups = scheduler.GetWakeups ();
+    start = millis ();
+    while (millis () - start < IdleMillis)
+        scheduler.RunOnce ();
+    result->IdleWakeupsPerSecond = (scheduler.GetWakeups () - wakeups) * 1000.0 / IdleMillis;
+}
+
+// ----------------------------------------------------------------------
+static void Print (const char* name, LatencyResult_t* result)
+{
+    std::vector<unsigned long>& l = result->Latencies;
+    double total = 0.0;
+
+    std::sort (l.begin (), l.end ());
+    for (unsigned long latency : l)
+        total += latency;
+
+    printf ("%-18s %10.1f %10.1f %10.1f %10.1f %15.1f\n", name,
+            total / l.size () / 1000.0, l[l.size () / 2] / 1000.0,
+            l[(l.size () * 99) / 100] / 1000.0, l.back () / 1000.0, result->IdleWakeupsPerSecond);
+}
+
+// ----------------------------------------------------------------------
+// Report the scheduler's worst case against the old loop()'s sleep, and the
+// old loop()'s own worst case. Returns true if the scheduler's is longer than
+// the sleep. Print() has sorted the latencies.
+static bool WorstCaseRegressed (const char* name, LatencyResult_t* fixed, LatencyResult_t* scheduled)
+{
+    double scheduledWorst = scheduled->Latencies.back () / 1000.0;
+    bool regressed = (scheduled->Latencies.back () > UpdateInterval * 1000UL);
+
+    printf ("%-18s worst case %.1f ms, limit %lu ms (fixed loop %.1f ms) - %s\n", name, scheduledWorst,
+            UpdateInterval, fixed->Latencies.back () / 1000.0, regressed ? "REGRESSION" : "ok");
+    return (regressed);
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCLatency [-n commands] [-s seed]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned commands = 2000;
+    unsigned long seed = 2019;
+    bool regressed = false;
+    int option;
+
+    while ((option = getopt (argc, argv, "n:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': commands = strtoul (optarg, NULL, 0); break;
+            case 's': seed = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if (commands == 0)
+        Usage ();
+
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+
+    CRSCConfigClass config;
+    HostFlashEraseAll ();
+    config.Initialize ("LatencySSID", "LatencyPassword", "LatencyKey");
+    config.Load ();
+
+    printf ("%-18s %10s %10s %10s %10s %15s\n", "loop", "mean ms", "p50 ms", "p99 ms", "max ms", "idle wakeups/s");
+
+    for (int typed = 1; typed >= 0; typed--)
+    {
+        Typed = (typed != 0);
+
+        LatencyResult_t fixed;
+        Random.seed (seed);
+        RunFixedLoop (&config, commands, &fixed);
+        Print (Typed ? "fixed, typed" : "fixed, pasted", &fixed);
+
+        LatencyResult_t scheduled;
+        Random.seed (seed);
+        RunScheduler (&config, commands, &scheduled);
+        Print (Typed ? "scheduler, typed" : "scheduler, pasted", &scheduled);
+
+        if (WorstCaseRegressed (Typed ? "  typed" : "  pasted", &fixed, &scheduled))
+            regressed = true;
+    }
+
+    return (regressed ? 1 : 0);
+}
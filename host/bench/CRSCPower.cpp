@@ -0,0 +1,168 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Replays a day at the conference for one board against a simulated clock and
+// reports how long the radio spent in each state, for two ways of running it:
+//
+//   default   the radio left as the SDK starts it, as the sketch used to
+//   managed   CRSCWifiConnector::Begin() at boot, the radio powered up only
+//             to send the hunt complete message and powered down after
+//   cached    managed, with the access point and address saved from the Wifi
+//             test before the event. The join skips the scan, but the board
+//             has been reset since, so it asks DHCP for a fresh address.
+//   moved     cached, but the access point has changed channel since, so the
+//             fast rejoin fails and falls back to a full join
+//
+// The host has no radio, so current is estimated from the measured duty cycle
+// and the typical figures in the ESP8266EX datasheet, at 3.3 V.
+//
+//   CRSCPower [-e event hours] [-c hunt complete hour] [-s send ms] [-d connect delay ms]
+//             [-f fast connect delay ms]
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <HostShim.h>
+
+#include "CRSCWifiConnector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ESP8266EX datasheet, typical at 3.3 V (milliamps)
+static const double RadioOffMilliamps = 15.0;      // Modem-sleep - CPU running, radio off
+static const double RadioOnMilliamps = 56.0;       // Receiving, which an unslept radio mostly is
+
+// How often the sketch moves the connection along (milliseconds)
+static const unsigned long UpdateInterval = 50;
+
+// ----------------------------------------------------------------------
+// Run the board through the day and print what the radio did
+static void RunDay (const char* name, bool managed, const wifi_cache_t* cache,
+                    unsigned long eventMillis, unsigned long completeMillis, unsigned long sendMillis)
+{
+    HostRadioStats_t stats;
+
+    // A fresh boot - the SDK brings the radio up in station mode
+    WiFi.forceSleepWake ();
+    WiFi.mode (WIFI_STA);
+    HostWiFiResetRadioStats ();
+    unsigned long start = millis ();
+
+    CRSCWifiConnector connector;
+    if (managed)
+        connector.Begin ();
+
+    // The hunt goes on, then the board tells ifttt.com it's done
+    delay (completeMillis);
+    connector.Connect ("PowerSSID", "PowerPassword", cache);
+    while (connector.Update () != CRSCWifiConnector::WIFI_STATE_CONNECTED)
+        delay (UpdateInterval);
+    delay (sendMillis);
+
+    if (managed)
+        connector.Disconnect ();
+
+    delay (eventMillis - (millis () - start));
+    HostWiFiGetRadioStats (&stats);
+
+    double total = (double)(stats.OffMicros + stats.IdleMicros + stats.JoiningMicros + stats.ConnectedMicros);
+    double on = (double)(stats.IdleMicros + stats.JoiningMicros + stats.ConnectedMicros);
+    double milliamps = (RadioOffMilliamps * stats.OffMicros + RadioOnMilliamps * on) / total;
+
+    printf ("%-9s %8lu %8.3f %8.3f %8.3f %11.3f %10.3f %9.1f %9.0f\n", name,
+            connector.GetLastConnectMilliseconds (), 100.0 * stats.OffMicros / total, 100.0 * stats.IdleMicros / total,
+            100.0 * stats.JoiningMicros / total, 100.0 * stats.ConnectedMicros / total,
+            100.0 * on / total, milliamps, milliamps * eventMillis / 3600000.0);
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCPower [-e event hours] [-c hunt complete hour] [-s send ms] [-d connect delay ms]\n"
+                     "                 [-f fast connect delay ms]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    double eventHours = 8.0;
+    double completeHours = 5.0;
+    unsigned long sendMillis = 1000;
+    unsigned long connectDelay = 1500;
+    unsigned long fastConnectDelay = 300;
+    int option;
+
+    while ((option = getopt (argc, argv, "e:c:s:d:f:")) != -1)
+    {
+        switch (option)
+        {
+            case 'e': eventHours = atof (optarg); break;
+            case 'c': completeHours = atof (optarg); break;
+            case 's': sendMillis = strtoul (optarg, NULL, 0); break;
+            case 'd': connectDelay = strtoul (optarg, NULL, 0); break;
+            case 'f': fastConnectDelay = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if ((completeHours < 0.0) || (eventHours * 3600000.0 < completeHours * 3600000.0 + sendMillis + connectDelay + 3000.0))
+        Usage ();
+
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+    HostWiFiSetConnectDelay (connectDelay);
+    HostWiFiSetFastConnectDelay (fastConnectDelay);
+
+    unsigned long eventMillis = (unsigned long)(eventHours * 3600000.0);
+    unsigned long completeMillis = (unsigned long)(completeHours * 3600000.0);
+
+    // The Wifi test run before the event, which leaves the details of the join
+    // behind in the configuration
+    wifi_cache_t cache;
+    CRSCWifiConnector tester;
+    tester.Connect ("PowerSSID", "PowerPassword");
+    while (tester.Update () != CRSCWifiConnector::WIFI_STATE_CONNECTED)
+        delay (UpdateInterval);
+    tester.GetWifiCache (&cache);
+    tester.Disconnect ();
+
+    printf ("%.1f hour event, hunt complete at %.1f hours, %lu ms join, %lu ms fast join, %lu ms send\n",
+            eventHours, completeHours, connectDelay, fastConnectDelay, sendMillis);
+    printf ("%-9s %8s %8s %8s %8s %11s %10s %9s %9s\n", "mode", "join ms", "off %", "idle %", "join %",
+            "connected %", "radio on %", "avg mA", "mAh");
+
+    RunDay ("default", false, NULL, eventMillis, completeMillis, sendMillis);
+    RunDay ("managed", true, NULL, eventMillis, completeMillis, sendMillis);
+    RunDay ("cached", true, &cache, eventMillis, completeMillis, sendMillis);
+
+    HostWiFiSetChannel (cache.Channel + 5);
+    RunDay ("moved", true, &cache, eventMillis, completeMillis, sendMillis);
+
+    return (0);
+}
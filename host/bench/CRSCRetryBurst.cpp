@@ -0,0 +1,198 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Simulates a session's worth of boards all finishing the hunt at once and
+// trying to reach ifttt.com through the same access point, to see how long it
+// takes for every board to get its message through. Each attempt takes one of
+// the server's slots for that second; attempts that find them all taken fail
+// and are retried according to the policy:
+//
+//   fixed     every board waits the same 10 seconds, as the sketch used to
+//   lockstep  CRSCBackoff, but every board seeded the same - backoff on its own
+//   backoff   CRSCBackoff seeded from each board's ID, as the sketch does now
+//
+// Boards get consecutive IDs, which is the worst case for seeding from them.
+//
+//   CRSCRetryBurst [-n boards] [-c attempts per second] [-w finish window ms]
+
+#include <Arduino.h>
+
+#include "CRSCBackoff.h"
+#include "CRSCConfig.h"
+
+#include <queue>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// How the boards wait between attempts
+typedef enum
+{
+    POLICY_FIXED,
+    POLICY_LOCKSTEP,
+    POLICY_BACKOFF
+} Policy_t;
+
+// The sketch's retry timing (milliseconds)
+static const unsigned long RetryBaseMillis = 10000;
+static const unsigned long RetryMaxMillis = 120000;
+
+// Give up on the simulation after this long (milliseconds)
+static const unsigned long LimitMillis = 3600000;
+
+// A board's next attempt - earliest first in the queue
+typedef struct
+{
+    unsigned long Millis;
+    unsigned Board;
+} Attempt_t;
+
+struct LaterAttempt
+{
+    bool operator() (const Attempt_t& a, const Attempt_t& b) const
+        { return ((a.Millis > b.Millis) || ((a.Millis == b.Millis) && (a.Board > b.Board))); }
+};
+
+// ----------------------------------------------------------------------
+// Run the burst with one policy and print how it went
+static void RunBurst (const char* name, Policy_t policy, unsigned boards,
+                      unsigned capacity, unsigned long windowMillis)
+{
+    CRSCConfigClass config;
+    std::vector<CRSCBackoff> retries;
+    std::priority_queue<Attempt_t, std::vector<Attempt_t>, LaterAttempt> pending;
+    std::vector<unsigned> served;       // Attempts that got through, by second
+    std::vector<unsigned> offered;      // All attempts, by second
+    char theID[BOARD_ID_LEN + 1];
+
+    // Everyone finishes within the window, at the same spread for every policy
+    srand (1);
+    for (unsigned i = 0; i < boards; i++)
+    {
+        retries.push_back (CRSCBackoff (RetryBaseMillis, RetryMaxMillis));
+        config.UnpackBoardID (1000 + i, theID);
+        retries[i].Seed ((policy == POLICY_BACKOFF) ? theID : "");
+
+        Attempt_t first = {(unsigned long)(rand () % (windowMillis + 1)), i};
+        pending.push (first);
+    }
+
+    unsigned long attempts = 0;
+    unsigned long lastMillis = 0;
+    unsigned done = 0;
+    unsigned doneBy[3] = {0, 0, 0};
+    static const unsigned long Checkpoints[3] = {30000, 60000, 120000};
+
+    while ((pending.empty () == false) && (pending.top ().Millis < LimitMillis))
+    {
+        Attempt_t attempt = pending.top ();
+        pending.pop ();
+
+        unsigned second = attempt.Millis / 1000;
+        if (second >= served.size ())
+        {
+            served.resize (second + 1, 0);
+            offered.resize (second + 1, 0);
+        }
+
+        attempts++;
+        offered[second]++;
+        if (served[second] < capacity)
+        {
+            // Got through
+            served[second]++;
+            done++;
+            lastMillis = attempt.Millis;
+            for (unsigned i = 0; i < 3; i++)
+                if (attempt.Millis < Checkpoints[i])
+                    doneBy[i]++;
+        }
+        else
+        {
+            // Turned away - try again later
+            attempt.Millis += (policy == POLICY_FIXED) ? RetryBaseMillis : retries[attempt.Board].Failed ();
+            pending.push (attempt);
+        }
+    }
+
+    // Busiest second once everyone has finished, counting the attempts that
+    // were turned away - the load the retries themselves put on the server
+    unsigned peak = 0;
+    for (unsigned i = windowMillis / 1000 + 1; i < offered.size (); i++)
+        if (offered[i] > peak)
+            peak = offered[i];
+
+    if (done < boards)
+        printf ("%-9s %10s", name, "never");
+    else
+        printf ("%-9s %10.1f", name, lastMillis / 1000.0);
+    printf (" %9lu %8.2f %7u %7u %7u %7u\n", attempts, (double)attempts / boards, peak,
+            doneBy[0], doneBy[1], doneBy[2]);
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCRetryBurst [-n boards] [-c attempts per second] [-w finish window ms]\n");
+    exit (1);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned boards = 500;
+    unsigned capacity = 10;
+    unsigned long windowMillis = 2000;
+    int option;
+
+    while ((option = getopt (argc, argv, "n:c:w:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': boards = strtoul (optarg, NULL, 0); break;
+            case 'c': capacity = strtoul (optarg, NULL, 0); break;
+            case 'w': windowMillis = strtoul (optarg, NULL, 0); break;
+            default: Usage ();
+        }
+    }
+    if ((boards == 0) || (capacity == 0))
+        Usage ();
+
+    printf ("%u boards finishing within %lu ms, %u attempts a second get through\n",
+            boards, windowMillis, capacity);
+    printf ("%-9s %10s %9s %8s %7s %7s %7s %7s\n", "policy", "drained s", "attempts",
+            "per send", "retry/s", "by 30s", "by 60s", "by 120s");
+
+    RunBurst ("fixed", POLICY_FIXED, boards, capacity, windowMillis);
+    RunBurst ("lockstep", POLICY_LOCKSTEP, boards, capacity, windowMillis);
+    RunBurst ("backoff", POLICY_BACKOFF, boards, capacity, windowMillis);
+
+    return (0);
+}
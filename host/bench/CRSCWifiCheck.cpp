@@ -0,0 +1,372 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Drives CRSCWifiConnector through the Wifi status sequences the shim can
+// produce and checks the states it goes through, and when. Exits 1 if any
+// check fails.
+//
+//   join       CONNECTING, then CONNECTED once the access point lets us in
+//   timeout    the access point never answers: each attempt gives up after
+//              10 s, waits out the backoff in RETRY_WAIT, then tries again,
+//              and connects once the access point comes back
+//   lost       CONNECTED, the link drops, CONNECTING again, and back
+//   rejoin     a fast rejoin with the details of the last join connects
+//              without the scan or DHCP, and the static address it used isn't
+//              cached again
+//   moved      a fast rejoin to an access point that has changed channel
+//              gives up after 2 s and falls back to a full join
+//   lease      once the cached address is half an hour old, a rejoin asks
+//              DHCP for an address again
+//   reset      after a reset the cached address can't be timed, so the first
+//              rejoin asks DHCP; the next can use the address it got
+//
+// Update() is called every StepMillis of simulated time, as loop() would, so
+// times are checked to within a step.
+//
+//   CRSCWifiCheck
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <HostShim.h>
+
+#include "CRSCWifiConnector.h"
+
+#include <stdio.h>
+
+typedef CRSCWifiConnector::WifiState_t WifiState_t;
+
+// How often Update() is called (milliseconds)
+static const unsigned long StepMillis = 10;
+
+// How long the shim's access point takes to let us in, with and without a
+// scan and DHCP (milliseconds)
+static const unsigned long JoinMillis = 1500;
+static const unsigned long FastJoinMillis = 300;
+
+// The connector's timeouts and backoff (milliseconds)
+static const unsigned long ConnectTimeout = 10000;
+static const unsigned long FastConnectTimeout = 2000;
+static const unsigned long AddressLifeMillis = 30UL * 60UL * 1000UL;
+static const unsigned long RetryBaseMillis = 10000;
+
+static const char SSID[] = "CheckSSID";
+static const char Password[] = "CheckPassword";
+
+static unsigned Checks = 0;
+static unsigned Failures = 0;
+
+static const char* StateNames[] = {"IDLE", "CONNECTING", "CONNECTED", "RETRY_WAIT"};
+
+// ----------------------------------------------------------------------
+// Note the result of a check, and say what was wrong if it failed
+static void Check (const char* scenario, bool passed, const char* what, unsigned long actual)
+{
+    Checks++;
+    if (passed == false)
+    {
+        Failures++;
+        printf ("  FAIL %-8s %s (got %lu)\n", scenario, what, actual);
+    }
+}
+
+// ----------------------------------------------------------------------
+// Note the result of a check on a connector state, naming the state it was
+// in if it failed. A state of -1 is none, as RunUntil() reports it.
+static void CheckState (const char* scenario, int theState, int expected, const char* what)
+{
+    Checks++;
+    if (theState != expected)
+    {
+        Failures++;
+        printf ("  FAIL %-8s %s (got %s)\n", scenario, what,
+                ((theState >= 0) && (theState < (int)(sizeof (StateNames) / sizeof (StateNames[0])))) ?
+                    StateNames[theState] : "none");
+    }
+}
+
+// ----------------------------------------------------------------------
+// Call Update() every step until the connector reaches theState or
+// limitMillis have gone by. Returns how long it took, or limitMillis if it
+// never got there. *passedThrough is set to any other state seen on the way.
+static unsigned long RunUntil (CRSCWifiConnector* theConnector, WifiState_t theState, unsigned long limitMillis,
+                               int* passedThrough = NULL)
+{
+    unsigned long startMillis = millis ();
+    WifiState_t startState = theConnector->GetState ();
+
+    if (passedThrough != NULL)
+        *passedThrough = -1;
+
+    while (millis () - startMillis < limitMillis)
+    {
+        WifiState_t state = theConnector->Update ();
+        if (state == theState)
+            return (millis () - startMillis);
+
+        if ((passedThrough != NULL) && (state != startState))
+            *passedThrough = state;
+
+        delay (StepMillis);
+    }
+    return (limitMillis);
+}
+
+// ----------------------------------------------------------------------
+// Put the shim's access point back as it starts, and power the radio down
+static void ResetAccessPoint (CRSCWifiConnector* theConnector)
+{
+    HostWiFiSetAccessPointAvailable (true);
+    HostWiFiSetChannel (6);
+    HostWiFiSetConnectDelay (JoinMillis);
+    HostWiFiSetFastConnectDelay (FastJoinMillis);
+    theConnector->Begin ();
+}
+
+// ----------------------------------------------------------------------
+// Return a flag which, when set, indicates that theMillis is within a step
+// either side of theExpected
+static bool Near (unsigned long theMillis, unsigned long theExpected)
+{
+    return ((theMillis + StepMillis >= theExpected) && (theMillis <= theExpected + StepMillis));
+}
+
+// ----------------------------------------------------------------------
+static void CheckJoin (void)
+{
+    CRSCWifiConnector connector;
+    ResetAccessPoint (&connector);
+
+    CheckState ("join", connector.GetState (), CRSCWifiConnector::WIFI_STATE_IDLE, "starts IDLE");
+    Check ("join", connector.IsRadioOn () == false, "radio off after Begin()", connector.IsRadioOn ());
+
+    connector.Connect (SSID, Password);
+    CheckState ("join", connector.GetState (), CRSCWifiConnector::WIFI_STATE_CONNECTING, "CONNECTING after Connect()");
+    Check ("join", connector.IsRadioOn (), "radio on after Connect()", connector.IsRadioOn ());
+
+    int other;
+    unsigned long took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout, &other);
+    Check ("join", Near (took, JoinMillis), "CONNECTED after the join delay", took);
+    CheckState ("join", other, -1, "no other state on the way");
+    Check ("join", Near (connector.GetLastConnectMilliseconds (), JoinMillis), "connect time recorded",
+           connector.GetLastConnectMilliseconds ());
+
+    connector.Disconnect ();
+    CheckState ("join", connector.GetState (), CRSCWifiConnector::WIFI_STATE_IDLE, "IDLE after Disconnect()");
+    Check ("join", connector.IsRadioOn () == false, "radio off after Disconnect()", connector.IsRadioOn ());
+}
+
+// ----------------------------------------------------------------------
+static void CheckTimeout (void)
+{
+    CRSCWifiConnector connector;
+    ResetAccessPoint (&connector);
+    connector.SetRetrySeed ("CHECK00");
+
+    HostWiFiSetAccessPointAvailable (false);
+    connector.Connect (SSID, Password);
+
+    // Two failed attempts, the second wait in a window twice the size of the first
+    for (unsigned attempt = 0; attempt < 2; attempt++)
+    {
+        unsigned long window = RetryBaseMillis << attempt;
+
+        unsigned long took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_RETRY_WAIT, 2 * ConnectTimeout);
+        Check ("timeout", Near (took, ConnectTimeout), "RETRY_WAIT after the connect timeout", took);
+
+        took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTING, 2 * window);
+        Check ("timeout", (took + StepMillis >= window / 2) && (took <= window + StepMillis),
+               "CONNECTING again after half to all of the backoff window", took);
+    }
+
+    // The access point comes back during the third attempt
+    HostWiFiSetAccessPointAvailable (true);
+    unsigned long took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    Check ("timeout", Near (took, JoinMillis), "CONNECTED once the access point is back", took);
+
+    // And the next failure starts from the first window again
+    connector.Disconnect ();
+    HostWiFiSetAccessPointAvailable (false);
+    connector.Connect (SSID, Password);
+    RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_RETRY_WAIT, 2 * ConnectTimeout);
+    took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTING, 4 * RetryBaseMillis);
+    Check ("timeout", took <= RetryBaseMillis + StepMillis, "backoff reset by a success", took);
+}
+
+// ----------------------------------------------------------------------
+static void CheckLost (void)
+{
+    CRSCWifiConnector connector;
+    ResetAccessPoint (&connector);
+
+    connector.Connect (SSID, Password);
+    RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+
+    // The access point drops us
+    HostWiFiSetAccessPointAvailable (false);
+    unsigned long took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTING, ConnectTimeout);
+    Check ("lost", took <= StepMillis, "CONNECTING as soon as the link drops", took);
+
+    // and lets us back in a few seconds later, before the attempt times out
+    delay (3000);
+    HostWiFiSetAccessPointAvailable (true);
+    int other;
+    took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout, &other);
+    Check ("lost", took <= StepMillis, "CONNECTED again once the access point is back", took);
+    CheckState ("lost", other, -1, "no RETRY_WAIT on the way");
+}
+
+// ----------------------------------------------------------------------
+static void CheckRejoin (bool moved)
+{
+    const char* scenario = moved ? "moved" : "rejoin";
+    CRSCWifiConnector connector;
+    wifi_cache_t cache;
+
+    ResetAccessPoint (&connector);
+    connector.Connect (SSID, Password);
+    RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    Check (scenario, connector.GetWifiCache (&cache), "cache filled in when connected", cache.Channel);
+    connector.Disconnect ();
+
+    if (moved)
+        HostWiFiSetChannel (11);
+
+    connector.Connect (SSID, Password, &cache);
+    int other;
+    unsigned long took = RunUntil (&connector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout, &other);
+
+    if (moved)
+    {
+        Check (scenario, Near (took, FastConnectTimeout + JoinMillis),
+               "CONNECTED by a full join after the fast rejoin times out", took);
+        Check (scenario, connector.CacheFailed (), "cache reported as failed", connector.CacheFailed ());
+    }
+    else
+    {
+        Check (scenario, Near (took, FastJoinMillis), "CONNECTED after the fast join delay", took);
+        Check (scenario, connector.CacheFailed () == false, "cache not reported as failed", connector.CacheFailed ());
+        Check (scenario, connector.GetWifiCache (&cache) == false, "static address not cached", cache.Channel);
+    }
+    CheckState (scenario, other, -1, "no other state on the way");
+}
+
+// ----------------------------------------------------------------------
+// Join and disconnect, then wait awayMillis and rejoin with the details of the
+// join. Returns how long the rejoin took; *theCache is left holding whatever
+// the rejoin will let be cached, or a channel of 0 if nothing.
+static unsigned long Rejoin (CRSCWifiConnector* theConnector, unsigned long awayMillis, wifi_cache_t* theCache)
+{
+    ResetAccessPoint (theConnector);
+    theConnector->Connect (SSID, Password);
+    RunUntil (theConnector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    theConnector->GetWifiCache (theCache);
+    theConnector->Disconnect ();
+
+    delay (awayMillis);
+    theConnector->Connect (SSID, Password, theCache);
+    unsigned long took = RunUntil (theConnector, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    if (theConnector->GetWifiCache (theCache) == false)
+        theCache->Channel = 0;
+    theConnector->Disconnect ();
+    return (took);
+}
+
+// ----------------------------------------------------------------------
+static void CheckLease (void)
+{
+    CRSCWifiConnector connector;
+    wifi_cache_t cache;
+
+    unsigned long took = Rejoin (&connector, AddressLifeMillis - 60000, &cache);
+    Check ("lease", Near (took, FastJoinMillis), "fast rejoin while the address is fresh", took);
+    Check ("lease", cache.Channel == 0, "static address not cached", cache.Channel);
+
+    took = Rejoin (&connector, AddressLifeMillis + 60000, &cache);
+    Check ("lease", Near (took, JoinMillis), "rejoin asks DHCP once the address is old", took);
+    Check ("lease", cache.Channel != 0, "DHCP address cached", cache.Channel);
+    Check ("lease", connector.CacheFailed () == false, "cache not reported as failed", connector.CacheFailed ());
+}
+
+// ----------------------------------------------------------------------
+static void CheckReset (void)
+{
+    CRSCWifiConnector beforeReset;
+    CRSCWifiConnector afterReset;
+    wifi_cache_t cache;
+
+    ResetAccessPoint (&beforeReset);
+    beforeReset.Connect (SSID, Password);
+    RunUntil (&beforeReset, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    beforeReset.GetWifiCache (&cache);
+    beforeReset.Disconnect ();
+
+    // A new connector has no idea how old the cached address is
+    afterReset.Begin ();
+    afterReset.Connect (SSID, Password, &cache);
+    unsigned long took = RunUntil (&afterReset, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    Check ("reset", Near (took, JoinMillis), "first rejoin asks DHCP", took);
+    Check ("reset", afterReset.CacheFailed () == false, "cache not reported as failed", afterReset.CacheFailed ());
+    Check ("reset", afterReset.GetWifiCache (&cache), "DHCP address cached", cache.Channel);
+    afterReset.Disconnect ();
+
+    afterReset.Connect (SSID, Password, &cache);
+    took = RunUntil (&afterReset, CRSCWifiConnector::WIFI_STATE_CONNECTED, 2 * ConnectTimeout);
+    Check ("reset", Near (took, FastJoinMillis), "next rejoin uses the address it got", took);
+}
+
+// ----------------------------------------------------------------------
+int main (void)
+{
+    HostUseSimulatedClock (true);
+    HostSerialSetOutputEnabled (false);
+
+    struct
+    {
+        const char* Name;
+        void (*Run) (void);
+    } scenarios[] =
+    {
+        {"join", CheckJoin},
+        {"timeout", CheckTimeout},
+        {"lost", CheckLost},
+        {"rejoin", [] (void) { CheckRejoin (false); }},
+        {"moved", [] (void) { CheckRejoin (true); }},
+        {"lease", CheckLease},
+        {"reset", CheckReset}
+    };
+
+    for (auto& scenario : scenarios)
+    {
+        unsigned failuresBefore = Failures;
+        scenario.Run ();
+        printf ("%-8s %s\n", scenario.Name, (Failures == failuresBefore) ? "PASS" : "FAIL");
+    }
+
+    printf ("%u checks, %u failed\n", Checks, Failures);
+    return ((Failures == 0) ? 0 : 1);
+}
@@ -0,0 +1,379 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "HostShim.h"
+#include "Ticker.h"
+
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// ----------------------------------------------------------------------
+// Clock
+
+static bool SimulatedClock = false;
+static unsigned long long SimulatedMicros = 0;
+
+// Monotonic time since the first call, in microseconds
+static unsigned long long RealMicros (void)
+{
+    static unsigned long long startTime = 0;
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    unsigned long long nowMicros = (unsigned long long)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+
+    if (startTime == 0)
+        startTime = nowMicros;
+
+    return (nowMicros - startTime);
+}
+
+static unsigned long long NowMicros (void)
+{
+    return (SimulatedClock ? SimulatedMicros : RealMicros ());
+}
+
+void HostUseSimulatedClock (bool simulated)
+{
+    SimulatedClock = simulated;
+}
+
+// In simulated mode, stop at each ticker deadline on the way so callbacks see
+// the time they were due at rather than the end of the whole step.
+void HostAdvanceMicros (unsigned long long us)
+{
+    if (SimulatedClock)
+    {
+        unsigned long long target = SimulatedMicros + us;
+        unsigned long due;
+
+        while (Ticker::NextDue (&due) && (due <= target))
+        {
+            if (due > SimulatedMicros)
+                SimulatedMicros = due;
+            HostServiceTickers ();
+        }
+        SimulatedMicros = target;
+    }
+    else
+    {
+        usleep ((useconds_t)us);
+    }
+
+    HostServiceTickers ();
+    HostServiceNetwork ();
+}
+
+unsigned long millis (void)
+{
+    return ((unsigned long)(NowMicros () / 1000ULL));
+}
+
+unsigned long micros (void)
+{
+    return ((unsigned long)NowMicros ());
+}
+
+void delay (unsigned long ms)
+{
+    HostAdvanceMillis (ms);
+}
+
+void delayMicroseconds (unsigned int us)
+{
+    HostAdvanceMicros (us);
+}
+
+void yield (void)
+{
+    HostServiceTickers ();
+    HostServiceNetwork ();
+}
+
+// ----------------------------------------------------------------------
+// Digital I/O - just remember the levels so host programs can look at them
+
+static uint8_t PinLevels[32];
+
+void pinMode (uint8_t pin, uint8_t mode)
+{
+    (void)pin; (void)mode;
+}
+
+void digitalWrite (uint8_t pin, uint8_t val)
+{
+    if (pin < sizeof (PinLevels))
+        PinLevels[pin] = val;
+}
+
+int digitalRead (uint8_t pin)
+{
+    return ((pin < sizeof (PinLevels)) ? PinLevels[pin] : LOW);
+}
+
+int HostPinLevel (uint8_t pin)
+{
+    return (digitalRead (pin));
+}
+
+// ----------------------------------------------------------------------
+long random (long howBig)
+{
+    return ((howBig <= 0) ? 0 : (rand () % howBig));
+}
+
+long random (long howSmall, long howBig)
+{
+    return ((howSmall >= howBig) ? howSmall : (random (howBig - howSmall) + howSmall));
+}
+
+void randomSeed (unsigned long seed)
+{
+    srand ((unsigned int)seed);
+}
+
+// ----------------------------------------------------------------------
+// Print
+
+size_t Print::write (const uint8_t* buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+        n += write (*buffer++);
+    return (n);
+}
+
+size_t Print::PrintNumber (unsigned long n, int base)
+{
+    char buf[8 * sizeof (long) + 1];
+    char* p = &buf[sizeof (buf) - 1];
+    *p = 0x00;
+
+    if (base < 2)
+        base = 10;
+
+    do
+    {
+        unsigned long digit = n % base;
+        *--p = (char)((digit < 10) ? ('0' + digit) : ('A' + digit - 10));
+        n /= base;
+    } while (n != 0);
+
+    return (write (p));
+}
+
+size_t Print::print (const __FlashStringHelper* str) { return (write ((const char*)str)); }
+size_t Print::print (const String& str) { return (write (str.c_str (), str.length ())); }
+size_t Print::print (const char* str) { return (write (str)); }
+size_t Print::print (char c) { return (write ((uint8_t)c)); }
+size_t Print::print (unsigned char n, int base) { return (print ((unsigned long)n, base)); }
+size_t Print::print (int n, int base) { return (print ((long)n, base)); }
+size_t Print::print (unsigned int n, int base) { return (print ((unsigned long)n, base)); }
+size_t Print::print (unsigned long n, int base) { return (PrintNumber (n, base)); }
+
+size_t Print::print (long n, int base)
+{
+    if ((base == 10) && (n < 0))
+        return (print ('-') + PrintNumber ((unsigned long)(-n), 10));
+    return (PrintNumber ((unsigned long)n, base));
+}
+
+size_t Print::print (double n, int digits)
+{
+    char buf[40];
+    snprintf (buf, sizeof (buf), "%.*f", digits, n);
+    return (write (buf));
+}
+
+size_t Print::println (void) { return (write ("\r\n")); }
+size_t Print::println (const __FlashStringHelper* str) { return (print (str) + println ()); }
+size_t Print::println (const String& str) { return (print (str) + println ()); }
+size_t Print::println (const char* str) { return (print (str) + println ()); }
+size_t Print::println (char c) { return (print (c) + println ()); }
+size_t Print::println (unsigned char n, int base) { return (print (n, base) + println ()); }
+size_t Print::println (int n, int base) { return (print (n, base) + println ()); }
+size_t Print::println (unsigned int n, int base) { return (print (n, base) + println ()); }
+size_t Print::println (long n, int base) { return (print (n, base) + println ()); }
+size_t Print::println (unsigned long n, int base) { return (print (n, base) + println ()); }
+size_t Print::println (double n, int digits) { return (print (n, digits) + println ()); }
+
+size_t Print::printf (const char* format, ...)
+{
+    char buf[256];
+    va_list args;
+
+    va_start (args, format);
+    int len = vsnprintf (buf, sizeof (buf), format, args);
+    va_end (args);
+
+    if (len < 0)
+        return (0);
+    if (len >= (int)sizeof (buf))
+        len = sizeof (buf) - 1;
+
+    return (write ((const uint8_t*)buf, len));
+}
+
+// ----------------------------------------------------------------------
+// Serial
+
+HardwareSerial Serial;
+
+// What the host has fed in and the sketch hasn't read yet. A fixed ring, like
+// the core's receive buffer, so reading a command doesn't show up as heap use.
+// Anything fed when it's full is dropped, as an overrun would be on the board.
+static const unsigned SerialInputLen = 1024;
+static char SerialInput[SerialInputLen];
+static unsigned SerialInputHead = 0;
+static unsigned SerialInputCount = 0;
+static bool SerialOutputEnabled = true;
+static unsigned long long SerialBytesWritten = 0;
+
+// The UART model. With a baud rate set, bytes leave the transmit FIFO one
+// character time apart, and the FIFO is empty from UartIdleNanos on.
+static const int UartFifoLen = 128;
+static unsigned long long UartByteNanos = 0;
+static unsigned long long UartIdleNanos = 0;
+
+void HostSerialSetBaud (unsigned long baud)
+{
+    // 8N1 - ten bits a character
+    UartByteNanos = (baud == 0) ? 0 : (10ULL * 1000000000ULL + baud - 1) / baud;
+    UartIdleNanos = 0;
+}
+
+// Bytes still waiting in the transmit FIFO
+static int UartFifoUsed (void)
+{
+    unsigned long long now = NowMicros () * 1000ULL;
+
+    if (UartIdleNanos <= now)
+        return (0);
+    return ((int)((UartIdleNanos - now + UartByteNanos - 1) / UartByteNanos));
+}
+
+// Put size bytes in the FIFO, waiting for room as the board's core does
+static void UartTransmit (size_t size)
+{
+    while (size > 0)
+    {
+        int used = UartFifoUsed ();
+        if (used >= UartFifoLen)
+        {
+            HostAdvanceMicros ((UartIdleNanos - (UartFifoLen - 1) * UartByteNanos) / 1000ULL + 1 - NowMicros ());
+            continue;
+        }
+
+        size_t batch = ((size_t)(UartFifoLen - used) < size) ? (size_t)(UartFifoLen - used) : size;
+        unsigned long long now = NowMicros () * 1000ULL;
+        UartIdleNanos = ((UartIdleNanos > now) ? UartIdleNanos : now) + batch * UartByteNanos;
+        size -= batch;
+    }
+}
+
+void HostSerialFeed (const char* data, size_t len)
+{
+    for (size_t i = 0; (i < len) && (SerialInputCount < SerialInputLen); i++)
+    {
+        SerialInput[(SerialInputHead + SerialInputCount) % SerialInputLen] = data[i];
+        SerialInputCount++;
+    }
+}
+
+void HostSerialFeed (const char* str)
+{
+    HostSerialFeed (str, strlen (str));
+}
+
+void HostSerialSetOutputEnabled (bool enabled)
+{
+    SerialOutputEnabled = enabled;
+}
+
+unsigned long long HostSerialBytesWritten (void)
+{
+    return (__atomic_load_n (&SerialBytesWritten, __ATOMIC_RELAXED));
+}
+
+int HardwareSerial::available (void)
+{
+    return ((int)SerialInputCount);
+}
+
+int HardwareSerial::read (void)
+{
+    if (SerialInputCount == 0)
+        return (-1);
+
+    int c = (unsigned char)SerialInput[SerialInputHead];
+    SerialInputHead = (SerialInputHead + 1) % SerialInputLen;
+    SerialInputCount--;
+    return (c);
+}
+
+int HardwareSerial::peek (void)
+{
+    return ((SerialInputCount == 0) ? -1 : (unsigned char)SerialInput[SerialInputHead]);
+}
+
+void HardwareSerial::flush (void)
+{
+    if ((UartByteNanos != 0) && (UartFifoUsed () > 0))
+        HostAdvanceMicros ((UartIdleNanos + 999ULL) / 1000ULL - NowMicros ());
+
+    if (SerialOutputEnabled)
+        fflush (stdout);
+}
+
+size_t HardwareSerial::write (uint8_t c)
+{
+    return (write (&c, 1));
+}
+
+size_t HardwareSerial::write (const uint8_t* buffer, size_t size)
+{
+    __atomic_add_fetch (&SerialBytesWritten, size, __ATOMIC_RELAXED);
+
+    if (UartByteNanos != 0)
+        UartTransmit (size);
+
+    if (SerialOutputEnabled)
+        fwrite (buffer, 1, size, stdout);
+
+    return (size);
+}
+
+// The ESP8266 UART has a 128 byte transmit FIFO. Without the UART model stdout
+// never blocks us, so always report it as empty.
+int HardwareSerial::availableForWrite (void)
+{
+    return ((UartByteNanos == 0) ? UartFifoLen : UartFifoLen - UartFifoUsed ());
+}
@@ -0,0 +1,197 @@
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Host (Linux) stand-in for the parts of the ESP8266 Arduino core used by the
+// CRSC libraries. Only what the libraries actually call is provided - this is
+// not meant to be a general purpose Arduino emulator. Host-only controls
+// (simulated clock, serial input, and so on) live in HostShim.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH   0x1
+#define LOW    0x0
+
+#define INPUT  0x00
+#define OUTPUT 0x01
+
+// The NodeMCU's on-board LED is on GPIO2
+#define LED_BUILTIN 2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Flash-resident constants are just ordinary memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const unsigned char*)(addr))
+#define pgm_read_word(addr) (*(const unsigned short*)(addr))
+#define pgm_read_dword(addr) (*(const unsigned long*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define vsnprintf_P vsnprintf
+#define PGM_P const char*
+
+// F() marks a string as living in flash. Print has overloads for the resulting type.
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+#define F(s) FPSTR(PSTR(s))
+
+// Time
+unsigned long millis (void);
+unsigned long micros (void);
+void delay (unsigned long ms);
+void delayMicroseconds (unsigned int us);
+void yield (void);
+
+// Ticker callbacks on the host run on the same thread as everything else, from
+// delay() and yield(), so there is nothing to mask
+inline void noInterrupts (void) {}
+inline void interrupts (void) {}
+
+// Digital I/O
+void pinMode (uint8_t pin, uint8_t mode);
+void digitalWrite (uint8_t pin, uint8_t val);
+int digitalRead (uint8_t pin);
+
+// Character classification, as found in WCharacter.h
+inline bool isSpace (int c) { return (isspace (c) != 0); }
+inline bool isWhitespace (int c) { return (isblank (c) != 0); }
+inline bool isDigit (int c) { return (isdigit (c) != 0); }
+inline bool isAlpha (int c) { return (isalpha (c) != 0); }
+inline bool isAlphaNumeric (int c) { return (isalnum (c) != 0); }
+inline bool isUpperCase (int c) { return (isupper (c) != 0); }
+
+long random (long howBig);
+long random (long howSmall, long howBig);
+void randomSeed (unsigned long seed);
+
+#include "WString.h"
+
+// ---------------------------------------------------------------------------
+// Base class for anything that can be printed to - Serial and WiFiClient
+class Print
+{
+public:
+    virtual ~Print (void) {}
+
+    virtual size_t write (uint8_t c) = 0;
+    virtual size_t write (const uint8_t* buffer, size_t size);
+
+    size_t write (const char* str)
+        { return ((str == NULL) ? 0 : write ((const uint8_t*)str, strlen (str))); }
+    size_t write (const char* buffer, size_t size)
+        { return (write ((const uint8_t*)buffer, size)); }
+
+    // Number of bytes that can be written without blocking
+    virtual int availableForWrite (void) { return (0); }
+
+    size_t print (const __FlashStringHelper* str);
+    size_t print (const String& str);
+    size_t print (const char* str);
+    size_t print (char c);
+    size_t print (unsigned char n, int base = DEC);
+    size_t print (int n, int base = DEC);
+    size_t print (unsigned int n, int base = DEC);
+    size_t print (long n, int base = DEC);
+    size_t print (unsigned long n, int base = DEC);
+    size_t print (double n, int digits = 2);
+
+    size_t println (const __FlashStringHelper* str);
+    size_t println (const String& str);
+    size_t println (const char* str);
+    size_t println (char c);
+    size_t println (unsigned char n, int base = DEC);
+    size_t println (int n, int base = DEC);
+    size_t println (unsigned int n, int base = DEC);
+    size_t println (long n, int base = DEC);
+    size_t println (unsigned long n, int base = DEC);
+    size_t println (double n, int digits = 2);
+    size_t println (void);
+
+    size_t printf (const char* format, ...) __attribute__ ((format (printf, 2, 3)));
+
+private:
+    size_t PrintNumber (unsigned long n, int base);
+};
+
+// ---------------------------------------------------------------------------
+// Base class for things we can read from
+class Stream : public Print
+{
+public:
+    virtual int available (void) = 0;
+    virtual int read (void) = 0;
+    virtual int peek (void) = 0;
+    virtual void flush (void) {}
+};
+
+// ---------------------------------------------------------------------------
+// The serial port. Output goes to stdout (unless silenced through HostShim.h)
+// and input comes from whatever the host program feeds in.
+class HardwareSerial : public Stream
+{
+public:
+    void begin (unsigned long baud) { (void)baud; }
+    void end (void) {}
+    size_t setRxBufferSize (size_t size) { return (size); }
+
+    int available (void);
+    int read (void);
+    int peek (void);
+    void flush (void);
+
+    size_t write (uint8_t c);
+    size_t write (const uint8_t* buffer, size_t size);
+    int availableForWrite (void);
+
+    using Print::write;
+
+    operator bool (void) { return (true); }
+};
+
+extern HardwareSerial Serial;
+
+#include "Esp.h"
+
+#endif
@@ -0,0 +1,103 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "EEPROM.h"
+
+EEPROMClass EEPROM (HOST_EEPROM_SECTOR);
+
+// ----------------------------------------------------------------------
+EEPROMClass::EEPROMClass (uint32_t sector)
+    : Sector (sector), Data (NULL), Size (0), Dirty (false)
+{
+}
+
+// ----------------------------------------------------------------------
+void EEPROMClass::begin (size_t size)
+{
+    if ((size == 0) || (size > SPI_FLASH_SEC_SIZE))
+        return;
+
+    size = (size + 3) & ~3;
+
+    if (Data != NULL)
+        delete[] Data;
+    Data = new uint8_t[size];
+    Size = size;
+    Dirty = false;
+
+    ESP.flashRead (Sector * SPI_FLASH_SEC_SIZE, (uint32_t*)Data, Size);
+}
+
+// ----------------------------------------------------------------------
+uint8_t EEPROMClass::read (int address)
+{
+    if ((address < 0) || ((size_t)address >= Size))
+        return (0);
+    return (Data[address]);
+}
+
+void EEPROMClass::write (int address, uint8_t val)
+{
+    if ((address < 0) || ((size_t)address >= Size))
+        return;
+
+    if (Data[address] != val)
+    {
+        Data[address] = val;
+        Dirty = true;
+    }
+}
+
+// ----------------------------------------------------------------------
+bool EEPROMClass::commit (void)
+{
+    if ((Size == 0) || (Dirty == false))
+        return (Size != 0);
+
+    if (ESP.flashEraseSector (Sector) && ESP.flashWrite (Sector * SPI_FLASH_SEC_SIZE, (uint32_t*)Data, Size))
+    {
+        Dirty = false;
+        return (true);
+    }
+    return (false);
+}
+
+void EEPROMClass::end (void)
+{
+    commit ();
+
+    delete[] Data;
+    Data = NULL;
+    Size = 0;
+}
+
+uint8_t* EEPROMClass::getDataPtr (void)
+{
+    Dirty = true;
+    return (Data);
+}
@@ -0,0 +1,77 @@
+#ifndef _HOST_EEPROM_H
+#define _HOST_EEPROM_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+
+// Works the way the ESP8266 core's EEPROM does: begin() copies one flash sector
+// into RAM, get()/put() work on the RAM copy and commit() erases the sector and
+// writes the whole copy back.
+class EEPROMClass
+{
+public:
+    EEPROMClass (uint32_t sector);
+
+    void begin (size_t size);
+    uint8_t read (int address);
+    void write (int address, uint8_t val);
+    bool commit (void);
+    void end (void);
+
+    uint8_t* getDataPtr (void);
+    size_t length (void) { return (Size); }
+
+    template <typename T> T& get (int address, T& t)
+    {
+        if ((address >= 0) && (address + sizeof (T) <= Size))
+            memcpy ((uint8_t*)&t, Data + address, sizeof (T));
+        return (t);
+    }
+
+    template <typename T> const T& put (int address, const T& t)
+    {
+        if ((address >= 0) && (address + sizeof (T) <= Size))
+        {
+            memcpy (Data + address, (const uint8_t*)&t, sizeof (T));
+            Dirty = true;
+        }
+        return (t);
+    }
+
+protected:
+    uint32_t Sector;
+    uint8_t* Data;
+    size_t Size;
+    bool Dirty;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,273 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ESP8266WiFi.h"
+#include "HostShim.h"
+
+#include <netdb.h>
+#include <arpa/inet.h>
+
+ESP8266WiFiClass WiFi;
+
+static bool AccessPointAvailable = true;
+static unsigned long ConnectDelayMs = 1500;
+static unsigned long FastConnectDelayMs = 300;
+static int32_t HostChannel = 6;
+
+// A join that will never complete
+static const unsigned long NeverMs = (unsigned long)-1;
+
+// The address the host pretends the access point hands out
+static const uint8_t HostBSSID[6] = {0x02, 0x00, 0x00, 0xc0, 0xff, 0xee};
+
+static HostRadioStats_t RadioStats;
+
+void HostWiFiSetAccessPointAvailable (bool available)
+{
+    WiFi.AccountRadioTime ();
+    AccessPointAvailable = available;
+}
+
+void HostWiFiGetRadioStats (HostRadioStats_t* stats)
+{
+    WiFi.AccountRadioTime ();
+    *stats = RadioStats;
+}
+
+void HostWiFiResetRadioStats (void)
+{
+    WiFi.AccountRadioTime ();
+    memset (&RadioStats, 0, sizeof (RadioStats));
+}
+
+void HostWiFiSetConnectDelay (unsigned long connectDelayMs)
+{
+    ConnectDelayMs = connectDelayMs;
+}
+
+void HostWiFiSetFastConnectDelay (unsigned long connectDelayMs)
+{
+    FastConnectDelayMs = connectDelayMs;
+}
+
+void HostWiFiSetChannel (int32_t channel)
+{
+    WiFi.AccountRadioTime ();
+    HostChannel = channel;
+}
+
+// ----------------------------------------------------------------------
+ESP8266WiFiClass::ESP8266WiFiClass (void)
+    : Mode (WIFI_STA), SleepType (WIFI_NONE_SLEEP), RadioAsleep (false), Joining (false),
+      StaticIP (false), BeginMillis (0), JoinDelayMs (0), RadioAccountedMicros (0)
+{
+}
+
+// ----------------------------------------------------------------------
+// Add the time since we last looked to whatever the radio was doing. A join
+// that has completed in the mean time is split at the moment it connected.
+void ESP8266WiFiClass::AccountRadioTime (void)
+{
+    unsigned long long now = micros ();
+    unsigned long long from = RadioAccountedMicros;
+
+    if ((Mode == WIFI_OFF) || RadioAsleep)
+    {
+        RadioStats.OffMicros += now - from;
+    }
+    else if (Joining == false)
+    {
+        RadioStats.IdleMicros += now - from;
+    }
+    else
+    {
+        unsigned long long connectedAt = ((unsigned long long)BeginMillis + JoinDelayMs) * 1000ULL;
+
+        if ((AccessPointAvailable == false) || (JoinDelayMs == NeverMs) || (now <= connectedAt))
+        {
+            RadioStats.JoiningMicros += now - from;
+        }
+        else
+        {
+            if (from < connectedAt)
+            {
+                RadioStats.JoiningMicros += connectedAt - from;
+                from = connectedAt;
+            }
+            RadioStats.ConnectedMicros += now - from;
+        }
+    }
+    RadioAccountedMicros = now;
+}
+
+// ----------------------------------------------------------------------
+wl_status_t ESP8266WiFiClass::begin (const char* ssid, const char* passphrase, int32_t channel,
+                                     const uint8_t* bssid, bool connect)
+{
+    (void)ssid; (void)passphrase;
+    AccountRadioTime ();
+
+    if (Mode == WIFI_OFF)
+        Mode = WIFI_STA;
+
+    Joining = connect;
+    BeginMillis = millis ();
+
+    // Told where the access point is - no scan, and no DHCP either if we have
+    // an address. If it isn't there any more the join never completes.
+    if ((bssid == NULL) || (channel <= 0))
+        JoinDelayMs = ConnectDelayMs;
+    else if ((memcmp (bssid, HostBSSID, sizeof (HostBSSID)) != 0) || (channel != HostChannel))
+        JoinDelayMs = NeverMs;
+    else
+        JoinDelayMs = StaticIP ? FastConnectDelayMs : ConnectDelayMs;
+
+    return (status ());
+}
+
+bool ESP8266WiFiClass::config (IPAddress localIP, IPAddress gateway, IPAddress subnet,
+                               IPAddress dns1, IPAddress dns2)
+{
+    (void)gateway; (void)subnet; (void)dns1; (void)dns2;
+
+    StaticIP = localIP.isSet ();
+    LocalIP = localIP;
+    return (true);
+}
+
+bool ESP8266WiFiClass::disconnect (bool wifiOff)
+{
+    AccountRadioTime ();
+    Joining = false;
+    if (wifiOff)
+        Mode = WIFI_OFF;
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+wl_status_t ESP8266WiFiClass::status (void)
+{
+    if ((Joining == false) || (Mode == WIFI_OFF) || RadioAsleep)
+        return (WL_DISCONNECTED);
+
+    if (AccessPointAvailable == false)
+        return (WL_DISCONNECTED);
+
+    if ((JoinDelayMs != NeverMs) && (millis () - BeginMillis >= JoinDelayMs))
+        return (WL_CONNECTED);
+
+    return (WL_DISCONNECTED);
+}
+
+// ----------------------------------------------------------------------
+bool ESP8266WiFiClass::mode (WiFiMode_t mode)
+{
+    AccountRadioTime ();
+    Mode = mode;
+    if (Mode == WIFI_OFF)
+        Joining = false;
+    return (true);
+}
+
+bool ESP8266WiFiClass::forceSleepBegin (uint32_t sleepUs)
+{
+    (void)sleepUs;
+
+    AccountRadioTime ();
+
+    RadioAsleep = true;
+    Joining = false;
+    return (true);
+}
+
+bool ESP8266WiFiClass::forceSleepWake (void)
+{
+    AccountRadioTime ();
+    RadioAsleep = false;
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+IPAddress ESP8266WiFiClass::localIP (void)
+{
+    if (status () != WL_CONNECTED)
+        return (IPAddress ());
+    return (StaticIP ? LocalIP : IPAddress (192, 168, 4, 100));
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP (void)
+{
+    return ((status () == WL_CONNECTED) ? IPAddress (192, 168, 4, 1) : IPAddress ());
+}
+
+IPAddress ESP8266WiFiClass::subnetMask (void)
+{
+    return ((status () == WL_CONNECTED) ? IPAddress (255, 255, 255, 0) : IPAddress ());
+}
+
+IPAddress ESP8266WiFiClass::dnsIP (uint8_t dnsNo)
+{
+    return (((status () == WL_CONNECTED) && (dnsNo == 0)) ? IPAddress (192, 168, 4, 1) : IPAddress ());
+}
+
+uint8_t* ESP8266WiFiClass::BSSID (void)
+{
+    static uint8_t bssid[6];
+    memcpy (bssid, HostBSSID, sizeof (bssid));
+    return (bssid);
+}
+
+int32_t ESP8266WiFiClass::channel (void)
+{
+    return (HostChannel);
+}
+
+int32_t ESP8266WiFiClass::RSSI (void)
+{
+    return ((status () == WL_CONNECTED) ? -60 : 31);
+}
+
+// ----------------------------------------------------------------------
+int ESP8266WiFiClass::hostByName (const char* hostName, IPAddress& result)
+{
+    struct addrinfo hints;
+    struct addrinfo* found = NULL;
+
+    if (HostWiFiRedirectAddress (&result))
+        return (1);
+
+    memset (&hints, 0, sizeof (hints));
+    hints.ai_family = AF_INET;
+
+    if (getaddrinfo (hostName, NULL, &hints, &found) != 0)
+        return (0);
+
+    result = IPAddress ((uint32_t)((struct sockaddr_in*)found->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo (found);
+    return (1);
+}
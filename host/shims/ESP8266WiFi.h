@@ -0,0 +1,116 @@
+#ifndef _HOST_ESP8266WIFI_H
+#define _HOST_ESP8266WIFI_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+typedef enum
+{
+    WL_NO_SHIELD       = 255,
+    WL_IDLE_STATUS     = 0,
+    WL_NO_SSID_AVAIL   = 1,
+    WL_SCAN_COMPLETED  = 2,
+    WL_CONNECTED       = 3,
+    WL_CONNECT_FAILED  = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED    = 6
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_OFF    = 0,
+    WIFI_STA    = 1,
+    WIFI_AP     = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum
+{
+    WIFI_NONE_SLEEP  = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+// Station side of the ESP8266 wifi interface. The host has no radio - see
+// HostShim.h for how connection attempts are made to succeed or fail.
+class ESP8266WiFiClass
+{
+public:
+    ESP8266WiFiClass (void);
+
+    wl_status_t begin (const char* ssid, const char* passphrase = NULL, int32_t channel = 0,
+                       const uint8_t* bssid = NULL, bool connect = true);
+    bool config (IPAddress localIP, IPAddress gateway, IPAddress subnet,
+                 IPAddress dns1 = (uint32_t)0, IPAddress dns2 = (uint32_t)0);
+    bool disconnect (bool wifiOff = false);
+    wl_status_t status (void);
+
+    bool mode (WiFiMode_t mode);
+    WiFiMode_t getMode (void) { return (Mode); }
+
+    bool forceSleepBegin (uint32_t sleepUs = 0);
+    bool forceSleepWake (void);
+    bool setSleepMode (WiFiSleepType_t type) { SleepType = type; return (true); }
+    WiFiSleepType_t getSleepMode (void) { return (SleepType); }
+
+    bool persistent (bool persistent) { (void)persistent; return (true); }
+    bool setAutoConnect (bool autoConnect) { (void)autoConnect; return (true); }
+    bool setAutoReconnect (bool autoReconnect) { (void)autoReconnect; return (true); }
+
+    IPAddress localIP (void);
+    IPAddress gatewayIP (void);
+    IPAddress subnetMask (void);
+    IPAddress dnsIP (uint8_t dnsNo = 0);
+    uint8_t* BSSID (void);
+    int32_t channel (void);
+    int32_t RSSI (void);
+
+    int hostByName (const char* hostName, IPAddress& result);
+
+    // Bring the radio time accounting behind HostWiFiGetRadioStats() up to now
+    void AccountRadioTime (void);
+
+protected:
+    WiFiMode_t Mode;
+    WiFiSleepType_t SleepType;
+    bool RadioAsleep;
+    bool Joining;
+    bool StaticIP;
+    unsigned long BeginMillis;
+    unsigned long JoinDelayMs;
+    IPAddress LocalIP;
+    unsigned long long RadioAccountedMicros;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
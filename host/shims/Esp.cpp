@@ -0,0 +1,202 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "HostShim.h"
+
+#include <time.h>
+
+EspClass ESP;
+
+static unsigned long RestartCount = 0;
+
+// The host starts as a board does from power on - reset reason 0 and RTC memory
+// holding whatever it powered up with
+static struct rst_info ResetInfo;
+static uint32_t RtcUserMemory[512 / sizeof (uint32_t)];
+static bool RtcPoweredUp = false;
+
+static void PowerUpRtc (void)
+{
+    // Its own generator, so random() isn't disturbed
+    uint32_t noise = (uint32_t)time (NULL) | 1;
+    for (size_t i = 0; i < sizeof (RtcUserMemory) / sizeof (RtcUserMemory[0]); i++)
+    {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+        RtcUserMemory[i] = noise;
+    }
+    RtcPoweredUp = true;
+}
+
+// The flash starts out erased, as it would be on a new board
+static uint8_t* FlashContents (void)
+{
+    static uint8_t* theFlash = NULL;
+
+    if (theFlash == NULL)
+    {
+        theFlash = (uint8_t*)malloc (HOST_FLASH_SIZE);
+        memset (theFlash, 0xff, HOST_FLASH_SIZE);
+    }
+    return (theFlash);
+}
+
+static HostFlashStats_t FlashStats;
+
+// ----------------------------------------------------------------------
+void EspClass::restart (void)
+{
+    RestartCount++;
+    memset (&ResetInfo, 0, sizeof (ResetInfo));
+    ResetInfo.reason = REASON_SOFT_RESTART;
+}
+
+struct rst_info* EspClass::getResetInfoPtr (void)
+{
+    return (&ResetInfo);
+}
+
+void HostSetResetInfo (uint32_t reason, uint32_t exccause, uint32_t epc1)
+{
+    memset (&ResetInfo, 0, sizeof (ResetInfo));
+    ResetInfo.reason = reason;
+    ResetInfo.exccause = exccause;
+    ResetInfo.epc1 = epc1;
+}
+
+// ----------------------------------------------------------------------
+bool EspClass::rtcUserMemoryRead (uint32_t offset, uint32_t* data, size_t size)
+{
+    if ((offset * 4 + size > sizeof (RtcUserMemory)) || (size == 0))
+        return (false);
+
+    if (RtcPoweredUp == false)
+        PowerUpRtc ();
+    memcpy (data, (uint8_t*)RtcUserMemory + offset * 4, size);
+    return (true);
+}
+
+bool EspClass::rtcUserMemoryWrite (uint32_t offset, uint32_t* data, size_t size)
+{
+    if ((offset * 4 + size > sizeof (RtcUserMemory)) || (size == 0))
+        return (false);
+
+    if (RtcPoweredUp == false)
+        PowerUpRtc ();
+    memcpy ((uint8_t*)RtcUserMemory + offset * 4, data, size);
+    return (true);
+}
+
+void HostRtcPowerCycle (void)
+{
+    PowerUpRtc ();
+    HostSetResetInfo (REASON_DEFAULT_RST, 0, 0);
+}
+
+unsigned long HostRestartCount (void)
+{
+    return (RestartCount);
+}
+
+// The host has no meaningful equivalent of these. Report what a NodeMCU
+// typically shows once the sketch is running.
+uint32_t EspClass::getFreeHeap (void)         { return (45000); }
+uint16_t EspClass::getMaxFreeBlockSize (void) { return (40000); }
+uint8_t EspClass::getHeapFragmentation (void) { return (10); }
+uint32_t EspClass::getChipId (void)           { return (0x00c0ffee); }
+uint32_t EspClass::getFlashChipSize (void)    { return (HOST_FLASH_SIZE); }
+
+// The ESP8266 runs at 80 MHz
+uint32_t EspClass::getCycleCount (void)
+{
+    return ((uint32_t)micros () * 80);
+}
+
+// ----------------------------------------------------------------------
+bool EspClass::flashEraseSector (uint32_t sector)
+{
+    if (sector >= (HOST_FLASH_SIZE / SPI_FLASH_SEC_SIZE))
+        return (false);
+
+    memset (FlashContents () + sector * SPI_FLASH_SEC_SIZE, 0xff, SPI_FLASH_SEC_SIZE);
+    FlashStats.SectorErases++;
+    return (true);
+}
+
+bool EspClass::flashWrite (uint32_t offset, uint32_t* data, size_t size)
+{
+    if (((offset | size) & 3) || (offset + size > HOST_FLASH_SIZE))
+        return (false);
+
+    // NOR flash - programming can only clear bits
+    uint8_t* dest = FlashContents () + offset;
+    const uint8_t* src = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+        dest[i] &= src[i];
+
+    FlashStats.Writes++;
+    FlashStats.BytesWritten += size;
+    return (true);
+}
+
+bool EspClass::flashRead (uint32_t offset, uint32_t* data, size_t size)
+{
+    if (((offset | size) & 3) || (offset + size > HOST_FLASH_SIZE))
+        return (false);
+
+    memcpy (data, FlashContents () + offset, size);
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+void HostFlashGetStats (HostFlashStats_t* stats)
+{
+    *stats = FlashStats;
+}
+
+void HostFlashResetStats (void)
+{
+    memset (&FlashStats, 0, sizeof (FlashStats));
+}
+
+void HostFlashEraseAll (void)
+{
+    memset (FlashContents (), 0xff, HOST_FLASH_SIZE);
+}
+
+uint8_t* HostFlashData (void)
+{
+    return (FlashContents ());
+}
+
+uint32_t HostFlashSize (void)
+{
+    return (HOST_FLASH_SIZE);
+}
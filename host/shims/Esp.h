@@ -0,0 +1,105 @@
+#ifndef _HOST_ESP_H
+#define _HOST_ESP_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Size of a flash sector, as in spi_flash.h
+#define SPI_FLASH_SEC_SIZE 4096
+
+// The host flash is laid out like a 4 MB NodeMCU. The emulated EEPROM lives in
+// the sector below the four the SDK keeps for RF calibration and wifi settings.
+#define HOST_FLASH_SIZE     (4 * 1024 * 1024)
+#define HOST_EEPROM_SECTOR  ((HOST_FLASH_SIZE / SPI_FLASH_SEC_SIZE) - 5)
+
+// The file system sectors, start inclusive and end exclusive. Like the core's
+// "FS:none" layouts there isn't one - it's empty, just below the EEPROM. Define
+// these on the command line to try a layout with one.
+#ifndef HOST_FS_START_SECTOR
+#define HOST_FS_START_SECTOR HOST_EEPROM_SECTOR
+#define HOST_FS_END_SECTOR   HOST_EEPROM_SECTOR
+#endif
+
+// Why the chip last started, as in user_interface.h
+enum rst_reason
+{
+    REASON_DEFAULT_RST = 0,       // Power on
+    REASON_WDT_RST = 1,           // Hardware watchdog
+    REASON_EXCEPTION_RST = 2,     // Exception - exccause and the epc registers are valid
+    REASON_SOFT_WDT_RST = 3,      // Software watchdog
+    REASON_SOFT_RESTART = 4,      // ESP.restart()
+    REASON_DEEP_SLEEP_AWAKE = 5,
+    REASON_EXT_SYS_RST = 6        // Reset pin
+};
+
+struct rst_info
+{
+    uint32_t reason;
+    uint32_t exccause;
+    uint32_t epc1;
+    uint32_t epc2;
+    uint32_t epc3;
+    uint32_t excvaddr;
+    uint32_t depc;
+};
+
+// Stand-in for the ESP8266 core's ESP object
+class EspClass
+{
+public:
+    // Does not return on the board. On the host it just counts the request
+    // (see HostRestartCount()) and returns.
+    void restart (void);
+
+    // Why the chip last started
+    struct rst_info* getResetInfoPtr (void);
+
+    uint32_t getFreeHeap (void);
+    uint16_t getMaxFreeBlockSize (void);
+    uint8_t getHeapFragmentation (void);
+    uint32_t getChipId (void);
+    uint32_t getCycleCount (void);
+    uint32_t getFlashChipSize (void);
+
+    // Raw flash access. Offsets and sizes must be multiples of 4, as on the board.
+    bool flashEraseSector (uint32_t sector);
+    bool flashWrite (uint32_t offset, uint32_t* data, size_t size);
+    bool flashRead (uint32_t offset, uint32_t* data, size_t size);
+
+    // The 512 bytes of RTC memory the SDK leaves to the user, which survive
+    // everything but a power cut. Offsets are in 4 byte blocks, as on the board.
+    bool rtcUserMemoryRead (uint32_t offset, uint32_t* data, size_t size);
+    bool rtcUserMemoryWrite (uint32_t offset, uint32_t* data, size_t size);
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,149 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Counts what the program asks of the heap. The replacements for new and
+// delete below are used by everything linked with the shims, and String's
+// buffers come through HostHeapRealloc(). Counters are updated atomically so
+// benchmarks that run threads still get exact figures.
+
+#include "HostShim.h"
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static HostHeapStats_t HeapStats;
+static bool HeapTrap = false;
+
+// ----------------------------------------------------------------------
+static void CountAllocation (size_t size)
+{
+    if (__atomic_load_n (&HeapTrap, __ATOMIC_RELAXED))
+    {
+        fprintf (stderr, "Heap allocation of %zu bytes while trapped\n", size);
+        abort ();
+    }
+
+    __atomic_add_fetch (&HeapStats.Allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&HeapStats.Bytes, size, __ATOMIC_RELAXED);
+}
+
+static void CountFree (void)
+{
+    __atomic_add_fetch (&HeapStats.Frees, 1, __ATOMIC_RELAXED);
+}
+
+void HostHeapGetStats (HostHeapStats_t* stats)
+{
+    stats->Allocations = __atomic_load_n (&HeapStats.Allocations, __ATOMIC_RELAXED);
+    stats->Frees = __atomic_load_n (&HeapStats.Frees, __ATOMIC_RELAXED);
+    stats->Bytes = __atomic_load_n (&HeapStats.Bytes, __ATOMIC_RELAXED);
+}
+
+void HostHeapResetStats (void)
+{
+    __atomic_store_n (&HeapStats.Allocations, 0, __ATOMIC_RELAXED);
+    __atomic_store_n (&HeapStats.Frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n (&HeapStats.Bytes, 0, __ATOMIC_RELAXED);
+}
+
+void HostHeapSetTrap (bool trap)
+{
+    __atomic_store_n (&HeapTrap, trap, __ATOMIC_RELAXED);
+}
+
+// ----------------------------------------------------------------------
+void* HostHeapRealloc (void* buffer, size_t size)
+{
+    void* returnValue = realloc (buffer, size);
+
+    if (returnValue != NULL)
+        CountAllocation (size);
+    return (returnValue);
+}
+
+void HostHeapFree (void* buffer)
+{
+    if (buffer != NULL)
+    {
+        CountFree ();
+        free (buffer);
+    }
+}
+
+// ----------------------------------------------------------------------
+void* operator new (size_t size)
+{
+    void* returnValue = malloc ((size > 0) ? size : 1);
+
+    if (returnValue == NULL)
+        throw std::bad_alloc ();
+
+    CountAllocation (size);
+    return (returnValue);
+}
+
+void* operator new[] (size_t size)
+{
+    return (operator new (size));
+}
+
+void* operator new (size_t size, const std::nothrow_t&) noexcept
+{
+    void* returnValue = malloc ((size > 0) ? size : 1);
+
+    if (returnValue != NULL)
+        CountAllocation (size);
+    return (returnValue);
+}
+
+void* operator new[] (size_t size, const std::nothrow_t& tag) noexcept
+{
+    return (operator new (size, tag));
+}
+
+void operator delete (void* buffer) noexcept
+{
+    HostHeapFree (buffer);
+}
+
+void operator delete[] (void* buffer) noexcept
+{
+    HostHeapFree (buffer);
+}
+
+void operator delete (void* buffer, size_t) noexcept
+{
+    HostHeapFree (buffer);
+}
+
+void operator delete[] (void* buffer, size_t) noexcept
+{
+    HostHeapFree (buffer);
+}
@@ -0,0 +1,190 @@
+#ifndef _HOST_SHIM_H
+#define _HOST_SHIM_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Controls for the host shims that have no equivalent on the board. Only host
+// programs (benchmarks and tools) include this - the libraries never do.
+
+#include <stdint.h>
+#include <stddef.h>
+
+class IPAddress;
+
+// ---------------------------------------------------------------------------
+// Clock. By default millis()/micros() follow the real monotonic clock. In
+// simulated mode time only moves when delay() is called or the host advances
+// it, which lets a program replay minutes of board time in milliseconds.
+void HostUseSimulatedClock (bool simulated);
+void HostAdvanceMicros (unsigned long long us);
+inline void HostAdvanceMillis (unsigned long ms) { HostAdvanceMicros ((unsigned long long)ms * 1000ULL); }
+
+// Run any Ticker callbacks that have come due. Called from delay(), yield()
+// and HostAdvanceMicros(), so most programs never need to call it directly.
+void HostServiceTickers (void);
+
+// Run the lwIP callbacks - finished handshakes, data that has arrived, lookups
+// that have been answered - for the calling thread's connections. Called from
+// delay() and yield(), as lwIP runs on the board, so a program that drives
+// senders without either must call yield() between passes.
+void HostServiceNetwork (void);
+
+// ---------------------------------------------------------------------------
+// Serial port
+void HostSerialFeed (const char* data, size_t len);
+void HostSerialFeed (const char* str);
+
+// When disabled, Serial output is counted but not written to stdout
+void HostSerialSetOutputEnabled (bool enabled);
+unsigned long long HostSerialBytesWritten (void);
+
+// Model the UART at baud: a 128 byte transmit FIFO that empties a character
+// time (ten bits) at a time. A write that finds it full waits for room, as
+// on the board, and availableForWrite() reports the room left. Meant for the
+// simulated clock, where the wait just moves time on. 0 - the default - turns
+// the model off and output takes no time at all.
+void HostSerialSetBaud (unsigned long baud);
+
+// ---------------------------------------------------------------------------
+// Number of times ESP.restart() has been called
+unsigned long HostRestartCount (void);
+
+// What ESP.getResetInfoPtr() reports, as if the board had just come back from
+// that kind of reset. ESP.restart() sets REASON_SOFT_RESTART.
+void HostSetResetInfo (uint32_t reason, uint32_t exccause, uint32_t epc1);
+
+// Lose the RTC user memory, filling it with noise, and report a power on reset
+void HostRtcPowerCycle (void);
+
+// Current level of an output pin, as last set by digitalWrite()
+int HostPinLevel (uint8_t pin);
+
+// ---------------------------------------------------------------------------
+// Flash. The host keeps a RAM copy of a 4 MB SPI flash with NOR semantics -
+// erase sets a sector to 0xff and writes can only clear bits.
+typedef struct
+{
+    unsigned long SectorErases;
+    unsigned long Writes;
+    unsigned long BytesWritten;
+} HostFlashStats_t;
+
+void HostFlashGetStats (HostFlashStats_t* stats);
+void HostFlashResetStats (void);
+
+// Erase the whole flash, as happens when a board is fully erased before programming
+void HostFlashEraseAll (void);
+
+// Direct access to the flash contents, for tools that build flash images
+uint8_t* HostFlashData (void);
+uint32_t HostFlashSize (void);
+
+// ---------------------------------------------------------------------------
+// Wifi. WiFi.begin() succeeds connectDelayMs after it is called if the access
+// point is available, otherwise the status stays at WL_DISCONNECTED. Given the
+// access point's BSSID and channel and a static address from WiFi.config() it
+// skips the scan and DHCP, and succeeds after the fast connect delay instead -
+// unless the access point has since moved to another channel, in which case it
+// never does.
+void HostWiFiSetAccessPointAvailable (bool available);
+void HostWiFiSetConnectDelay (unsigned long connectDelayMs);
+void HostWiFiSetFastConnectDelay (unsigned long connectDelayMs);
+void HostWiFiSetChannel (int32_t channel);
+
+// Radio power. Time is split by what the radio was doing, so host programs can
+// work out its duty cycle. "Idle" is powered but neither joining nor connected.
+typedef struct
+{
+    unsigned long long OffMicros;
+    unsigned long long IdleMicros;
+    unsigned long long JoiningMicros;
+    unsigned long long ConnectedMicros;
+} HostRadioStats_t;
+
+void HostWiFiGetRadioStats (HostRadioStats_t* stats);
+void HostWiFiResetRadioStats (void);
+
+// Send every WiFiClient connection to host:port instead of the name the
+// library asked for - used to point the IFTTT code at a local stand-in.
+void HostWiFiSetConnectRedirect (const char* host, uint16_t port);
+
+// For the shims' own use - fill in the address, and the port if asked for,
+// that connections are being redirected to. Returns false if they aren't.
+// WiFi.hostByName() and dns_gethostbyname() answer with it, so a name looked
+// up before connecting needn't exist.
+bool HostWiFiRedirectAddress (IPAddress* address, uint16_t* port = NULL);
+
+// TCP clients. Every WiFiClient write or tcp_write() that hands data to the
+// stack is counted. With Nagle off, as the firmware runs it, lwIP puts each
+// of those in at least one segment of its own.
+typedef struct
+{
+    unsigned long long Writes;
+    unsigned long long Bytes;
+} HostClientStats_t;
+
+void HostWiFiClientGetStats (HostClientStats_t* stats);
+void HostWiFiClientResetStats (void);
+
+// For the shims' own use - count a write of bytes
+void HostWiFiClientCountWrite (size_t bytes);
+
+// UDP. Every datagram WiFiUDP::endPacket() hands to the stack is counted.
+typedef struct
+{
+    unsigned long long Datagrams;
+    unsigned long long Bytes;
+} HostUdpStats_t;
+
+void HostWiFiUdpGetStats (HostUdpStats_t* stats);
+void HostWiFiUdpResetStats (void);
+
+// ---------------------------------------------------------------------------
+// Heap. Everything allocated with new, and String's buffers, are counted, so
+// a program can see what a piece of library code costs the board's heap.
+typedef struct
+{
+    unsigned long long Allocations;     // Including a realloc() that grows a buffer
+    unsigned long long Frees;
+    unsigned long long Bytes;           // Total asked for
+} HostHeapStats_t;
+
+void HostHeapGetStats (HostHeapStats_t* stats);
+void HostHeapResetStats (void);
+
+// When set, the next allocation prints its size and calls abort(), so a
+// debugger stops in the code that asked for it. For finding what breaks a
+// heap-free stretch of code.
+void HostHeapSetTrap (bool trap);
+
+// The allocator behind the counts, for the shims' own use
+void* HostHeapRealloc (void* buffer, size_t size);
+void HostHeapFree (void* buffer);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _HOST_IPADDRESS_H
+#define _HOST_IPADDRESS_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+
+// IPv4 address. As on the board, the uint32_t form is in network byte order,
+// so the first octet is the least significant byte.
+class IPAddress
+{
+public:
+    IPAddress (void) { Address.Dword = 0; }
+    IPAddress (uint8_t first, uint8_t second, uint8_t third, uint8_t fourth)
+    {
+        Address.Bytes[0] = first; Address.Bytes[1] = second;
+        Address.Bytes[2] = third; Address.Bytes[3] = fourth;
+    }
+    IPAddress (uint32_t address) { Address.Dword = address; }
+
+    operator uint32_t (void) const { return (Address.Dword); }
+    uint8_t operator[] (int index) const { return (Address.Bytes[index]); }
+    uint8_t& operator[] (int index) { return (Address.Bytes[index]); }
+
+    bool isSet (void) const { return (Address.Dword != 0); }
+
+    // Parse a dotted quad. Returns false if the string isn't one.
+    bool fromString (const char* address)
+    {
+        unsigned int a, b, c, d;
+        char extra;
+        if ((sscanf (address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4) ||
+            (a > 255) || (b > 255) || (c > 255) || (d > 255))
+            return (false);
+        *this = IPAddress (a, b, c, d);
+        return (true);
+    }
+
+    String toString (void) const
+    {
+        char buf[16];
+        snprintf (buf, sizeof (buf), "%u.%u.%u.%u", Address.Bytes[0], Address.Bytes[1],
+                  Address.Bytes[2], Address.Bytes[3]);
+        return (String (buf));
+    }
+
+protected:
+    union
+    {
+        uint8_t Bytes[4];
+        uint32_t Dword;
+    } Address;
+};
+
+#endif
@@ -0,0 +1,366 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "lwip/dns.h"
+#include "lwip/tcp.h"
+
+#include "ESP8266WiFi.h"
+#include "HostShim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// What lwIP on the board gives a connection to send with - two segments
+static const u16_t SendBufferLen = 2 * 1460;
+
+// A connection, from tcp_new() until it's closed, aborted or fails
+struct tcp_pcb
+{
+    bool InUse;
+    enum { PCB_CLOSED, PCB_SYN_SENT, PCB_ESTABLISHED, PCB_CLOSE_WAIT } State;
+    int Socket;
+    err_t PendingError;         // A connect that failed at once, reported on the next pass
+    bool NoDelay;
+    void* Arg;
+    tcp_connected_fn Connected;
+    tcp_recv_fn Recv;
+    tcp_err_fn Err;
+};
+
+// A lookup whose answer hasn't been handed back yet
+typedef struct
+{
+    bool InUse;
+    const char* Name;
+    bool Found;
+    ip_addr_t Address;
+    dns_found_callback Callback;
+    void* Arg;
+} Lookup_t;
+
+// Enough connections for a thread of CRSCCollectorLoad senders, and lookups for
+// each. Per thread, so each thread's yield() only calls its own back.
+static const unsigned MaxPcbs = 64;
+static thread_local struct tcp_pcb Pcbs[MaxPcbs];
+static thread_local Lookup_t Lookups[MaxPcbs];
+
+// ----------------------------------------------------------------------
+// Free a connection. Its callbacks aren't called.
+static void FreePcb (struct tcp_pcb* pcb)
+{
+    if (pcb->Socket >= 0)
+        close (pcb->Socket);
+
+    pcb->Socket = -1;
+    pcb->InUse = false;
+}
+
+// Free a connection that has failed, then tell its owner, as lwIP does
+static void FailPcb (struct tcp_pcb* pcb, err_t err)
+{
+    tcp_err_fn errorCallback = pcb->Err;
+    void* arg = pcb->Arg;
+
+    FreePcb (pcb);
+    if (errorCallback != NULL)
+        errorCallback (arg, err);
+}
+
+// ----------------------------------------------------------------------
+// Move one connection along - finish its handshake, or hand over what has arrived
+static void ServicePcb (struct tcp_pcb* pcb)
+{
+    if (pcb->State == tcp_pcb::PCB_SYN_SENT)
+    {
+        struct pollfd waiting = { pcb->Socket, POLLOUT, 0 };
+        int socketError = 0;
+        socklen_t length = sizeof (socketError);
+
+        if (pcb->PendingError != ERR_OK)
+        {
+            FailPcb (pcb, pcb->PendingError);
+        }
+        else if (poll (&waiting, 1, 0) > 0)
+        {
+            // The handshake is over one way or the other. A refusal comes back
+            // as a reset, as it does on the board.
+            getsockopt (pcb->Socket, SOL_SOCKET, SO_ERROR, &socketError, &length);
+            if (socketError != 0)
+            {
+                FailPcb (pcb, ERR_RST);
+            }
+            else
+            {
+                pcb->State = tcp_pcb::PCB_ESTABLISHED;
+                if (pcb->Connected != NULL)
+                    pcb->Connected (pcb->Arg, pcb, ERR_OK);
+            }
+        }
+    }
+    else if (pcb->State == tcp_pcb::PCB_ESTABLISHED)
+    {
+        uint8_t buffer[536];
+        ssize_t n = recv (pcb->Socket, buffer, sizeof (buffer), MSG_DONTWAIT);
+
+        if (n > 0)
+        {
+            struct pbuf data = { NULL, buffer, (u16_t)n, (u16_t)n };
+            if (pcb->Recv != NULL)
+                pcb->Recv (pcb->Arg, pcb, &data, ERR_OK);
+        }
+        else if (n == 0)
+        {
+            // The other end has closed. lwIP says so with an empty receive.
+            pcb->State = tcp_pcb::PCB_CLOSE_WAIT;
+            if (pcb->Recv != NULL)
+                pcb->Recv (pcb->Arg, pcb, NULL, ERR_OK);
+        }
+        else if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            FailPcb (pcb, ERR_RST);
+        }
+    }
+}
+
+// Call this thread's connections and lookups back with whatever has happened
+// since the last pass. Callbacks may close or open connections as they go.
+void HostServiceNetwork (void)
+{
+    for (unsigned i = 0; i < MaxPcbs; i++)
+    {
+        if (Lookups[i].InUse)
+        {
+            Lookups[i].InUse = false;
+            Lookups[i].Callback (Lookups[i].Name, Lookups[i].Found ? &Lookups[i].Address : NULL, Lookups[i].Arg);
+        }
+    }
+
+    for (unsigned i = 0; i < MaxPcbs; i++)
+    {
+        if (Pcbs[i].InUse)
+            ServicePcb (&Pcbs[i]);
+    }
+}
+
+// ----------------------------------------------------------------------
+struct tcp_pcb* tcp_new (void)
+{
+    for (unsigned i = 0; i < MaxPcbs; i++)
+    {
+        if (Pcbs[i].InUse == false)
+        {
+            memset (&Pcbs[i], 0, sizeof (Pcbs[i]));
+            Pcbs[i].InUse = true;
+            Pcbs[i].State = tcp_pcb::PCB_CLOSED;
+            Pcbs[i].Socket = -1;
+            return (&Pcbs[i]);
+        }
+    }
+    return (NULL);
+}
+
+void tcp_arg (struct tcp_pcb* pcb, void* arg)
+{
+    pcb->Arg = arg;
+}
+
+void tcp_recv (struct tcp_pcb* pcb, tcp_recv_fn recv)
+{
+    pcb->Recv = recv;
+}
+
+void tcp_err (struct tcp_pcb* pcb, tcp_err_fn err)
+{
+    pcb->Err = err;
+}
+
+void tcp_nagle_disable (struct tcp_pcb* pcb)
+{
+    int flag = 1;
+
+    pcb->NoDelay = true;
+    if (pcb->Socket >= 0)
+        setsockopt (pcb->Socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof (flag));
+}
+
+// ----------------------------------------------------------------------
+// Start the handshake. A redirect applies here as it does to WiFiClient.
+err_t tcp_connect (struct tcp_pcb* pcb, const ip_addr_t* ipaddr, u16_t port, tcp_connected_fn connected)
+{
+    IPAddress ip (ip_addr_get_ip4_u32 (ipaddr));
+    struct sockaddr_in address;
+
+    if (pcb->State != tcp_pcb::PCB_CLOSED)
+        return (ERR_ISCONN);
+
+    // No route anywhere without the access point
+    if (WiFi.status () != WL_CONNECTED)
+        return (ERR_RTE);
+
+    HostWiFiRedirectAddress (&ip, &port);
+
+    pcb->Socket = socket (AF_INET, SOCK_STREAM, 0);
+    if (pcb->Socket < 0)
+        return (ERR_MEM);
+
+    fcntl (pcb->Socket, F_SETFL, fcntl (pcb->Socket, F_GETFL) | O_NONBLOCK);
+    if (pcb->NoDelay)
+        tcp_nagle_disable (pcb);
+
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons (port);
+    address.sin_addr.s_addr = (uint32_t)ip;
+
+    // Even a handshake that's over at once is reported on the next pass, as
+    // lwIP never calls back from inside tcp_connect()
+    if ((::connect (pcb->Socket, (struct sockaddr*)&address, sizeof (address)) != 0) && (errno != EINPROGRESS))
+        pcb->PendingError = ERR_RST;
+
+    pcb->Connected = connected;
+    pcb->State = tcp_pcb::PCB_SYN_SENT;
+    return (ERR_OK);
+}
+
+// ----------------------------------------------------------------------
+// Each write that gets through is counted as one of WiFiClient's would be
+err_t tcp_write (struct tcp_pcb* pcb, const void* dataptr, u16_t len, u8_t apiflags)
+{
+    (void)apiflags;
+
+    if (pcb->State != tcp_pcb::PCB_ESTABLISHED)
+        return (ERR_CONN);
+
+    if (send (pcb->Socket, dataptr, len, MSG_NOSIGNAL | MSG_DONTWAIT) != (ssize_t)len)
+        return (ERR_MEM);
+
+    HostWiFiClientCountWrite (len);
+    return (ERR_OK);
+}
+
+err_t tcp_output (struct tcp_pcb* pcb)
+{
+    (void)pcb;
+    return (ERR_OK);
+}
+
+u16_t tcp_sndbuf (const struct tcp_pcb* pcb)
+{
+    return ((pcb->State == tcp_pcb::PCB_ESTABLISHED) ? SendBufferLen : 0);
+}
+
+void tcp_recved (struct tcp_pcb* pcb, u16_t len)
+{
+    (void)pcb;
+    (void)len;
+}
+
+err_t tcp_close (struct tcp_pcb* pcb)
+{
+    FreePcb (pcb);
+    return (ERR_OK);
+}
+
+void tcp_abort (struct tcp_pcb* pcb)
+{
+    FailPcb (pcb, ERR_ABRT);
+}
+
+// ----------------------------------------------------------------------
+u8_t pbuf_free (struct pbuf* p)
+{
+    (void)p;
+    return (1);
+}
+
+u8_t pbuf_get_at (const struct pbuf* p, u16_t offset)
+{
+    return ((offset < p->len) ? ((const u8_t*)p->payload)[offset] : 0);
+}
+
+u16_t pbuf_copy_partial (const struct pbuf* p, void* dataptr, u16_t len, u16_t offset)
+{
+    if (offset >= p->len)
+        return (0);
+
+    if (len > p->len - offset)
+        len = p->len - offset;
+
+    memcpy (dataptr, (const u8_t*)p->payload + offset, len);
+    return (len);
+}
+
+// ----------------------------------------------------------------------
+// The host resolver answers at once, but the answer is held for the next
+// pass, as lwIP's would be
+err_t dns_gethostbyname (const char* hostname, ip_addr_t* addr, dns_found_callback found, void* callback_arg)
+{
+    IPAddress ip;
+    struct addrinfo hints;
+    struct addrinfo* answer = NULL;
+
+    if (ip.fromString (hostname))
+    {
+        ip_addr_set_ip4_u32 (addr, (uint32_t)ip);
+        return (ERR_OK);
+    }
+
+    for (unsigned i = 0; i < MaxPcbs; i++)
+    {
+        if (Lookups[i].InUse == false)
+        {
+            Lookups[i].InUse = true;
+            Lookups[i].Name = hostname;
+            Lookups[i].Callback = found;
+            Lookups[i].Arg = callback_arg;
+
+            memset (&hints, 0, sizeof (hints));
+            hints.ai_family = AF_INET;
+
+            Lookups[i].Found = HostWiFiRedirectAddress (&ip);
+            if ((Lookups[i].Found == false) && (getaddrinfo (hostname, NULL, &hints, &answer) == 0))
+            {
+                ip = IPAddress ((uint32_t)((struct sockaddr_in*)answer->ai_addr)->sin_addr.s_addr);
+                Lookups[i].Found = true;
+                freeaddrinfo (answer);
+            }
+            ip_addr_set_ip4_u32 (&Lookups[i].Address, (uint32_t)ip);
+            return (ERR_INPROGRESS);
+        }
+    }
+
+    // lwIP's table of lookups is full
+    return (ERR_MEM);
+}
@@ -0,0 +1,153 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Ticker.h"
+#include "HostShim.h"
+
+static Ticker* ArmedTickers = NULL;
+static unsigned long TickerCallbacksRun = 0;
+
+// ----------------------------------------------------------------------
+Ticker::Ticker (void)
+    : Callback (NULL), Arg (NULL), PeriodMicros (0), NextFireMicros (0),
+      Repeat (false), Active (false), Next (NULL)
+{
+}
+
+Ticker::~Ticker (void)
+{
+    detach ();
+}
+
+// ----------------------------------------------------------------------
+void Ticker::Arm (unsigned long periodMicros, bool repeat, callback_with_arg_t callback, void* arg)
+{
+    detach ();
+
+    Callback = callback;
+    Arg = arg;
+    PeriodMicros = (periodMicros == 0) ? 1 : periodMicros;
+    NextFireMicros = micros () + PeriodMicros;
+    Repeat = repeat;
+    Active = true;
+
+    Next = ArmedTickers;
+    ArmedTickers = this;
+}
+
+// ----------------------------------------------------------------------
+void Ticker::detach (void)
+{
+    if (Active == false)
+        return;
+
+    for (Ticker** link = &ArmedTickers; *link != NULL; link = &(*link)->Next)
+    {
+        if (*link == this)
+        {
+            *link = Next;
+            break;
+        }
+    }
+    Next = NULL;
+    Active = false;
+}
+
+// ----------------------------------------------------------------------
+unsigned long Ticker::FiredCount (void)
+{
+    return (TickerCallbacksRun);
+}
+
+// ----------------------------------------------------------------------
+// Fire the earliest due ticker, one at a time, until none are due. Callbacks
+// may detach or re-arm any ticker, so the list is rescanned after each one.
+void Ticker::Service (void)
+{
+    static bool inService = false;
+
+    if (inService)
+        return;
+    inService = true;
+
+    bool fired = true;
+    while (fired)
+    {
+        fired = false;
+        unsigned long now = micros ();
+
+        Ticker* earliest = NULL;
+        for (Ticker* t = ArmedTickers; t != NULL; t = t->Next)
+        {
+            if ((long)(now - t->NextFireMicros) >= 0)
+            {
+                if ((earliest == NULL) || ((long)(t->NextFireMicros - earliest->NextFireMicros) < 0))
+                    earliest = t;
+            }
+        }
+
+        if (earliest != NULL)
+        {
+            callback_with_arg_t callback = earliest->Callback;
+            void* arg = earliest->Arg;
+
+            if (earliest->Repeat)
+                earliest->NextFireMicros += earliest->PeriodMicros;
+            else
+                earliest->detach ();
+
+            TickerCallbacksRun++;
+            callback (arg);
+            fired = true;
+        }
+    }
+
+    inService = false;
+}
+
+// ----------------------------------------------------------------------
+bool Ticker::NextDue (unsigned long* dueMicros)
+{
+    Ticker* earliest = ArmedTickers;
+
+    for (Ticker* t = ArmedTickers; t != NULL; t = t->Next)
+    {
+        if ((long)(t->NextFireMicros - earliest->NextFireMicros) < 0)
+            earliest = t;
+    }
+
+    if (earliest != NULL)
+        *dueMicros = earliest->NextFireMicros;
+
+    return (earliest != NULL);
+}
+
+void HostServiceTickers (void)
+{
+    Ticker::Service ();
+}
@@ -0,0 +1,91 @@
+#ifndef _HOST_TICKER_H
+#define _HOST_TICKER_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+
+// Host version of the ESP8266 Ticker. Callbacks are run from delay(), yield()
+// and HostAdvanceMicros() rather than from a timer interrupt, which is close
+// enough for code that only ever calls delay() in its main loop.
+class Ticker
+{
+public:
+    typedef void (*callback_t) (void);
+    typedef void (*callback_with_arg_t) (void*);
+
+    Ticker (void);
+    ~Ticker (void);
+
+    void attach (float seconds, callback_t callback)
+        { Arm ((unsigned long)(seconds * 1000000.0f), true, (callback_with_arg_t)callback, NULL); }
+    void attach_ms (uint32_t milliseconds, callback_t callback)
+        { Arm (milliseconds * 1000UL, true, (callback_with_arg_t)callback, NULL); }
+    void once (float seconds, callback_t callback)
+        { Arm ((unsigned long)(seconds * 1000000.0f), false, (callback_with_arg_t)callback, NULL); }
+    void once_ms (uint32_t milliseconds, callback_t callback)
+        { Arm (milliseconds * 1000UL, false, (callback_with_arg_t)callback, NULL); }
+
+    template <typename TArg> void attach (float seconds, void (*callback) (TArg), TArg arg)
+        { Arm ((unsigned long)(seconds * 1000000.0f), true, (callback_with_arg_t)callback, (void*)(uintptr_t)arg); }
+    template <typename TArg> void attach_ms (uint32_t milliseconds, void (*callback) (TArg), TArg arg)
+        { Arm (milliseconds * 1000UL, true, (callback_with_arg_t)callback, (void*)(uintptr_t)arg); }
+    template <typename TArg> void once (float seconds, void (*callback) (TArg), TArg arg)
+        { Arm ((unsigned long)(seconds * 1000000.0f), false, (callback_with_arg_t)callback, (void*)(uintptr_t)arg); }
+    template <typename TArg> void once_ms (uint32_t milliseconds, void (*callback) (TArg), TArg arg)
+        { Arm (milliseconds * 1000UL, false, (callback_with_arg_t)callback, (void*)(uintptr_t)arg); }
+
+    void detach (void);
+    bool active (void) const { return (Active); }
+
+    // Total number of callbacks run by all tickers - lets host programs count
+    // timer interrupts.
+    static unsigned long FiredCount (void);
+
+    // Run any callbacks that have come due
+    static void Service (void);
+
+    // Find when the next armed ticker is due. Returns false if none are armed.
+    static bool NextDue (unsigned long* dueMicros);
+
+protected:
+    void Arm (unsigned long periodMicros, bool repeat, callback_with_arg_t callback, void* arg);
+
+    callback_with_arg_t Callback;
+    void* Arg;
+    unsigned long PeriodMicros;
+    unsigned long NextFireMicros;
+    bool Repeat;
+    bool Active;
+
+    // All armed tickers
+    Ticker* Next;
+};
+
+#endif
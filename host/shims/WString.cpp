@@ -0,0 +1,388 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "HostShim.h"
+
+// ----------------------------------------------------------------------
+// Put the object in the empty, unallocated state
+void String::Invalidate (void)
+{
+    if (Buffer != NULL)
+        HostHeapFree (Buffer);
+
+    Buffer = NULL;
+    Capacity = 0;
+    Len = 0;
+}
+
+// ----------------------------------------------------------------------
+// Grow the buffer so it can hold maxStrLen characters plus the terminator
+bool String::ChangeBuffer (unsigned int maxStrLen)
+{
+    char* newBuffer = (char*)HostHeapRealloc (Buffer, maxStrLen + 1);
+
+    if (newBuffer == NULL)
+        return (false);
+
+    Buffer = newBuffer;
+    Capacity = maxStrLen;
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+bool String::reserve (unsigned int size)
+{
+    if ((Buffer != NULL) && (Capacity >= size))
+        return (true);
+
+    if (ChangeBuffer (size))
+    {
+        if (Len == 0)
+            Buffer[0] = 0x00;
+        return (true);
+    }
+    return (false);
+}
+
+// ----------------------------------------------------------------------
+String& String::Copy (const char* cstr, unsigned int length)
+{
+    if (reserve (length) == false)
+    {
+        Invalidate ();
+        return (*this);
+    }
+    Len = length;
+    memmove (Buffer, cstr, length);
+    Buffer[Len] = 0x00;
+    return (*this);
+}
+
+// ----------------------------------------------------------------------
+String::String (const char* cstr)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    if (cstr != NULL)
+        Copy (cstr, strlen (cstr));
+}
+
+String::String (const String& str)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    *this = str;
+}
+
+String::String (const __FlashStringHelper* str)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    *this = str;
+}
+
+String::String (char c)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    Copy (&c, 1);
+}
+
+String::String (unsigned char value, unsigned char base)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    *this = String ((unsigned long)value, base);
+}
+
+String::String (int value, unsigned char base)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    *this = String ((long)value, base);
+}
+
+String::String (unsigned int value, unsigned char base)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    *this = String ((unsigned long)value, base);
+}
+
+String::String (long value, unsigned char base)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    if ((value < 0) && (base == 10))
+    {
+        char buf[24];
+        snprintf (buf, sizeof (buf), "%ld", value);
+        Copy (buf, strlen (buf));
+    }
+    else
+    {
+        *this = String ((unsigned long)value, base);
+    }
+}
+
+String::String (unsigned long value, unsigned char base)
+    : Buffer (NULL), Capacity (0), Len (0)
+{
+    char buf[8 * sizeof (unsigned long) + 1];
+    char* p = &buf[sizeof (buf) - 1];
+    *p = 0x00;
+
+    if (base < 2)
+        base = 10;
+
+    do
+    {
+        unsigned long digit = value % base;
+        *--p = (char)((digit < 10) ? ('0' + digit) : ('A' + digit - 10));
+        value /= base;
+    } while (value != 0);
+
+    Copy (p, strlen (p));
+}
+
+String::~String (void)
+{
+    if (Buffer != NULL)
+        HostHeapFree (Buffer);
+}
+
+// ----------------------------------------------------------------------
+String& String::operator= (const String& rhs)
+{
+    if (this == &rhs)
+        return (*this);
+
+    if (rhs.Buffer != NULL)
+        Copy (rhs.Buffer, rhs.Len);
+    else
+        Invalidate ();
+
+    return (*this);
+}
+
+String& String::operator= (const char* cstr)
+{
+    if (cstr != NULL)
+        Copy (cstr, strlen (cstr));
+    else
+        Invalidate ();
+
+    return (*this);
+}
+
+String& String::operator= (const __FlashStringHelper* str)
+{
+    return (*this = (const char*)str);
+}
+
+// ----------------------------------------------------------------------
+bool String::concat (const char* cstr, unsigned int length)
+{
+    unsigned int newLen = Len + length;
+
+    if (cstr == NULL)
+        return (false);
+    if (length == 0)
+        return (true);
+    if (reserve (newLen) == false)
+        return (false);
+
+    memmove (Buffer + Len, cstr, length);
+    Len = newLen;
+    Buffer[Len] = 0x00;
+    return (true);
+}
+
+bool String::concat (const String& str)
+{
+    return (concat (str.c_str (), str.Len));
+}
+
+bool String::concat (const char* cstr)
+{
+    return ((cstr == NULL) ? false : concat (cstr, strlen (cstr)));
+}
+
+bool String::concat (char c)
+{
+    return (concat (&c, 1));
+}
+
+bool String::concat (unsigned char num)
+{
+    return (concat (String (num)));
+}
+
+bool String::concat (int num)
+{
+    return (concat (String (num)));
+}
+
+bool String::concat (unsigned int num)
+{
+    return (concat (String (num)));
+}
+
+bool String::concat (long num)
+{
+    return (concat (String (num)));
+}
+
+bool String::concat (unsigned long num)
+{
+    return (concat (String (num)));
+}
+
+bool String::concat (const __FlashStringHelper* str)
+{
+    return (concat ((const char*)str));
+}
+
+String operator+ (const String& lhs, const String& rhs)
+{
+    String result (lhs);
+    result.concat (rhs);
+    return (result);
+}
+
+String operator+ (const String& lhs, const char* rhs)
+{
+    String result (lhs);
+    result.concat (rhs);
+    return (result);
+}
+
+// ----------------------------------------------------------------------
+bool String::equals (const String& str) const
+{
+    return ((Len == str.Len) && (strcmp (c_str (), str.c_str ()) == 0));
+}
+
+bool String::equals (const char* cstr) const
+{
+    return (strcmp (c_str (), (cstr == NULL) ? "" : cstr) == 0);
+}
+
+// ----------------------------------------------------------------------
+char String::charAt (unsigned int index) const
+{
+    if (index >= Len)
+        return (0x00);
+    return (Buffer[index]);
+}
+
+void String::setCharAt (unsigned int index, char c)
+{
+    if (index < Len)
+        Buffer[index] = c;
+}
+
+char& String::operator[] (unsigned int index)
+{
+    static char dummyWritableChar;
+
+    if (index >= Len)
+    {
+        dummyWritableChar = 0x00;
+        return (dummyWritableChar);
+    }
+    return (Buffer[index]);
+}
+
+// ----------------------------------------------------------------------
+int String::indexOf (char c, unsigned int fromIndex) const
+{
+    if (fromIndex >= Len)
+        return (-1);
+
+    const char* found = strchr (Buffer + fromIndex, c);
+    return ((found == NULL) ? -1 : (int)(found - Buffer));
+}
+
+String String::substring (unsigned int beginIndex) const
+{
+    return (substring (beginIndex, Len));
+}
+
+String String::substring (unsigned int beginIndex, unsigned int endIndex) const
+{
+    String result;
+
+    if (beginIndex > endIndex)
+    {
+        unsigned int temp = endIndex;
+        endIndex = beginIndex;
+        beginIndex = temp;
+    }
+    if (beginIndex >= Len)
+        return (result);
+    if (endIndex > Len)
+        endIndex = Len;
+
+    result.Copy (Buffer + beginIndex, endIndex - beginIndex);
+    return (result);
+}
+
+bool String::startsWith (const String& prefix) const
+{
+    return ((Len >= prefix.Len) && (strncmp (c_str (), prefix.c_str (), prefix.Len) == 0));
+}
+
+long String::toInt (void) const
+{
+    return (atol (c_str ()));
+}
+
+void String::toUpperCase (void)
+{
+    for (unsigned int i = 0; i < Len; i++)
+        Buffer[i] = toupper (Buffer[i]);
+}
+
+void String::toLowerCase (void)
+{
+    for (unsigned int i = 0; i < Len; i++)
+        Buffer[i] = tolower (Buffer[i]);
+}
+
+void String::trim (void)
+{
+    if (Len == 0)
+        return;
+
+    char* begin = Buffer;
+    while (isspace (*begin))
+        begin++;
+
+    char* end = Buffer + Len - 1;
+    while (isspace (*end) && (end >= begin))
+        end--;
+
+    Len = end + 1 - begin;
+    if (begin > Buffer)
+        memmove (Buffer, begin, Len);
+    Buffer[Len] = 0x00;
+}
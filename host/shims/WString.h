@@ -0,0 +1,114 @@
+#ifndef _HOST_WSTRING_H
+#define _HOST_WSTRING_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Host version of the Arduino String class. Like the real one, it keeps its
+// characters in a heap buffer that is grown with realloc(), so String churn
+// costs the same number of allocations here as it does on the board.
+
+#include <stddef.h>
+
+class __FlashStringHelper;
+
+class String
+{
+public:
+    String (const char* cstr = "");
+    String (const String& str);
+    String (const __FlashStringHelper* str);
+    explicit String (char c);
+    explicit String (unsigned char value, unsigned char base = 10);
+    explicit String (int value, unsigned char base = 10);
+    explicit String (unsigned int value, unsigned char base = 10);
+    explicit String (long value, unsigned char base = 10);
+    explicit String (unsigned long value, unsigned char base = 10);
+    ~String (void);
+
+    // Make sure there is room for size characters plus the terminator.
+    // Returns false if memory could not be allocated.
+    bool reserve (unsigned int size);
+
+    unsigned int length (void) const { return (Len); }
+
+    String& operator= (const String& rhs);
+    String& operator= (const char* cstr);
+    String& operator= (const __FlashStringHelper* str);
+
+    bool concat (const String& str);
+    bool concat (const char* cstr);
+    bool concat (const char* cstr, unsigned int length);
+    bool concat (char c);
+    bool concat (unsigned char num);
+    bool concat (int num);
+    bool concat (unsigned int num);
+    bool concat (long num);
+    bool concat (unsigned long num);
+    bool concat (const __FlashStringHelper* str);
+
+    template <typename T> String& operator+= (const T& rhs)
+        { concat (rhs); return (*this); }
+
+    friend String operator+ (const String& lhs, const String& rhs);
+    friend String operator+ (const String& lhs, const char* rhs);
+
+    bool equals (const String& str) const;
+    bool equals (const char* cstr) const;
+    bool operator== (const String& rhs) const { return (equals (rhs)); }
+    bool operator== (const char* cstr) const { return (equals (cstr)); }
+    bool operator!= (const String& rhs) const { return (!equals (rhs)); }
+    bool operator!= (const char* cstr) const { return (!equals (cstr)); }
+
+    char charAt (unsigned int index) const;
+    void setCharAt (unsigned int index, char c);
+    char operator[] (unsigned int index) const { return (charAt (index)); }
+    char& operator[] (unsigned int index);
+
+    const char* c_str (void) const { return ((Buffer != NULL) ? Buffer : ""); }
+
+    int indexOf (char c, unsigned int fromIndex = 0) const;
+    String substring (unsigned int beginIndex) const;
+    String substring (unsigned int beginIndex, unsigned int endIndex) const;
+    bool startsWith (const String& prefix) const;
+    long toInt (void) const;
+    void toUpperCase (void);
+    void toLowerCase (void);
+    void trim (void);
+
+protected:
+    char* Buffer;            // The characters, always null terminated when not NULL
+    unsigned int Capacity;   // Characters the buffer can hold, not counting the terminator
+    unsigned int Len;        // Characters currently in use
+
+    void Invalidate (void);
+    bool ChangeBuffer (unsigned int maxStrLen);
+    String& Copy (const char* cstr, unsigned int length);
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ESP8266WiFi.h"
+#include "HostShim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+static char RedirectHost[64];
+static uint16_t RedirectPort = 0;
+
+// Updated atomically, so clients on several threads can share them
+static HostClientStats_t ClientStats;
+
+void HostWiFiClientGetStats (HostClientStats_t* stats)
+{
+    stats->Writes = __atomic_load_n (&ClientStats.Writes, __ATOMIC_RELAXED);
+    stats->Bytes = __atomic_load_n (&ClientStats.Bytes, __ATOMIC_RELAXED);
+}
+
+void HostWiFiClientResetStats (void)
+{
+    __atomic_store_n (&ClientStats.Writes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n (&ClientStats.Bytes, 0, __ATOMIC_RELAXED);
+}
+
+void HostWiFiClientCountWrite (size_t bytes)
+{
+    __atomic_add_fetch (&ClientStats.Writes, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&ClientStats.Bytes, bytes, __ATOMIC_RELAXED);
+}
+
+void HostWiFiSetConnectRedirect (const char* host, uint16_t port)
+{
+    if (host == NULL)
+    {
+        RedirectHost[0] = 0x00;
+        RedirectPort = 0;
+    }
+    else
+    {
+        strncpy (RedirectHost, host, sizeof (RedirectHost) - 1);
+        RedirectPort = port;
+    }
+}
+
+// The address and port connections are being sent to instead, if any. Also
+// used by the lookups, so a name looked up before connecting needn't exist.
+bool HostWiFiRedirectAddress (IPAddress* address, uint16_t* port)
+{
+    if ((RedirectHost[0] == 0x00) || (address->fromString (RedirectHost) == false))
+        return (false);
+
+    if (port != NULL)
+        *port = RedirectPort;
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+WiFiClient::WiFiClient (void)
+    : Socket (-1), NoDelay (false), TimeoutMs (5000)
+{
+}
+
+WiFiClient::~WiFiClient (void)
+{
+    stop ();
+}
+
+// ----------------------------------------------------------------------
+int WiFiClient::connect (const char* host, uint16_t port)
+{
+    IPAddress address;
+    if ((address.fromString (host) == false) && (WiFi.hostByName (host, address) == 0))
+        return (0);
+
+    return (connect (address, port));
+}
+
+// A redirect applies whether the library looked the host up itself or not
+int WiFiClient::connect (IPAddress ip, uint16_t port)
+{
+    stop ();
+
+    HostWiFiRedirectAddress (&ip, &port);
+
+    if (WiFi.status () != WL_CONNECTED)
+        return (0);
+
+    Socket = socket (AF_INET, SOCK_STREAM, 0);
+    if (Socket < 0)
+        return (0);
+
+    struct sockaddr_in address;
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons (port);
+    address.sin_addr.s_addr = (uint32_t)ip;
+
+    if (::connect (Socket, (struct sockaddr*)&address, sizeof (address)) != 0)
+    {
+        stop ();
+        return (0);
+    }
+
+    setNoDelay (NoDelay);
+    fcntl (Socket, F_SETFL, fcntl (Socket, F_GETFL) | O_NONBLOCK);
+    return (1);
+}
+
+// ----------------------------------------------------------------------
+// Connected as long as the socket is open and either has data waiting or the
+// peer hasn't closed it.
+uint8_t WiFiClient::connected (void)
+{
+    if (Socket < 0)
+        return (0);
+
+    char c;
+    ssize_t n = recv (Socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if ((n > 0) || ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))))
+        return (1);
+
+    return (0);
+}
+
+void WiFiClient::stop (void)
+{
+    if (Socket >= 0)
+    {
+        close (Socket);
+        Socket = -1;
+    }
+}
+
+// ----------------------------------------------------------------------
+size_t WiFiClient::write (uint8_t c)
+{
+    return (write (&c, 1));
+}
+
+size_t WiFiClient::write (const uint8_t* buffer, size_t size)
+{
+    size_t sent = 0;
+    unsigned long startMillis = millis ();
+
+    while ((Socket >= 0) && (sent < size))
+    {
+        ssize_t n = send (Socket, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            sent += n;
+            HostWiFiClientCountWrite (n);
+        }
+        else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) &&
+                 (millis () - startMillis < TimeoutMs))
+        {
+            usleep (100);
+        }
+        else
+        {
+            break;
+        }
+    }
+    return (sent);
+}
+
+// ----------------------------------------------------------------------
+int WiFiClient::available (void)
+{
+    int count = 0;
+
+    if ((Socket < 0) || (ioctl (Socket, FIONREAD, &count) != 0))
+        return (0);
+
+    return (count);
+}
+
+int WiFiClient::read (void)
+{
+    uint8_t c;
+    return ((read (&c, 1) == 1) ? c : -1);
+}
+
+int WiFiClient::read (uint8_t* buffer, size_t size)
+{
+    if (Socket < 0)
+        return (-1);
+
+    ssize_t n = recv (Socket, buffer, size, MSG_DONTWAIT);
+    return ((n > 0) ? (int)n : -1);
+}
+
+int WiFiClient::peek (void)
+{
+    uint8_t c;
+
+    if ((Socket < 0) || (recv (Socket, &c, 1, MSG_PEEK | MSG_DONTWAIT) != 1))
+        return (-1);
+
+    return (c);
+}
+
+// ----------------------------------------------------------------------
+void WiFiClient::setNoDelay (bool noDelay)
+{
+    NoDelay = noDelay;
+
+    if (Socket >= 0)
+    {
+        int flag = NoDelay ? 1 : 0;
+        setsockopt (Socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof (flag));
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef _HOST_WIFICLIENT_H
+#define _HOST_WIFICLIENT_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// TCP client on top of an ordinary host socket. connect() blocks, like the
+// board's, and reads never block.
+class WiFiClient : public Stream
+{
+public:
+    WiFiClient (void);
+    virtual ~WiFiClient (void);
+
+    // Returns 1 on success and 0 on failure
+    virtual int connect (const char* host, uint16_t port);
+    virtual int connect (IPAddress ip, uint16_t port);
+
+    virtual uint8_t connected (void);
+    virtual void stop (void);
+    operator bool (void) { return (connected () != 0); }
+
+    virtual size_t write (uint8_t c);
+    virtual size_t write (const uint8_t* buffer, size_t size);
+    using Print::write;
+
+    virtual int available (void);
+    virtual int read (void);
+    virtual int read (uint8_t* buffer, size_t size);
+    virtual int peek (void);
+    virtual void flush (void) {}
+
+    void setNoDelay (bool noDelay);
+    void setTimeout (unsigned long timeout) { TimeoutMs = timeout; }
+
+protected:
+    int Socket;
+    bool NoDelay;
+    unsigned long TimeoutMs;
+
+    WiFiClient (const WiFiClient&);
+    WiFiClient& operator= (const WiFiClient&);
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "WiFiUdp.h"
+#include "ESP8266WiFi.h"
+#include "HostShim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// Updated atomically, so sockets on several threads can share them
+static HostUdpStats_t UdpStats;
+
+void HostWiFiUdpGetStats (HostUdpStats_t* stats)
+{
+    stats->Datagrams = __atomic_load_n (&UdpStats.Datagrams, __ATOMIC_RELAXED);
+    stats->Bytes = __atomic_load_n (&UdpStats.Bytes, __ATOMIC_RELAXED);
+}
+
+void HostWiFiUdpResetStats (void)
+{
+    __atomic_store_n (&UdpStats.Datagrams, 0, __ATOMIC_RELAXED);
+    __atomic_store_n (&UdpStats.Bytes, 0, __ATOMIC_RELAXED);
+}
+
+// ----------------------------------------------------------------------
+WiFiUDP::WiFiUDP (void)
+    : Socket (-1), DestinationPort (0), OutLength (0), InLength (0), InPosition (0), RemotePort (0)
+{
+}
+
+WiFiUDP::~WiFiUDP (void)
+{
+    stop ();
+}
+
+// ----------------------------------------------------------------------
+uint8_t WiFiUDP::begin (uint16_t localPort)
+{
+    stop ();
+
+    Socket = socket (AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (Socket < 0)
+        return (0);
+
+    struct sockaddr_in address;
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons (localPort);
+    address.sin_addr.s_addr = htonl (INADDR_ANY);
+
+    if (bind (Socket, (struct sockaddr*)&address, sizeof (address)) != 0)
+    {
+        stop ();
+        return (0);
+    }
+    return (1);
+}
+
+void WiFiUDP::stop (void)
+{
+    if (Socket >= 0)
+    {
+        close (Socket);
+        Socket = -1;
+    }
+    OutLength = 0;
+    InLength = 0;
+    InPosition = 0;
+}
+
+// ----------------------------------------------------------------------
+int WiFiUDP::beginPacket (IPAddress ip, uint16_t port)
+{
+    DestinationIP = ip;
+    DestinationPort = port;
+    OutLength = 0;
+    return (1);
+}
+
+int WiFiUDP::beginPacket (const char* host, uint16_t port)
+{
+    IPAddress address;
+    if ((address.fromString (host) == false) && (WiFi.hostByName (host, address) == 0))
+        return (0);
+
+    return (beginPacket (address, port));
+}
+
+int WiFiUDP::endPacket (void)
+{
+    if ((Socket < 0) || (WiFi.status () != WL_CONNECTED))
+        return (0);
+
+    struct sockaddr_in address;
+    memset (&address, 0, sizeof (address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons (DestinationPort);
+    address.sin_addr.s_addr = (uint32_t)DestinationIP;
+
+    ssize_t n = sendto (Socket, OutBuffer, OutLength, 0, (struct sockaddr*)&address, sizeof (address));
+    OutLength = 0;
+    if (n < 0)
+        return (0);
+
+    __atomic_add_fetch (&UdpStats.Datagrams, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&UdpStats.Bytes, n, __ATOMIC_RELAXED);
+    return (1);
+}
+
+// ----------------------------------------------------------------------
+size_t WiFiUDP::write (uint8_t c)
+{
+    return (write (&c, 1));
+}
+
+size_t WiFiUDP::write (const uint8_t* buffer, size_t size)
+{
+    if (size > PacketLen - OutLength)
+        size = PacketLen - OutLength;
+
+    memcpy (OutBuffer + OutLength, buffer, size);
+    OutLength += size;
+    return (size);
+}
+
+// ----------------------------------------------------------------------
+int WiFiUDP::parsePacket (void)
+{
+    InLength = 0;
+    InPosition = 0;
+
+    if (Socket < 0)
+        return (0);
+
+    struct sockaddr_in address;
+    socklen_t addressLength = sizeof (address);
+    ssize_t n = recvfrom (Socket, InBuffer, sizeof (InBuffer), 0, (struct sockaddr*)&address, &addressLength);
+    if (n <= 0)
+        return (0);
+
+    InLength = n;
+    RemoteIP = IPAddress ((uint32_t)address.sin_addr.s_addr);
+    RemotePort = ntohs (address.sin_port);
+    return ((int)InLength);
+}
+
+int WiFiUDP::available (void)
+{
+    return ((int)(InLength - InPosition));
+}
+
+int WiFiUDP::read (void)
+{
+    return ((InPosition < InLength) ? InBuffer[InPosition++] : -1);
+}
+
+int WiFiUDP::read (uint8_t* buffer, size_t size)
+{
+    if (size > InLength - InPosition)
+        size = InLength - InPosition;
+
+    memcpy (buffer, InBuffer + InPosition, size);
+    InPosition += size;
+    return ((int)size);
+}
+
+int WiFiUDP::peek (void)
+{
+    return ((InPosition < InLength) ? InBuffer[InPosition] : -1);
+}
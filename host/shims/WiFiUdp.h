@@ -0,0 +1,95 @@
+#ifndef _HOST_WIFIUDP_H
+#define _HOST_WIFIUDP_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// UDP on top of an ordinary host socket, with the board's packet-at-a-time
+// interface. Nothing blocks: endPacket() hands the datagram to the stack and
+// parsePacket() returns 0 if nothing has arrived.
+class WiFiUDP : public Stream
+{
+public:
+    WiFiUDP (void);
+    virtual ~WiFiUDP (void);
+
+    // Open a socket on localPort (0 for any). Returns 1 on success and 0 on failure.
+    uint8_t begin (uint16_t localPort);
+    void stop (void);
+
+    // Build a datagram with write() between these. Both return 1 on success and 0 on failure.
+    int beginPacket (IPAddress ip, uint16_t port);
+    int beginPacket (const char* host, uint16_t port);
+    int endPacket (void);
+
+    virtual size_t write (uint8_t c);
+    virtual size_t write (const uint8_t* buffer, size_t size);
+    using Print::write;
+
+    // Take the next datagram that has arrived, if any, and return its size
+    int parsePacket (void);
+
+    // Read from the datagram parsePacket() took
+    virtual int available (void);
+    virtual int read (void);
+    int read (uint8_t* buffer, size_t size);
+    int read (char* buffer, size_t size)
+        { return (read ((uint8_t*)buffer, size)); }
+    virtual int peek (void);
+    virtual void flush (void) {}
+
+    // Where the datagram parsePacket() took came from
+    IPAddress remoteIP (void) { return (RemoteIP); }
+    uint16_t remotePort (void) { return (RemotePort); }
+
+protected:
+    static const size_t PacketLen = 1472;   // Ethernet MTU less IP and UDP headers
+
+    int Socket;
+
+    // Datagram being built
+    IPAddress DestinationIP;
+    uint16_t DestinationPort;
+    uint8_t OutBuffer[PacketLen];
+    size_t OutLength;
+
+    // Datagram being read
+    uint8_t InBuffer[PacketLen];
+    size_t InLength;
+    size_t InPosition;
+    IPAddress RemoteIP;
+    uint16_t RemotePort;
+
+    WiFiUDP (const WiFiUDP&);
+    WiFiUDP& operator= (const WiFiUDP&);
+};
+
+#endif
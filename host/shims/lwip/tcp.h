@@ -0,0 +1,75 @@
+#ifndef _HOST_LWIP_TCP_H
+#define _HOST_LWIP_TCP_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+
+// lwIP's raw TCP interface, the part of it the libraries use, on top of
+// ordinary host sockets. Nothing blocks: tcp_connect() starts the handshake
+// and returns, and the callbacks run later, from yield() and delay() - the
+// points at which the board's core lets lwIP run. As on the board, a
+// connection that fails or is reset is freed before the error callback is
+// called, and must not be touched afterwards.
+//
+// Connections belong to the thread that opened them, and only its yield()
+// and delay() call them back, so threads can each run their own.
+struct tcp_pcb;
+
+typedef err_t (*tcp_connected_fn) (void* arg, struct tcp_pcb* tpcb, err_t err);
+typedef err_t (*tcp_recv_fn) (void* arg, struct tcp_pcb* tpcb, struct pbuf* p, err_t err);
+typedef void (*tcp_err_fn) (void* arg, err_t err);
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+// Returns NULL if every connection is in use
+struct tcp_pcb* tcp_new (void);
+
+void tcp_arg (struct tcp_pcb* pcb, void* arg);
+void tcp_recv (struct tcp_pcb* pcb, tcp_recv_fn recv);
+void tcp_err (struct tcp_pcb* pcb, tcp_err_fn err);
+
+err_t tcp_connect (struct tcp_pcb* pcb, const ip_addr_t* ipaddr, u16_t port, tcp_connected_fn connected);
+
+// The data is always sent straight away, so tcp_output() has nothing to do
+err_t tcp_write (struct tcp_pcb* pcb, const void* dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output (struct tcp_pcb* pcb);
+u16_t tcp_sndbuf (const struct tcp_pcb* pcb);
+void tcp_recved (struct tcp_pcb* pcb, u16_t len);
+void tcp_nagle_disable (struct tcp_pcb* pcb);
+
+// tcp_close() frees the connection without calling back; tcp_abort() calls
+// the error callback with ERR_ABRT, as lwIP does
+err_t tcp_close (struct tcp_pcb* pcb);
+void tcp_abort (struct tcp_pcb* pcb);
+
+#endif
@@ -0,0 +1,145 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Builds the PROGMEM tables CRSCBanner prints from. Reads a text file and
+// writes a header holding it run length encoded, with each line ending in
+// "\r\n" as Serial.println() would send it. The logo was made with
+//
+//   CRSCBannerGen -n CRSCLogo CRSCSketch/CRSCLogo.txt > CRSCSketch/CRSCLogo.h
+//
+// Usage: CRSCBannerGen -n name file
+//   -n name      name of the table, and of the header guard
+
+#include <Arduino.h>
+
+#include "CRSCBanner.h"
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// The generated header carries the same licence as everything else
+static const char Licence[] =
+    "/*\n"
+    "Copyright 2019 CANARIE Inc. All Rights Reserved.\n"
+    "\n"
+    "Redistribution and use in source and binary forms, with or without modification,\n"
+    "are permitted provided that the following conditions are met:\n"
+    "\n"
+    "1. Redistributions of source code must retain the above copyright notice,\n"
+    "   this list of conditions and the following disclaimer.\n"
+    "\n"
+    "2. Redistributions in binary form must reproduce the above copyright notice,\n"
+    "   this list of conditions and the following disclaimer in the documentation\n"
+    "   and/or other materials provided with the distribution.\n"
+    "\n"
+    "3. The name of the author may not be used to endorse or promote products\n"
+    "   derived from this software without specific prior written permission.\n"
+    "\n"
+    "THIS SOFTWARE IS PROVIDED BY CANARIE Inc. \"AS IS\" AND\n"
+    "ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED\n"
+    "WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE\n"
+    "DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,\n"
+    "INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT\n"
+    "LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,\n"
+    "OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF\n"
+    "LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING\n"
+    "NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,\n"
+    "EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.\n"
+    "*/\n";
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCBannerGen -n name file\n");
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    const char* name = NULL;
+    int option;
+
+    while ((option = getopt (argc, argv, "n:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': name = optarg; break;
+            default:  Usage (); return (2);
+        }
+    }
+
+    if ((name == NULL) || (optind != argc - 1))
+    {
+        Usage ();
+        return (2);
+    }
+
+    FILE* input = fopen (argv[optind], "r");
+    if (input == NULL)
+    {
+        fprintf (stderr, "Can't open %s\n", argv[optind]);
+        return (1);
+    }
+
+    std::string text;
+    int c;
+    while ((c = fgetc (input)) != EOF)
+    {
+        if (c == '\r')
+            continue;
+        if (c == '\n')
+            text += '\r';
+        text += (char)c;
+    }
+    fclose (input);
+
+    std::vector<uint8_t> encoded (text.size () + 1);
+    size_t length = CRSCBanner::Encode (text.c_str (), encoded.data (), encoded.size ());
+    if (length == 0)
+    {
+        fprintf (stderr, "%s has characters outside 7 bit ASCII\n", argv[optind]);
+        return (1);
+    }
+
+    std::string guard = "_";
+    for (const char* p = name; *p != 0x00; p++)
+        guard += (char)toupper (*p);
+    guard += "_H";
+
+    printf ("#ifndef %s\n#define %s\n\n%s\n", guard.c_str (), guard.c_str (), Licence);
+    printf ("// Generated by CRSCBannerGen from %s - edit that and run it again rather than\n", argv[optind]);
+    printf ("// changing this. %zu bytes of text in %zu.\n\n", text.size (), length);
+    printf ("#include <Arduino.h>\n\n");
+    printf ("static const uint8_t %s[] PROGMEM =\n{", name);
+    for (size_t i = 0; i < length; i++)
+        printf ("%s0x%02x%s", (i % 16 == 0) ? "\n    " : "", encoded[i], (i + 1 < length) ? "," : "");
+    printf ("\n};\n\n#endif\n");
+    return (0);
+}
@@ -0,0 +1,760 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Stands in for ifttt.com at events. Boards pointed at it with the C command,
+// or imaged with CRSCImageGen -c, send it exactly the request IFTTTMessageClass
+// sends ifttt.com:
+//
+//   POST /trigger/crsc_message/with/key/<key> HTTP/1.1
+//   ...
+//   {"value1":"<board ID>","value2":"<message>"}
+//
+// and it answers the way ifttt.com does, so the board marks the message sent.
+// Boards given a udp:// collector send a signed CRSCDatagram to the same port
+// instead, and get a signed acknowledgement back; that needs -k, as the key is
+// what they're signed with.
+// Completions are kept once per board, in the order they arrived - a board whose
+// outbox sends its completion again, because the reply was lost, keeps its
+// place. The leaderboard is printed as it changes, at most once a second, and
+// GET / returns it as text.
+//
+// One thread and one epoll loop handle every connection. Each connection gets a
+// fixed buffer that holds the whole request, and is answered and closed as soon
+// as the request is in, so nothing on the request path allocates. Datagrams are
+// taken and answered in batches.
+//
+// Usage: CRSCCollector [options]
+//   -p port      TCP and UDP port to listen on (default 8080)
+//   -a address   address to listen on (default every interface)
+//   -k key       only accept messages sent with this IFTTT key. Needed for UDP.
+//   -o file      append each board's first completion to file as CSV - rank,
+//                board ID, seconds since the collector started, Unix time
+//   -q           don't print the leaderboard as it changes
+//
+// Ctrl-C prints the final leaderboard and totals.
+
+#include <Arduino.h>
+
+#include "CRSCConfig.h"
+#include "CRSCDatagram.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// The request IFTTTMessageClass sends is about 250 bytes. Anything that doesn't
+// fit in this is not from a board.
+static const unsigned ConnectionBufferLen = 1024;
+
+// Connections that haven't sent a whole request in this long are dropped
+static const unsigned long long IdleTimeoutMs = 10000;
+
+// How often the leaderboard is printed at most, and how many places it shows
+static const unsigned long long PrintIntervalMs = 1000;
+static const unsigned PrintPlaces = 20;
+
+// Datagrams taken, and answered, per system call
+static const unsigned DatagramBatch = 64;
+
+// What the sketch sends. Anything else from a valid board is counted and accepted.
+static const char DoneMsg[] = "Scavenger hunt is complete!";
+static const char TestMsg[] = "Connectivity test";
+
+static const char TriggerPath[] = "/trigger/crsc_message/with/key/";
+
+// One client connection, indexed by its socket
+typedef struct
+{
+    int Socket;                         // -1 if this slot isn't in use
+    unsigned Length;                    // How much of Buffer holds request
+    unsigned long long LastActivityMs;  // When something last arrived
+    char Buffer[ConnectionBufferLen + 1];
+} Connection_t;
+
+// A board that has finished the hunt
+typedef struct
+{
+    char BoardID[BOARD_ID_BUF_LEN];
+    double Seconds;                     // When its completion first arrived, from start up
+    unsigned long Messages;             // Completions received from it, repeats included
+} Finisher_t;
+
+// Running totals
+typedef struct
+{
+    unsigned long long Connections;
+    unsigned long long Requests;        // Whole requests received
+    unsigned long long Datagrams;       // Signed notifications received
+    unsigned long long Completions;     // First completions - one per board
+    unsigned long long Duplicates;      // Completions from boards already on the leaderboard
+    unsigned long long Tests;           // Connectivity tests
+    unsigned long long Other;           // Accepted messages that were neither
+    unsigned long long Rejected;        // Answered with a 4xx, or a datagram that wasn't signed with the key
+    unsigned long long Dropped;         // Closed or timed out before a whole request arrived
+} CollectorStats_t;
+
+static volatile sig_atomic_t StopRequested = 0;
+
+static std::chrono::steady_clock::time_point StartTime;
+
+static std::vector<Connection_t> Connections;
+static std::vector<Finisher_t> Leaderboard;
+static std::unordered_map<uint32_t, size_t> FinisherIndex;
+static CollectorStats_t Stats;
+static bool LeaderboardChanged = false;
+
+// Checking and packing board IDs is the configuration's job
+static CRSCConfigClass* TheConfiguration;
+static const char* RequiredKey = NULL;
+static uint8_t DatagramKey[DATAGRAM_KEY_LEN];
+static FILE* CSVFile = NULL;
+
+// ----------------------------------------------------------------------
+static void OnSignal (int)
+{
+    StopRequested = 1;
+}
+
+// ----------------------------------------------------------------------
+static unsigned long long NowMs (void)
+{
+    return (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - StartTime).count ());
+}
+
+// ----------------------------------------------------------------------
+// The leaderboard as text, with at most maxPlaces places (0 for all of them)
+static std::string FormatLeaderboard (size_t maxPlaces)
+{
+    std::string text;
+    char line[128];
+    size_t places = ((maxPlaces == 0) || (maxPlaces > Leaderboard.size ())) ? Leaderboard.size () : maxPlaces;
+
+    snprintf (line, sizeof (line), "%-5s %-*s %10s %8s\n", "Place", BOARD_ID_LEN < 8 ? 8 : BOARD_ID_LEN, "Board",
+              "Seconds", "Repeats");
+    text += line;
+    for (size_t i = 0; i < places; i++)
+    {
+        snprintf (line, sizeof (line), "%5zu %-*s %10.3f %8lu\n", i + 1, BOARD_ID_LEN < 8 ? 8 : BOARD_ID_LEN,
+                  Leaderboard[i].BoardID, Leaderboard[i].Seconds, Leaderboard[i].Messages - 1);
+        text += line;
+    }
+    if (places < Leaderboard.size ())
+    {
+        snprintf (line, sizeof (line), "  ... and %zu more\n", Leaderboard.size () - places);
+        text += line;
+    }
+
+    snprintf (line, sizeof (line), "%llu finished, %llu repeats, %llu tests, %llu other, %llu rejected, %llu dropped\n",
+              Stats.Completions, Stats.Duplicates, Stats.Tests, Stats.Other, Stats.Rejected, Stats.Dropped);
+    text += line;
+    return (text);
+}
+
+// ----------------------------------------------------------------------
+// Copy the string value of "name" out of a flat JSON object. Only the escapes
+// that matter for finding the end of the string are handled.
+static bool GetJSONString (const char* json, const char* name, char* value, size_t valueLen)
+{
+    char quotedName[32];
+    snprintf (quotedName, sizeof (quotedName), "\"%s\"", name);
+
+    const char* text = strstr (json, quotedName);
+    if (text == NULL)
+        return (false);
+
+    text += strlen (quotedName);
+    text += strspn (text, " \t\r\n");
+    if (*text++ != ':')
+        return (false);
+    text += strspn (text, " \t\r\n");
+    if (*text++ != '"')
+        return (false);
+
+    size_t length = 0;
+    while ((*text != '"') && (*text != 0x00))
+    {
+        if ((*text == '\\') && (text[1] != 0x00))
+            text++;
+        if (length + 1 >= valueLen)
+            return (false);
+        value[length++] = *text++;
+    }
+    value[length] = 0x00;
+    return (*text == '"');
+}
+
+// ----------------------------------------------------------------------
+// A board has sent theEvent, as its outbox calls it. Returns the HTTP status to
+// answer with.
+static int AcceptEvent (char* theID, uint8_t theEvent)
+{
+    char checkBytes[BOARD_ID_CHECK_BYTES];
+    uint32_t packedID;
+
+    // Same test the board applies to an ID typed at it
+    if (strlen (theID) != (size_t)BOARD_ID_LEN)
+        return (400);
+    TheConfiguration->CalculateCheckBytes (theID, checkBytes);
+    if ((memcmp (checkBytes, theID + BOARD_ID_BYTES, BOARD_ID_CHECK_BYTES) != 0) ||
+        (TheConfiguration->PackBoardID (theID, &packedID) == false))
+        return (400);
+
+    if (theEvent == OUTBOX_HUNT_COMPLETE)
+    {
+        std::unordered_map<uint32_t, size_t>::iterator found = FinisherIndex.find (packedID);
+        if (found != FinisherIndex.end ())
+        {
+            Leaderboard[found->second].Messages++;
+            Stats.Duplicates++;
+        }
+        else
+        {
+            Finisher_t theFinisher;
+            memcpy (theFinisher.BoardID, theID, BOARD_ID_BUF_LEN);
+            theFinisher.Seconds = NowMs () / 1000.0;
+            theFinisher.Messages = 1;
+
+            FinisherIndex[packedID] = Leaderboard.size ();
+            Leaderboard.push_back (theFinisher);
+            Stats.Completions++;
+            LeaderboardChanged = true;
+
+            if (CSVFile != NULL)
+                fprintf (CSVFile, "%zu,%s,%.3f,%ld\n", Leaderboard.size (), theID, theFinisher.Seconds, (long)time (NULL));
+        }
+    }
+    else if (theEvent == OUTBOX_WIFI_TEST)
+    {
+        Stats.Tests++;
+    }
+    else
+    {
+        Stats.Other++;
+    }
+    return (200);
+}
+
+// ----------------------------------------------------------------------
+// Look at what has arrived on a connection. Returns 0 if the request isn't all
+// there yet, or the HTTP status to answer with. GET requests for the
+// leaderboard fill in theBody.
+static int ProcessRequest (Connection_t* theConnection, std::string* theBody)
+{
+    char* request = theConnection->Buffer;
+    request[theConnection->Length] = 0x00;
+
+    // Headers end with a blank line. Boards send CRLF, but a bare LF from a
+    // hand-typed request is fine too.
+    char* headerEnd = strstr (request, "\r\n\r\n");
+    char* bareEnd = strstr (request, "\n\n");
+    unsigned bodyStart;
+
+    if ((bareEnd != NULL) && ((headerEnd == NULL) || (bareEnd < headerEnd)))
+        bodyStart = (bareEnd - request) + 2;
+    else if (headerEnd != NULL)
+        bodyStart = (headerEnd - request) + 4;
+    else
+        return ((theConnection->Length >= ConnectionBufferLen) ? 413 : 0);
+
+    // Request line - method, path, version. The request is left as it is, as
+    // this may be looked at again when more of it arrives.
+    const char* pathStart = strchr (request, ' ');
+    if (pathStart == NULL)
+        return (400);
+    size_t methodLength = pathStart - request;
+    pathStart++;
+
+    const char* version = strchr (pathStart, ' ');
+    char path[256];
+    if ((version == NULL) || (strncmp (version + 1, "HTTP/1.", 7) != 0) || ((size_t)(version - pathStart) >= sizeof (path)))
+        return (400);
+    memcpy (path, pathStart, version - pathStart);
+    path[version - pathStart] = 0x00;
+
+    // The only header that matters is the length of the body
+    unsigned long contentLength = 0;
+    for (const char* line = strchr (version, '\n'); (line != NULL) && (line < request + bodyStart); line = strchr (line, '\n'))
+    {
+        line++;
+        if (strncasecmp (line, "Content-Length:", 15) == 0)
+            contentLength = strtoul (line + 15, NULL, 10);
+    }
+
+    if ((methodLength == 3) && (strncmp (request, "GET", 3) == 0))
+    {
+        if ((strcmp (path, "/") != 0) && (strcmp (path, "/leaderboard") != 0))
+            return (404);
+        *theBody = FormatLeaderboard (0);
+        return (200);
+    }
+
+    if ((methodLength != 4) || (strncmp (request, "POST", 4) != 0))
+        return (405);
+    if (strncmp (path, TriggerPath, sizeof (TriggerPath) - 1) != 0)
+        return (404);
+
+    if (contentLength > ConnectionBufferLen - bodyStart)
+        return (413);
+    if (theConnection->Length < bodyStart + contentLength)
+        return (0);
+
+    Stats.Requests++;
+
+    const char* theKey = path + sizeof (TriggerPath) - 1;
+    if ((theKey[0] == 0x00) || ((RequiredKey != NULL) && (strcmp (theKey, RequiredKey) != 0)))
+        return (401);
+
+    // The body is terminated where it ends, in case anything follows it
+    char* body = request + bodyStart;
+    body[contentLength] = 0x00;
+
+    char theID[BOARD_ID_BUF_LEN + 1];
+    char theMessage[128];
+    if ((GetJSONString (body, "value1", theID, sizeof (theID)) == false) ||
+        (GetJSONString (body, "value2", theMessage, sizeof (theMessage)) == false))
+        return (400);
+
+    uint8_t theEvent = 0;
+    if (strncmp (theMessage, DoneMsg, sizeof (DoneMsg) - 1) == 0)
+        theEvent = OUTBOX_HUNT_COMPLETE;
+    else if (strncmp (theMessage, TestMsg, sizeof (TestMsg) - 1) == 0)
+        theEvent = OUTBOX_WIFI_TEST;
+
+    return (AcceptEvent (theID, theEvent));
+}
+
+// ----------------------------------------------------------------------
+// Take every datagram that is waiting and acknowledge the ones signed with our
+// key. Anything else gets no answer, as the board only believes signed ones.
+static void ServiceDatagrams (int theSocket)
+{
+    static uint8_t inBuffers[DatagramBatch][DATAGRAM_LEN + 1];
+    static uint8_t outBuffers[DatagramBatch][DATAGRAM_LEN];
+    static struct sockaddr_in addresses[DatagramBatch];
+    static struct iovec inParts[DatagramBatch];
+    static struct iovec outParts[DatagramBatch];
+    static struct mmsghdr inMessages[DatagramBatch];
+    static struct mmsghdr outMessages[DatagramBatch];
+
+    for (;;)
+    {
+        memset (inMessages, 0, sizeof (inMessages));
+        for (unsigned i = 0; i < DatagramBatch; i++)
+        {
+            // One byte more than a datagram, so a longer one shows up as the wrong length
+            inParts[i].iov_base = inBuffers[i];
+            inParts[i].iov_len = sizeof (inBuffers[i]);
+            inMessages[i].msg_hdr.msg_iov = &inParts[i];
+            inMessages[i].msg_hdr.msg_iovlen = 1;
+            inMessages[i].msg_hdr.msg_name = &addresses[i];
+            inMessages[i].msg_hdr.msg_namelen = sizeof (addresses[i]);
+        }
+
+        int count = recvmmsg (theSocket, inMessages, DatagramBatch, MSG_DONTWAIT, NULL);
+        if (count <= 0)
+            break;
+
+        unsigned replies = 0;
+        for (int i = 0; i < count; i++)
+        {
+            datagram_t theDatagram;
+
+            if ((CRSCDatagram::Unpack (inBuffers[i], inMessages[i].msg_len, DatagramKey, &theDatagram) == false) ||
+                (theDatagram.Kind != DATAGRAM_NOTIFICATION))
+            {
+                Stats.Rejected++;
+                continue;
+            }
+
+            Stats.Datagrams++;
+            theDatagram.Kind = DATAGRAM_ACK;
+            theDatagram.Status = AcceptEvent (theDatagram.BoardID, theDatagram.Event);
+            if (theDatagram.Status >= 400)
+                Stats.Rejected++;
+            CRSCDatagram::Pack (&theDatagram, DatagramKey, outBuffers[replies]);
+
+            outParts[replies].iov_base = outBuffers[replies];
+            outParts[replies].iov_len = DATAGRAM_LEN;
+            memset (&outMessages[replies], 0, sizeof (outMessages[replies]));
+            outMessages[replies].msg_hdr.msg_iov = &outParts[replies];
+            outMessages[replies].msg_hdr.msg_iovlen = 1;
+            outMessages[replies].msg_hdr.msg_name = &addresses[i];
+            outMessages[replies].msg_hdr.msg_namelen = inMessages[i].msg_hdr.msg_namelen;
+            replies++;
+        }
+
+        // A reply the socket can't take now is as good as lost - the board sends again
+        if (replies > 0)
+            sendmmsg (theSocket, outMessages, replies, MSG_DONTWAIT);
+
+        if ((unsigned)count < DatagramBatch)
+            break;
+    }
+}
+
+// ----------------------------------------------------------------------
+static void CloseConnection (int epollFD, Connection_t* theConnection)
+{
+    epoll_ctl (epollFD, EPOLL_CTL_DEL, theConnection->Socket, NULL);
+    close (theConnection->Socket);
+    theConnection->Socket = -1;
+}
+
+// ----------------------------------------------------------------------
+// Answer a request and close the connection. Replies to boards fit in the
+// socket buffer of a new connection; a long leaderboard may not, so the rest of
+// it is sent blocking, with a timeout.
+static void SendReply (int epollFD, Connection_t* theConnection, int status, const std::string& theBody)
+{
+    static const char BoardReply[] = "Congratulations! You've fired the crsc_message event";
+    const char* reason;
+    const char* body;
+    size_t bodyLength;
+    char reply[256];
+
+    switch (status)
+    {
+        case 200: reason = "OK"; break;
+        case 400: reason = "Bad Request"; break;
+        case 401: reason = "Unauthorized"; break;
+        case 404: reason = "Not Found"; break;
+        case 405: reason = "Method Not Allowed"; break;
+        case 413: reason = "Payload Too Large"; break;
+        default:  reason = "Error"; break;
+    }
+
+    if (theBody.empty () == false)
+    {
+        body = theBody.data ();
+        bodyLength = theBody.size ();
+    }
+    else
+    {
+        body = (status == 200) ? BoardReply : reason;
+        bodyLength = strlen (body);
+    }
+    if (status >= 400)
+        Stats.Rejected++;
+
+    int headerLength = snprintf (reply, sizeof (reply),
+                                 "HTTP/1.1 %d %s\r\n"
+                                 "Content-Type: text/plain\r\n"
+                                 "Content-Length: %zu\r\n"
+                                 "Connection: close\r\n\r\n", status, reason, bodyLength);
+
+    struct iovec parts[2] = {{reply, (size_t)headerLength}, {(void*)body, bodyLength}};
+    struct msghdr message;
+    memset (&message, 0, sizeof (message));
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+
+    ssize_t sent = sendmsg (theConnection->Socket, &message, MSG_NOSIGNAL);
+    size_t total = headerLength + bodyLength;
+    if ((sent >= 0) && ((size_t)sent < total) && ((size_t)sent >= (size_t)headerLength))
+    {
+        struct timeval timeout = {2, 0};
+        int flags = fcntl (theConnection->Socket, F_GETFL);
+
+        fcntl (theConnection->Socket, F_SETFL, flags & ~O_NONBLOCK);
+        setsockopt (theConnection->Socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof (timeout));
+
+        size_t bodySent = sent - headerLength;
+        while (bodySent < bodyLength)
+        {
+            ssize_t n = send (theConnection->Socket, body + bodySent, bodyLength - bodySent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            bodySent += n;
+        }
+    }
+
+    CloseConnection (epollFD, theConnection);
+}
+
+// ----------------------------------------------------------------------
+// Take every connection that is waiting
+static void AcceptConnections (int epollFD, int listener)
+{
+    for (;;)
+    {
+        int theSocket = accept4 (listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (theSocket < 0)
+        {
+            // Out of descriptors - the ones we have will time out or finish soon
+            if ((errno == EMFILE) || (errno == ENFILE))
+                fprintf (stderr, "Out of file descriptors - connections are waiting\n");
+            break;
+        }
+
+        if ((size_t)theSocket >= Connections.size ())
+        {
+            size_t oldSize = Connections.size ();
+            Connections.resize (theSocket + 1024);
+            for (size_t i = oldSize; i < Connections.size (); i++)
+                Connections[i].Socket = -1;
+        }
+
+        Connection_t* theConnection = &Connections[theSocket];
+        theConnection->Socket = theSocket;
+        theConnection->Length = 0;
+        theConnection->LastActivityMs = NowMs ();
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = theSocket;
+        epoll_ctl (epollFD, EPOLL_CTL_ADD, theSocket, &event);
+        Stats.Connections++;
+    }
+}
+
+// ----------------------------------------------------------------------
+// Read whatever has arrived on a connection and answer it if it's complete
+static void ServiceConnection (int epollFD, Connection_t* theConnection)
+{
+    bool peerClosed = false;
+
+    while (theConnection->Length < ConnectionBufferLen)
+    {
+        ssize_t n = recv (theConnection->Socket, theConnection->Buffer + theConnection->Length,
+                          ConnectionBufferLen - theConnection->Length, 0);
+        if (n > 0)
+        {
+            theConnection->Length += n;
+        }
+        else
+        {
+            peerClosed = ((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)));
+            break;
+        }
+    }
+    theConnection->LastActivityMs = NowMs ();
+
+    std::string theBody;
+    int status = ProcessRequest (theConnection, &theBody);
+    if (status != 0)
+    {
+        SendReply (epollFD, theConnection, status, theBody);
+    }
+    else if (peerClosed)
+    {
+        Stats.Dropped++;
+        CloseConnection (epollFD, theConnection);
+    }
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCCollector [-p port] [-a address] [-k key] [-o file] [-q]\n");
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned long port = 8080;
+    const char* address = NULL;
+    const char* csvName = NULL;
+    bool quiet = false;
+    int option;
+
+    while ((option = getopt (argc, argv, "p:a:k:o:q")) != -1)
+    {
+        switch (option)
+        {
+            case 'p': port = strtoul (optarg, NULL, 10); break;
+            case 'a': address = optarg; break;
+            case 'k': RequiredKey = optarg; break;
+            case 'o': csvName = optarg; break;
+            case 'q': quiet = true; break;
+            default:  Usage (); return (2);
+        }
+    }
+
+    if ((optind != argc) || (port == 0) || (port > 65535))
+    {
+        Usage ();
+        return (2);
+    }
+
+    // A busy event can have thousands of boards connected at once
+    struct rlimit limit;
+    if (getrlimit (RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit (RLIMIT_NOFILE, &limit);
+    }
+
+    struct sockaddr_in listenAddress;
+    memset (&listenAddress, 0, sizeof (listenAddress));
+    listenAddress.sin_family = AF_INET;
+    listenAddress.sin_port = htons (port);
+    listenAddress.sin_addr.s_addr = htonl (INADDR_ANY);
+    if ((address != NULL) && (inet_pton (AF_INET, address, &listenAddress.sin_addr) != 1))
+    {
+        fprintf (stderr, "Bad address %s\n", address);
+        return (2);
+    }
+
+    int listener = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    setsockopt (listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse));
+    if ((bind (listener, (struct sockaddr*)&listenAddress, sizeof (listenAddress)) != 0) ||
+        (listen (listener, 4096) != 0))
+    {
+        fprintf (stderr, "Can't listen on port %lu: %s\n", port, strerror (errno));
+        return (1);
+    }
+
+    // Datagrams are signed with the key, so without one there's no UDP. A big
+    // receive buffer rides out a room full of boards finishing at once.
+    int datagramSocket = -1;
+    if (RequiredKey != NULL)
+    {
+        int bufferSize = 4 * 1024 * 1024;
+
+        CRSCDatagram::MakeKey (RequiredKey, DatagramKey);
+        datagramSocket = socket (AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        setsockopt (datagramSocket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof (bufferSize));
+        if (bind (datagramSocket, (struct sockaddr*)&listenAddress, sizeof (listenAddress)) != 0)
+        {
+            fprintf (stderr, "Can't take UDP port %lu: %s\n", port, strerror (errno));
+            return (1);
+        }
+    }
+
+    if (csvName != NULL)
+    {
+        CSVFile = fopen (csvName, "a");
+        if (CSVFile == NULL)
+        {
+            fprintf (stderr, "Can't open %s\n", csvName);
+            return (1);
+        }
+    }
+
+    struct sigaction action;
+    memset (&action, 0, sizeof (action));
+    action.sa_handler = OnSignal;
+    sigaction (SIGINT, &action, NULL);
+    sigaction (SIGTERM, &action, NULL);
+
+    int epollFD = epoll_create1 (EPOLL_CLOEXEC);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    epoll_ctl (epollFD, EPOLL_CTL_ADD, listener, &event);
+    if (datagramSocket >= 0)
+    {
+        event.data.fd = datagramSocket;
+        epoll_ctl (epollFD, EPOLL_CTL_ADD, datagramSocket, &event);
+    }
+
+    TheConfiguration = new CRSCConfigClass;
+    StartTime = std::chrono::steady_clock::now ();
+    memset (&Stats, 0, sizeof (Stats));
+
+    if (RequiredKey != NULL)
+        printf ("Collecting on TCP and UDP port %lu for key %s\n", port, RequiredKey);
+    else
+        printf ("Collecting on TCP port %lu - give a key with -k for UDP\n", port);
+    fflush (stdout);
+
+    static const int MaxEvents = 256;
+    struct epoll_event events[MaxEvents];
+    unsigned long long lastPrintMs = 0;
+    unsigned long long lastSweepMs = 0;
+
+    while (StopRequested == 0)
+    {
+        int count = epoll_wait (epollFD, events, MaxEvents, PrintIntervalMs);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.fd == listener)
+                AcceptConnections (epollFD, listener);
+            else if (events[i].data.fd == datagramSocket)
+                ServiceDatagrams (datagramSocket);
+            else if (Connections[events[i].data.fd].Socket >= 0)
+                ServiceConnection (epollFD, &Connections[events[i].data.fd]);
+        }
+
+        unsigned long long now = NowMs ();
+        if (now - lastSweepMs >= PrintIntervalMs)
+        {
+            for (size_t i = 0; i < Connections.size (); i++)
+            {
+                if ((Connections[i].Socket >= 0) && (now - Connections[i].LastActivityMs >= IdleTimeoutMs))
+                {
+                    Stats.Dropped++;
+                    CloseConnection (epollFD, &Connections[i]);
+                }
+            }
+            lastSweepMs = now;
+        }
+
+        if (LeaderboardChanged && (now - lastPrintMs >= PrintIntervalMs))
+        {
+            if (quiet == false)
+            {
+                printf ("\n%s", FormatLeaderboard (PrintPlaces).c_str ());
+                fflush (stdout);
+            }
+            if (CSVFile != NULL)
+                fflush (CSVFile);
+            LeaderboardChanged = false;
+            lastPrintMs = now;
+        }
+    }
+
+    double seconds = NowMs () / 1000.0;
+    printf ("\nFinal leaderboard\n%s", FormatLeaderboard (0).c_str ());
+    printf ("%llu requests on %llu connections and %llu datagrams in %.1f s (%.0f messages/s)\n", Stats.Requests,
+            Stats.Connections, Stats.Datagrams, seconds, (seconds > 0) ? (Stats.Requests + Stats.Datagrams) / seconds : 0.0);
+
+    if (CSVFile != NULL)
+        fclose (CSVFile);
+    close (epollFD);
+    close (listener);
+    if (datagramSocket >= 0)
+        close (datagramSocket);
+    return (0);
+}
@@ -0,0 +1,405 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Issues board IDs. Replaces Fingerprints.pl, which made 10 IDs for each of 10
+// fingerprints and could only go so far before its duplicate check (a grep
+// over every ID so far) got in the way.
+//
+// IDs are drawn at random from every ID with the right fingerprint, the same
+// number for each fingerprint, and are never repeated. Check bytes come from
+// CRSCConfigClass itself, so an ID this makes is an ID the board accepts.
+// Fingerprints are shared out over all the cores. Each one has its own random
+// stream seeded from the seed and the fingerprint, so the output depends only
+// on the options and not on how many threads ran.
+//
+// Usage: CRSCIDGen [options]
+//   -n count     IDs per fingerprint (default 10)
+//   -f prints    comma separated fingerprints as bit strings, most significant
+//                first (default every fingerprint). The 2019 set was
+//                -f 0010,0011,0100,0101,0110,1001,1010,1011,1100,1101
+//   -s seed      random seed (default 1)
+//   -t threads   worker threads (default one per core)
+//   -x file      don't issue any ID listed in file, a CSV from an earlier run
+//   -c file      write CSV - fingerprint,board ID,packed ID - to file ("-" for stdout)
+//   -b file      write the packed IDs to file in the binary format below
+//
+// With neither -c nor -b the CSV goes to stdout.
+//
+// Binary format, little endian: "CRSCIDS" and a 0, then uint32 version (1),
+// uint32 data characters per ID, uint32 count, then count uint32 packed IDs
+// grouped by fingerprint.
+
+#include <Arduino.h>
+
+#include "CRSCConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <unistd.h>
+
+// The IDs issued for one fingerprint
+typedef struct
+{
+    unsigned long Fingerprint;
+    std::vector<uint32_t> PackedIDs;
+    bool Okay;
+} FingerprintIDs_t;
+
+static const char IDChars[] = BOARD_ID_CHARS;
+
+// ----------------------------------------------------------------------
+// The characters whose low bit is the given bit, which is what decides a
+// character's contribution to the fingerprint
+static std::vector<unsigned> DigitsWithLowBit (unsigned theBit)
+{
+    std::vector<unsigned> digits;
+
+    for (unsigned i = 0; i < BOARD_ID_RADIX; i++)
+    {
+        if (((unsigned char)IDChars[i] & 0x01) == theBit)
+            digits.push_back (i);
+    }
+    return (digits);
+}
+
+// ----------------------------------------------------------------------
+// Issue count IDs for one fingerprint, none of them in excluded. The IDs with a
+// given fingerprint are numbered 0 .. spaceSize-1 as a mixed radix number, one
+// digit per character position, so picking an ID is picking a number.
+static void IssueIDs (FingerprintIDs_t* theIDs, unsigned count, unsigned long seed,
+                      const std::unordered_set<uint32_t>* excluded)
+{
+    std::vector<unsigned> positionDigits[BOARD_ID_BYTES];
+    unsigned long long spaceSize = 1;
+
+    for (int i = 0; i < BOARD_ID_BYTES; i++)
+    {
+        unsigned theBit = (theIDs->Fingerprint >> (BOARD_ID_BYTES - 1 - i)) & 0x01;
+        positionDigits[i] = DigitsWithLowBit (theBit);
+        spaceSize *= positionDigits[i].size ();
+    }
+
+    // Turn an index into a packed ID. The first character is the most significant
+    // digit of the packed ID, as in CRSCConfigClass::PackBoardID().
+    auto packed = [&] (unsigned long long index) -> uint32_t
+    {
+        uint32_t packedID = 0;
+        uint32_t weight = 1;
+        for (int i = BOARD_ID_BYTES - 1; i >= 0; i--)
+        {
+            unsigned radix = positionDigits[i].size ();
+            packedID += positionDigits[i][index % radix] * weight;
+            index /= radix;
+            weight *= BOARD_ID_RADIX;
+        }
+        return (packedID);
+    };
+
+    std::mt19937_64 generator (seed * 1000003ULL + theIDs->Fingerprint);
+    theIDs->PackedIDs.clear ();
+    theIDs->PackedIDs.reserve (count);
+    theIDs->Okay = true;
+
+    if ((unsigned long long)count * 2 > spaceSize)
+    {
+        // Asking for most of the space - shuffle all of it and take from the front
+        std::vector<uint32_t> everyID;
+        everyID.reserve (spaceSize);
+        for (unsigned long long index = 0; index < spaceSize; index++)
+        {
+            uint32_t packedID = packed (index);
+            if (excluded->count (packedID) == 0)
+                everyID.push_back (packedID);
+        }
+        std::shuffle (everyID.begin (), everyID.end (), generator);
+
+        if (everyID.size () < count)
+        {
+            theIDs->Okay = false;
+            count = everyID.size ();
+        }
+        theIDs->PackedIDs.assign (everyID.begin (), everyID.begin () + count);
+    }
+    else
+    {
+        // Plenty of room - draw at random and throw back anything already used
+        std::unordered_set<uint32_t> issued;
+        std::uniform_int_distribution<unsigned long long> pick (0, spaceSize - 1);
+        unsigned long long draws = 0;
+
+        issued.reserve (count * 2);
+        while ((theIDs->PackedIDs.size () < count) && (draws < spaceSize * 4))
+        {
+            uint32_t packedID = packed (pick (generator));
+            draws++;
+
+            if ((excluded->count (packedID) == 0) && issued.insert (packedID).second)
+                theIDs->PackedIDs.push_back (packedID);
+        }
+        theIDs->Okay = (theIDs->PackedIDs.size () == count);
+    }
+}
+
+// ----------------------------------------------------------------------
+// Parse a fingerprint written as a bit string, most significant bit first
+static bool ParseFingerprint (const char* text, size_t length, unsigned long* thePrint)
+{
+    if (length != (size_t)CRSCGame::FingerprintBits)
+        return (false);
+
+    *thePrint = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        if ((text[i] != '0') && (text[i] != '1'))
+            return (false);
+        *thePrint = (*thePrint << 1) | (text[i] - '0');
+    }
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+// Read the board IDs out of a CSV written by an earlier run
+static bool ReadExcluded (const char* fileName, CRSCConfigClass* config, std::unordered_set<uint32_t>* excluded)
+{
+    FILE* theFile = fopen (fileName, "r");
+    char line[128];
+
+    if (theFile == NULL)
+        return (false);
+
+    while (fgets (line, sizeof (line), theFile) != NULL)
+    {
+        // The board ID is the second field
+        char* id = strchr (line, ',');
+        uint32_t packedID;
+
+        if (id == NULL)
+            continue;
+        id++;
+        id[strcspn (id, ",\r\n")] = 0x00;
+
+        if (config->PackBoardID (id, &packedID))
+            excluded->insert (packedID);
+    }
+    fclose (theFile);
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+static bool WriteCSV (const char* fileName, CRSCConfigClass* config, std::vector<FingerprintIDs_t>* allIDs)
+{
+    FILE* theFile = (strcmp (fileName, "-") == 0) ? stdout : fopen (fileName, "w");
+    char theID[BOARD_ID_BUF_LEN];
+    char thePrint[CRSCGame::FingerprintBits + 1];
+
+    if (theFile == NULL)
+        return (false);
+
+    fprintf (theFile, "fingerprint,board_id,packed_id\n");
+    for (size_t f = 0; f < allIDs->size (); f++)
+    {
+        FingerprintIDs_t* theIDs = &(*allIDs)[f];
+
+        for (int i = 0; i < CRSCGame::FingerprintBits; i++)
+            thePrint[i] = ((theIDs->Fingerprint >> (CRSCGame::FingerprintBits - 1 - i)) & 0x01) ? '1' : '0';
+        thePrint[CRSCGame::FingerprintBits] = 0x00;
+
+        for (size_t i = 0; i < theIDs->PackedIDs.size (); i++)
+        {
+            config->UnpackBoardID (theIDs->PackedIDs[i], theID);
+            fprintf (theFile, "%s,%s,%lu\n", thePrint, theID, (unsigned long)theIDs->PackedIDs[i]);
+        }
+    }
+
+    bool returnValue = (ferror (theFile) == 0);
+    if (theFile != stdout)
+        returnValue &= (fclose (theFile) == 0);
+    return (returnValue);
+}
+
+// ----------------------------------------------------------------------
+static void PutLittleEndian (std::vector<uint8_t>* buffer, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        buffer->push_back ((value >> (8 * i)) & 0xff);
+}
+
+static bool WriteBinary (const char* fileName, std::vector<FingerprintIDs_t>* allIDs)
+{
+    std::vector<uint8_t> buffer;
+    uint32_t count = 0;
+
+    for (size_t f = 0; f < allIDs->size (); f++)
+        count += (*allIDs)[f].PackedIDs.size ();
+
+    const char magic[8] = {'C', 'R', 'S', 'C', 'I', 'D', 'S', 0};
+    buffer.insert (buffer.end (), magic, magic + sizeof (magic));
+    PutLittleEndian (&buffer, 1);
+    PutLittleEndian (&buffer, BOARD_ID_BYTES);
+    PutLittleEndian (&buffer, count);
+
+    for (size_t f = 0; f < allIDs->size (); f++)
+    {
+        for (size_t i = 0; i < (*allIDs)[f].PackedIDs.size (); i++)
+            PutLittleEndian (&buffer, (*allIDs)[f].PackedIDs[i]);
+    }
+
+    FILE* theFile = fopen (fileName, "wb");
+    if (theFile == NULL)
+        return (false);
+
+    bool returnValue = (fwrite (buffer.data (), 1, buffer.size (), theFile) == buffer.size ());
+    returnValue &= (fclose (theFile) == 0);
+    return (returnValue);
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCIDGen [-n count] [-f prints] [-s seed] [-t threads] [-x file] [-c file] [-b file]\n");
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned count = 10;
+    unsigned long seed = 1;
+    unsigned numThreads = std::thread::hardware_concurrency ();
+    const char* printList = NULL;
+    const char* excludeFile = NULL;
+    const char* csvFile = NULL;
+    const char* binaryFile = NULL;
+    int option;
+
+    while ((option = getopt (argc, argv, "n:f:s:t:x:c:b:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': count = strtoul (optarg, NULL, 10); break;
+            case 'f': printList = optarg; break;
+            case 's': seed = strtoul (optarg, NULL, 10); break;
+            case 't': numThreads = strtoul (optarg, NULL, 10); break;
+            case 'x': excludeFile = optarg; break;
+            case 'c': csvFile = optarg; break;
+            case 'b': binaryFile = optarg; break;
+            default:  Usage (); return (2);
+        }
+    }
+
+    if ((csvFile == NULL) && (binaryFile == NULL))
+        csvFile = "-";
+    if (numThreads == 0)
+        numThreads = 1;
+
+    // Checking IDs and packing them is the configuration's job
+    CRSCConfigClass config;
+
+    // Which fingerprints to issue IDs for
+    std::vector<FingerprintIDs_t> allIDs;
+    if (printList == NULL)
+    {
+        for (unsigned long thePrint = 0; thePrint < (1UL << CRSCGame::FingerprintBits); thePrint++)
+            allIDs.push_back ({thePrint, {}, true});
+    }
+    else
+    {
+        const char* text = printList;
+        while (*text != 0x00)
+        {
+            size_t length = strcspn (text, ",");
+            unsigned long thePrint;
+
+            if (ParseFingerprint (text, length, &thePrint) == false)
+            {
+                fprintf (stderr, "Bad fingerprint '%.*s' - expected %d bits\n", (int)length, text, CRSCGame::FingerprintBits);
+                return (2);
+            }
+            allIDs.push_back ({thePrint, {}, true});
+
+            text += length;
+            if (*text == ',')
+                text++;
+        }
+    }
+
+    std::unordered_set<uint32_t> excluded;
+    if ((excludeFile != NULL) && (ReadExcluded (excludeFile, &config, &excluded) == false))
+    {
+        fprintf (stderr, "Can't read %s\n", excludeFile);
+        return (1);
+    }
+
+    // Share the fingerprints out over the threads
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < numThreads; t++)
+    {
+        workers.push_back (std::thread ([&, t] ()
+        {
+            for (size_t f = t; f < allIDs.size (); f += numThreads)
+                IssueIDs (&allIDs[f], count, seed, &excluded);
+        }));
+    }
+    for (size_t t = 0; t < workers.size (); t++)
+        workers[t].join ();
+
+    double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+    unsigned long total = 0;
+    bool okay = true;
+    for (size_t f = 0; f < allIDs.size (); f++)
+    {
+        total += allIDs[f].PackedIDs.size ();
+        if (allIDs[f].Okay == false)
+        {
+            fprintf (stderr, "Only %u unused IDs have fingerprint %lu\n", (unsigned)allIDs[f].PackedIDs.size (), allIDs[f].Fingerprint);
+            okay = false;
+        }
+    }
+    fprintf (stderr, "%lu IDs for %u fingerprints in %.1f ms on %u threads\n", total, (unsigned)allIDs.size (),
+             seconds * 1000.0, numThreads);
+
+    if ((csvFile != NULL) && (WriteCSV (csvFile, &config, &allIDs) == false))
+    {
+        fprintf (stderr, "Can't write %s\n", csvFile);
+        return (1);
+    }
+    if ((binaryFile != NULL) && (WriteBinary (binaryFile, &allIDs) == false))
+    {
+        fprintf (stderr, "Can't write %s\n", binaryFile);
+        return (1);
+    }
+
+    return (okay ? 0 : 1);
+}
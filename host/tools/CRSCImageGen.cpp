@@ -0,0 +1,324 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Builds a ready-to-flash configuration image for each board, so a board can be
+// provisioned with one flash write instead of running CRSCLoaderSketch and
+// typing its ID in over serial.
+//
+// Each image covers the journal sectors and the emulated EEPROM sector. The
+// journal part is left erased, so nothing from a board's earlier life gets played
+// back over the new configuration, and the EEPROM sector holds config_t and its
+// checksum exactly as CRSCConfigClass::Write() leaves them. The game sketch loads
+// it as it is. Flash the game sketch, then the image:
+//
+//   esptool.py write_flash <offset> <board ID>.bin
+//
+// The offset is printed, and written to the manifest. It assumes the 4 MB
+// NodeMCU layout with no file system, where the EEPROM sector is at 0x3fb000;
+// use -e to give the EEPROM address for a different layout.
+//
+// Usage: CRSCImageGen -s ssid -p password -k key [options] idfile
+//   -s ssid      Wifi SSID
+//   -p password  Wifi password
+//   -k key       IFTTT key
+//   -c [udp://]host[:port]  send notifications to a CRSCCollector instead of
+//                ifttt.com (port 80 if none is given), as datagrams with udp://
+//   -o dir       where to write the images (default .)
+//   -e address   flash address of the EEPROM sector (default 0x3fb000)
+//   -t threads   worker threads (default one per core)
+//
+// idfile has one board ID per line, or is a CSV from CRSCIDGen. Images are
+// named after the board ID, and manifest.csv in the output directory lists
+// board ID, image file and flash offset.
+
+#include <Arduino.h>
+#include <HostShim.h>
+
+#include "CRSCConfig.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// What goes in every board's configuration, apart from its ID
+typedef struct
+{
+    const char* WifiSSID;
+    const char* WifiPassword;
+    const char* IFTTTKey;
+    char CollectorHost[COLLECTOR_HOST_LEN];
+    uint16_t CollectorPort;
+    uint8_t CollectorTransport;
+} ImageSettings_t;
+
+// ----------------------------------------------------------------------
+// Fill in the configuration the way CRSCConfigClass::Initialize() followed by
+// SetBoardID() does, and lay it out the way Write() does
+static void BuildImage (ImageSettings_t* settings, const char* theID, uint8_t* image, size_t imageSize)
+{
+    config_t theConfiguration;
+    size_t eepromOffset = CONFIG_JOURNAL_SECTORS * SPI_FLASH_SEC_SIZE;
+
+    memset (&theConfiguration, 0, sizeof (theConfiguration));
+    strncpy (theConfiguration.WifiSSID, settings->WifiSSID, WIFI_SSID_LEN - 1);
+    strncpy (theConfiguration.WifiPassword, settings->WifiPassword, WIFI_PASSWORD_LEN - 1);
+    strncpy (theConfiguration.IFTTTKey, settings->IFTTTKey, IFTTT_KEY_LEN - 1);
+    memcpy (theConfiguration.MyBoardID, theID, BOARD_ID_LEN);
+    theConfiguration.NumScavengedBoards = 0;
+    theConfiguration.HuntComplete = false;
+    strncpy (theConfiguration.CollectorHost, settings->CollectorHost, COLLECTOR_HOST_LEN);
+    theConfiguration.CollectorPort = settings->CollectorPort;
+    theConfiguration.CollectorTransport = settings->CollectorTransport;
+
+    // Erased flash everywhere else
+    memset (image, 0xff, imageSize);
+    memcpy (image + eepromOffset, &theConfiguration, sizeof (theConfiguration));
+    image[eepromOffset + sizeof (theConfiguration)] = CRSCConfigClass::CalculateChecksum (&theConfiguration);
+}
+
+// ----------------------------------------------------------------------
+// Check an image the way the board will: put it in the host flash where the
+// board keeps its configuration and load it
+static bool VerifyImage (const uint8_t* image, size_t imageSize, const char* theID)
+{
+    HostFlashEraseAll ();
+    memcpy (HostFlashData () + (HOST_EEPROM_SECTOR - CONFIG_JOURNAL_SECTORS) * SPI_FLASH_SEC_SIZE, image, imageSize);
+
+    CRSCConfigClass config;
+    return (config.Load () && (strcmp (config.GetBoardID (), theID) == 0) &&
+            (config.GetNumScavengedBoardIDs () == 0));
+}
+
+// ----------------------------------------------------------------------
+// Pull the board IDs out of the ID file. Any field of a line that is a valid
+// ID counts, so plain lists and CRSCIDGen CSVs both work.
+static bool ReadIDs (const char* fileName, CRSCConfigClass* config, std::vector<std::string>* theIDs)
+{
+    FILE* theFile = fopen (fileName, "r");
+    char line[256];
+    unsigned lineNumber = 0;
+    unsigned badLines = 0;
+
+    if (theFile == NULL)
+        return (false);
+
+    while (fgets (line, sizeof (line), theFile) != NULL)
+    {
+        bool found = false;
+        bool blank = (strspn (line, "\r\n \t") == strlen (line));
+        lineNumber++;
+
+        for (char* field = strtok (line, ",\r\n \t"); field != NULL; field = strtok (NULL, ",\r\n \t"))
+        {
+            char checkBytes[BOARD_ID_CHECK_BYTES];
+
+            if (strlen (field) != (size_t)BOARD_ID_LEN)
+                continue;
+
+            config->CalculateCheckBytes (field, checkBytes);
+            if (memcmp (checkBytes, field + BOARD_ID_BYTES, BOARD_ID_CHECK_BYTES) == 0)
+            {
+                theIDs->push_back (field);
+                found = true;
+                break;
+            }
+        }
+
+        // Let a header line through, but nothing else without an ID
+        if ((found == false) && (lineNumber > 1) && (blank == false))
+        {
+            if (badLines++ < 10)
+                fprintf (stderr, "%s:%u: no valid board ID\n", fileName, lineNumber);
+        }
+    }
+    fclose (theFile);
+
+    if (badLines > 10)
+        fprintf (stderr, "%s: %u more lines with no valid board ID\n", fileName, badLines - 10);
+    return (badLines == 0);
+}
+
+// ----------------------------------------------------------------------
+static void Usage (void)
+{
+    fprintf (stderr, "Usage: CRSCImageGen -s ssid -p password -k key [-c [udp://]host[:port]] [-o dir] [-e address] [-t threads] idfile\n");
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    ImageSettings_t settings = {NULL, NULL, NULL, "", 0, COLLECTOR_HTTP};
+    const char* collector = NULL;
+    std::string outputDir = ".";
+    unsigned long eepromAddress = (unsigned long)HOST_EEPROM_SECTOR * SPI_FLASH_SEC_SIZE;
+    unsigned numThreads = std::thread::hardware_concurrency ();
+    int option;
+
+    while ((option = getopt (argc, argv, "s:p:k:c:o:e:t:")) != -1)
+    {
+        switch (option)
+        {
+            case 's': settings.WifiSSID = optarg; break;
+            case 'p': settings.WifiPassword = optarg; break;
+            case 'k': settings.IFTTTKey = optarg; break;
+            case 'c': collector = optarg; break;
+            case 'o': outputDir = optarg; break;
+            case 'e': eepromAddress = strtoul (optarg, NULL, 0); break;
+            case 't': numThreads = strtoul (optarg, NULL, 10); break;
+            default:  Usage (); return (2);
+        }
+    }
+
+    if ((settings.WifiSSID == NULL) || (settings.WifiPassword == NULL) || (settings.IFTTTKey == NULL) ||
+        (optind != argc - 1))
+    {
+        Usage ();
+        return (2);
+    }
+
+    // The board's fields don't have to be terminated when full, but the sketch
+    // prints them as strings, so insist on room for the terminator
+    if ((strlen (settings.WifiSSID) >= WIFI_SSID_LEN) || (strlen (settings.WifiPassword) >= WIFI_PASSWORD_LEN) ||
+        (strlen (settings.IFTTTKey) >= IFTTT_KEY_LEN))
+    {
+        fprintf (stderr, "SSID, password and key can be at most %d, %d and %d characters\n",
+                 WIFI_SSID_LEN - 1, WIFI_PASSWORD_LEN - 1, IFTTT_KEY_LEN - 1);
+        return (2);
+    }
+
+    // Same rules as the C command: host up to COLLECTOR_HOST_LEN - 1 characters,
+    // port 80 unless one is given
+    if (collector != NULL)
+    {
+        if (strncasecmp (collector, "udp://", 6) == 0)
+        {
+            settings.CollectorTransport = COLLECTOR_UDP;
+            collector += 6;
+        }
+
+        const char* colon = strchr (collector, ':');
+        size_t hostLength = (colon != NULL) ? (size_t)(colon - collector) : strlen (collector);
+        unsigned long port = (colon != NULL) ? strtoul (colon + 1, NULL, 10) : 80;
+
+        if ((hostLength == 0) || (hostLength >= COLLECTOR_HOST_LEN) || (port == 0) || (port > 65535))
+        {
+            fprintf (stderr, "Collector must be [udp://]host[:port], with the host at most %d characters\n",
+                     COLLECTOR_HOST_LEN - 1);
+            return (2);
+        }
+        memcpy (settings.CollectorHost, collector, hostLength);
+        settings.CollectorPort = (uint16_t)port;
+    }
+
+    if ((eepromAddress % SPI_FLASH_SEC_SIZE != 0) || (eepromAddress < CONFIG_JOURNAL_SECTORS * SPI_FLASH_SEC_SIZE))
+    {
+        fprintf (stderr, "EEPROM address must be a sector boundary above the journal\n");
+        return (2);
+    }
+    if (numThreads == 0)
+        numThreads = 1;
+
+    HostSerialSetOutputEnabled (false);
+
+    CRSCConfigClass config;
+    std::vector<std::string> theIDs;
+    if (ReadIDs (argv[optind], &config, &theIDs) == false)
+        return (1);
+
+    const size_t imageSize = (CONFIG_JOURNAL_SECTORS + 1) * SPI_FLASH_SEC_SIZE;
+    const unsigned long imageAddress = eepromAddress - CONFIG_JOURNAL_SECTORS * SPI_FLASH_SEC_SIZE;
+
+    // Make sure the game sketch will take these before making thousands of them
+    std::vector<uint8_t> image (imageSize);
+    if (theIDs.size () > 0)
+    {
+        BuildImage (&settings, theIDs[0].c_str (), image.data (), imageSize);
+        if (VerifyImage (image.data (), imageSize, theIDs[0].c_str ()) == false)
+        {
+            fprintf (stderr, "CRSCConfigClass won't load the image for %s\n", theIDs[0].c_str ());
+            return (1);
+        }
+    }
+
+    // Share the boards out over the threads
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    std::atomic<size_t> nextBoard (0);
+    std::atomic<unsigned> failures (0);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < numThreads; t++)
+    {
+        workers.push_back (std::thread ([&] ()
+        {
+            std::vector<uint8_t> boardImage (imageSize);
+
+            for (size_t board = nextBoard++; board < theIDs.size (); board = nextBoard++)
+            {
+                std::string fileName = outputDir + "/" + theIDs[board] + ".bin";
+                BuildImage (&settings, theIDs[board].c_str (), boardImage.data (), imageSize);
+
+                FILE* theFile = fopen (fileName.c_str (), "wb");
+                bool written = (theFile != NULL) && (fwrite (boardImage.data (), 1, imageSize, theFile) == imageSize);
+                if (theFile != NULL)
+                    written &= (fclose (theFile) == 0);
+
+                if (written == false)
+                {
+                    fprintf (stderr, "Can't write %s\n", fileName.c_str ());
+                    failures++;
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size (); t++)
+        workers[t].join ();
+
+    double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+    // The manifest says what goes where
+    std::string manifestName = outputDir + "/manifest.csv";
+    FILE* manifest = fopen (manifestName.c_str (), "w");
+    if (manifest == NULL)
+    {
+        fprintf (stderr, "Can't write %s\n", manifestName.c_str ());
+        return (1);
+    }
+    fprintf (manifest, "board_id,image,flash_offset\n");
+    for (size_t board = 0; board < theIDs.size (); board++)
+        fprintf (manifest, "%s,%s.bin,0x%06lx\n", theIDs[board].c_str (), theIDs[board].c_str (), imageAddress);
+    fclose (manifest);
+
+    fprintf (stderr, "%u images in %.1f ms on %u threads - flash each at 0x%06lx\n", (unsigned)theIDs.size (),
+             seconds * 1000.0, numThreads, imageAddress);
+
+    return ((failures == 0) ? 0 : 1);
+}
@@ -0,0 +1,217 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Turns the trace a board prints with the T command into something a person can
+// read. Capture the serial output - a terminal log is fine, anything that isn't
+// a trace line is skipped - and feed it in:
+//
+//   T 3a 000004d2 07 00000000
+//
+// becomes
+//
+//   3a        1.234 s   +1201 ms  wifi_connect      full join
+//
+// Each boot starts a new section, headed with why the board reset. Times are
+// millis() on the board, so they start again from zero at each boot. Where a
+// record is missing from the sequence - one half written when the board went
+// down - the gap is noted.
+//
+// An exception_pc line gives the address the board crashed at. Look it up with
+//   xtensa-lx106-elf-addr2line -e CRSCSketch.ino.elf <address>
+//
+// Usage: CRSCTraceDecode [file ...]
+//   With no files the trace is read from stdin.
+
+#include <Arduino.h>
+
+#include "CRSCTrace.h"
+#include "IFTTTMessage.h"
+
+// ----------------------------------------------------------------------
+static const char* ResetReasonName (uint32_t reason)
+{
+    switch (reason)
+    {
+        case REASON_DEFAULT_RST:      return ("power on");
+        case REASON_WDT_RST:          return ("hardware watchdog");
+        case REASON_EXCEPTION_RST:    return ("exception");
+        case REASON_SOFT_WDT_RST:     return ("software watchdog");
+        case REASON_SOFT_RESTART:     return ("restart");
+        case REASON_DEEP_SLEEP_AWAKE: return ("deep sleep wake");
+        case REASON_EXT_SYS_RST:      return ("reset pin");
+        default:                      return ("unknown reset");
+    }
+}
+
+// The exception causes a sketch is likely to see, from the Xtensa ISA
+static const char* ExceptionCauseName (uint32_t cause)
+{
+    switch (cause)
+    {
+        case 0:  return ("IllegalInstruction");
+        case 2:  return ("InstructionFetchError");
+        case 3:  return ("LoadStoreError");
+        case 4:  return ("Level1Interrupt");
+        case 6:  return ("IntegerDivideByZero");
+        case 9:  return ("LoadStoreAlignment");
+        case 20: return ("InstFetchProhibited");
+        case 28: return ("LoadProhibited");
+        case 29: return ("StoreProhibited");
+        default: return ("");
+    }
+}
+
+static const char* SendResultName (uint32_t result)
+{
+    switch (result)
+    {
+        case IFTTTMessageClass::IFTTT_RESULT_NONE:             return ("none");
+        case IFTTTMessageClass::IFTTT_RESULT_SUCCESS:          return ("delivered");
+        case IFTTTMessageClass::IFTTT_RESULT_CONNECT_FAILED:   return ("connect failed");
+        case IFTTTMessageClass::IFTTT_RESULT_WRITE_FAILED:     return ("write failed");
+        case IFTTTMessageClass::IFTTT_RESULT_TIMEOUT:          return ("timed out");
+        case IFTTTMessageClass::IFTTT_RESULT_BAD_RESPONSE:     return ("bad response");
+        case IFTTTMessageClass::IFTTT_RESULT_HTTP_ERROR:       return ("HTTP error");
+        case IFTTTMessageClass::IFTTT_RESULT_REQUEST_TOO_LONG: return ("request too long");
+        default:                                               return ("unknown result");
+    }
+}
+
+// ----------------------------------------------------------------------
+// Describe the argument of a record, according to its event
+static void DescribeArg (unsigned event, uint32_t arg, char* buf, size_t len)
+{
+    switch (event)
+    {
+        case CRSCTrace::TRACE_BOOT:
+            if ((arg & 0xff) == REASON_EXCEPTION_RST)
+                snprintf (buf, len, "%s %u %s", ResetReasonName (arg & 0xff), (arg >> 8) & 0xff, ExceptionCauseName ((arg >> 8) & 0xff));
+            else
+                snprintf (buf, len, "%s", ResetReasonName (arg & 0xff));
+            break;
+
+        case CRSCTrace::TRACE_EXCEPTION_PC:   snprintf (buf, len, "pc 0x%08x", arg); break;
+        case CRSCTrace::TRACE_SETUP_DONE:     snprintf (buf, len, "configuration %s", arg ? "loaded" : "corrupt"); break;
+        case CRSCTrace::TRACE_COMMAND:
+        case CRSCTrace::TRACE_RESTART:        snprintf (buf, len, "'%c'", isprint (arg) ? (int)arg : '?'); break;
+        case CRSCTrace::TRACE_CONFIG_COMMIT:  snprintf (buf, len, "%u us", arg); break;
+        case CRSCTrace::TRACE_WIFI_CONNECT:   snprintf (buf, len, "%s", (arg == 1) ? "fast rejoin" : ((arg == 2) ? "fast rejoin, new lease" : "full join")); break;
+        case CRSCTrace::TRACE_WIFI_CONNECTED: snprintf (buf, len, "after %u ms", arg); break;
+        case CRSCTrace::TRACE_WIFI_FAILED:    snprintf (buf, len, "next try in %u ms", arg); break;
+        case CRSCTrace::TRACE_SEND_START:     snprintf (buf, len, "sequence %u", arg); break;
+        case CRSCTrace::TRACE_SEND_DONE:      snprintf (buf, len, "%s, HTTP %u", SendResultName (arg & 0xff), (arg >> 8) & 0xffff); break;
+        case CRSCTrace::TRACE_SLOW_TASK:      snprintf (buf, len, "task %u ran %u ms", arg >> 24, arg & 0x00ffffff); break;
+        default:                              snprintf (buf, len, "0x%08x", arg); break;
+    }
+}
+
+// ----------------------------------------------------------------------
+// Decode the trace lines in theFile. Returns the number decoded.
+static unsigned Decode (FILE* theFile)
+{
+    char line[256];
+    unsigned decoded = 0;
+    bool haveLast = false;
+    unsigned lastSequence = 0;
+    uint32_t lastMillis = 0;
+
+    while (fgets (line, sizeof (line), theFile) != NULL)
+    {
+        unsigned sequence, event;
+        uint32_t theMillis, arg;
+        char* start = line;
+
+        while (isspace ((unsigned char)*start))
+            start++;
+        if (sscanf (start, "T %2x %8x %2x %8x", &sequence, &theMillis, &event, &arg) != 4)
+        {
+            // Anything else ends a dump. The next may be from another session.
+            haveLast = false;
+            continue;
+        }
+
+        if (haveLast && (sequence != ((lastSequence + 1) & 0xff)))
+            printf ("   (%u record(s) missing)\n", (sequence - lastSequence - 1) & 0xff);
+
+        if (event == CRSCTrace::TRACE_BOOT)
+        {
+            char reason[64];
+            DescribeArg (event, arg, reason, sizeof (reason));
+            printf ("%s--- boot: %s\n", (decoded > 0) ? "\n" : "", reason);
+            haveLast = false;
+        }
+
+        char detail[64];
+        DescribeArg (event, arg, detail, sizeof (detail));
+
+        if (haveLast && (theMillis >= lastMillis))
+            printf ("%02x %12.3f s %+7ld ms  %-16s %s\n", sequence, theMillis / 1000.0, (long)(theMillis - lastMillis),
+                    CRSCTrace::GetEventName (event), detail);
+        else
+            printf ("%02x %12.3f s %10s  %-16s %s\n", sequence, theMillis / 1000.0, "",
+                    CRSCTrace::GetEventName (event), detail);
+
+        haveLast = true;
+        lastSequence = sequence;
+        lastMillis = theMillis;
+        decoded++;
+    }
+    return (decoded);
+}
+
+// ----------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+    unsigned decoded = 0;
+
+    if (argc < 2)
+    {
+        decoded = Decode (stdin);
+    }
+    else
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            FILE* theFile = fopen (argv[i], "r");
+            if (theFile == NULL)
+            {
+                fprintf (stderr, "Can't open %s\n", argv[i]);
+                return (1);
+            }
+            decoded += Decode (theFile);
+            fclose (theFile);
+        }
+    }
+
+    if (decoded == 0)
+    {
+        fprintf (stderr, "No trace lines found - capture the output of T <security code>\n");
+        return (1);
+    }
+    return (0);
+}
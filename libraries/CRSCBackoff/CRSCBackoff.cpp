@@ -0,0 +1,86 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCBackoff.h"
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCBackoff::CRSCBackoff (unsigned long baseMillis, unsigned long maxMillis)
+{
+    BaseMillis = baseMillis;
+    MaxMillis = maxMillis;
+    Failures = 0;
+    RandomState = 1;
+}
+
+// -----------------------------------------------------------------------------
+// Seed the random part of the waits from theID, typically the board ID
+void CRSCBackoff::Seed (const char* theID)
+{
+    // FNV-1a, which spreads IDs that differ in a single character across the
+    // whole 32 bits
+    uint32_t hash = 2166136261UL;
+
+    while (*theID != 0x00)
+    {
+        hash ^= (uint8_t)*theID++;
+        hash *= 16777619UL;
+    }
+
+    RandomState = (hash != 0) ? hash : 1;
+}
+
+// -----------------------------------------------------------------------------
+// Return the next number from the random number generator (xorshift32)
+uint32_t CRSCBackoff::Random (void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return (RandomState);
+}
+
+// -----------------------------------------------------------------------------
+// Record a failure and return how long to wait before trying again, in
+// milliseconds. The wait is somewhere between half and all of the window,
+// which starts at BaseMillis and doubles with each failure in a row up to
+// MaxMillis. Keeping the first half means a board never comes straight back.
+unsigned long CRSCBackoff::Failed (void)
+{
+    unsigned long window = BaseMillis;
+
+    for (unsigned i = 0; (i < Failures) && (window < MaxMillis); i++)
+        window <<= 1;
+
+    if (window > MaxMillis)
+        window = MaxMillis;
+
+    Failures++;
+
+    return ((window / 2) + (Random() % (window / 2 + 1)));
+}
@@ -0,0 +1,81 @@
+#ifndef _CRSCBACKOFF_H
+#define _CRSCBACKOFF_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+// How long to wait before trying something again after it has failed. The
+// wait doubles with each failure in a row, up to a cap, and a random part of
+// it is left off so that boards which failed together don't all come back
+// together - when a whole session finishes the hunt at once, the access point
+// and ifttt.com see the retries spread out instead of in one burst every
+// interval.
+//
+// The random part comes from a small generator seeded from the board ID, so
+// every board has its own sequence without needing a source of entropy.
+class CRSCBackoff
+{
+protected:
+    // Wait after the first failure, and the most we'll ever wait (milliseconds)
+    unsigned long BaseMillis;
+    unsigned long MaxMillis;
+
+    // How many times in a row we've failed
+    unsigned Failures;
+
+    // State of the random number generator - never 0
+    uint32_t RandomState;
+
+    // Return the next number from the random number generator
+    uint32_t Random (void);
+
+public:
+    // Constructor
+    CRSCBackoff (unsigned long baseMillis, unsigned long maxMillis);
+
+    // Seed the random part of the waits from theID, typically the board ID
+    void Seed (const char* theID);
+
+    // Record a failure and return how long to wait before trying again, in
+    // milliseconds. The wait is somewhere between half and all of the window,
+    // which starts at BaseMillis and doubles with each failure in a row up to
+    // MaxMillis. Keeping the first half means a board never comes straight back.
+    unsigned long Failed (void);
+
+    // Record a success. The next failure waits BaseMillis again.
+    void Succeeded (void)
+        { Failures = 0; }
+
+    // Return how many times in a row we've failed
+    unsigned GetFailures (void)
+        { return (Failures); }
+};
+
+#endif
@@ -0,0 +1,151 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCBanner.h"
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCBanner::CRSCBanner (void)
+{
+    Next = NULL;
+    RunChar = 0x00;
+    RunLeft = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Start printing theBanner, which is in PROGMEM
+void CRSCBanner::Begin (const uint8_t* theBanner)
+{
+    Next = theBanner;
+    RunLeft = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Decode up to theLength characters into theBuffer. Returns the number decoded,
+// which is less than asked for only at the end of the text.
+size_t CRSCBanner::Decode (uint8_t* theBuffer, size_t theLength)
+{
+    size_t returnValue = 0;
+
+    while ((returnValue < theLength) && (Next != NULL))
+    {
+        if (RunLeft > 0)
+        {
+            theBuffer[returnValue++] = RunChar;
+            RunLeft--;
+        }
+        else
+        {
+            uint8_t code = pgm_read_byte (Next++);
+
+            if (code == 0x00)
+            {
+                Next = NULL;
+            }
+            else if (code < 0x80)
+            {
+                theBuffer[returnValue++] = code;
+            }
+            else
+            {
+                RunChar = pgm_read_byte (Next++);
+                RunLeft = code - 0x80 + MinRun;
+            }
+        }
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Print as much as out can take without waiting. Returns true once the whole
+// banner has gone.
+bool CRSCBanner::Update (Print* out)
+{
+    uint8_t buffer[32];
+    int room = out->availableForWrite();
+
+    while ((room > 0) && (Next != NULL))
+    {
+        size_t length = Decode (buffer, ((size_t)room < sizeof (buffer)) ? room : sizeof (buffer));
+        out->write (buffer, length);
+        room -= length;
+    }
+    return (Next == NULL);
+}
+
+// -----------------------------------------------------------------------------
+// Print whatever is left, waiting for out if need be
+void CRSCBanner::Finish (Print* out)
+{
+    uint8_t buffer[32];
+
+    while (Next != NULL)
+        out->write (buffer, Decode (buffer, sizeof (buffer)));
+}
+
+// -----------------------------------------------------------------------------
+// Encode theText into theBuffer, which holds theLength bytes. Returns the
+// number of bytes used, including the terminating 0, or 0 if it didn't fit.
+size_t CRSCBanner::Encode (const char* theText, uint8_t* theBuffer, size_t theLength)
+{
+    size_t used = 0;
+
+    while (*theText != 0x00)
+    {
+        uint8_t c = *theText;
+        unsigned run = 1;
+
+        // Characters with the top bit set would read as run codes
+        if (c >= 0x80)
+            return (0);
+
+        while ((theText[run] == c) && (run < MaxRun))
+            run++;
+
+        if (run >= MinRun)
+        {
+            if (used + 2 > theLength)
+                return (0);
+            theBuffer[used++] = 0x80 + (run - MinRun);
+            theBuffer[used++] = c;
+            theText += run;
+        }
+        else
+        {
+            if (used + 1 > theLength)
+                return (0);
+            theBuffer[used++] = c;
+            theText++;
+        }
+    }
+
+    if (used + 1 > theLength)
+        return (0);
+    theBuffer[used++] = 0x00;
+    return (used);
+}
@@ -0,0 +1,92 @@
+#ifndef _CRSCBANNER_H
+#define _CRSCBANNER_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+// Prints a block of text - the logo at power up - kept run length encoded in
+// PROGMEM. The logo is mostly long runs of the same character, so it takes a
+// third of the flash it would as F() strings.
+//
+// Update() writes only as much as the serial port can take without waiting, so
+// the text goes out a FIFO-full at a time from loop() while the board gets on
+// with everything else, instead of holding up setup() for the 400 ms it takes to
+// send at 115200 baud.
+//
+// The encoding is a byte at a time, ending with a 0:
+//   0x01 - 0x7f    the character itself
+//   0x80 - 0xff    a run - the next byte repeated (code - 0x80 + MinRun) times
+class CRSCBanner
+{
+public:
+    // Runs shorter than this are cheaper left as they are
+    static const unsigned MinRun = 3;
+
+    // Longest run one code can hold
+    static const unsigned MaxRun = 0x7f + MinRun;
+
+protected:
+    // Where we are in the encoded text, in PROGMEM. NULL when there's nothing
+    // left to print.
+    const uint8_t* Next;
+
+    // What's left of the run being printed
+    uint8_t RunChar;
+    unsigned RunLeft;
+
+    // Decode up to theLength characters into theBuffer. Returns the number decoded,
+    // which is less than asked for only at the end of the text.
+    size_t Decode (uint8_t* theBuffer, size_t theLength);
+
+public:
+    // Constructor
+    CRSCBanner (void);
+
+    // Start printing theBanner, which is in PROGMEM
+    void Begin (const uint8_t* theBanner);
+
+    // Print as much as out can take without waiting. Returns true once the whole
+    // banner has gone.
+    bool Update (Print* out);
+
+    // Print whatever is left, waiting for out if need be
+    void Finish (Print* out);
+
+    // Return a flag which, when set, indicates that the whole banner has been printed
+    bool IsDone (void)
+        { return (Next == NULL); }
+
+    // Encode theText into theBuffer, which holds theLength bytes. Returns the
+    // number of bytes used, including the terminating 0, or 0 if it didn't fit.
+    // Used by CRSCBannerGen to build the PROGMEM tables.
+    static size_t Encode (const char* theText, uint8_t* theBuffer, size_t theLength);
+};
+
+#endif
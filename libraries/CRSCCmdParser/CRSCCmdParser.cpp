@@ -30,32 +30,31 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 // --------------------------------------------------------------
-//Skip whitespace in the string
+//Skip whitespace in the line
 void CRSCCmdParser::SkipWhitespace (void)
 {
-    bool done = false;
-    while ((CurrPos < StringPtr->length()) && (done == false))
-    {
-        // You would think from the Arduino docs that isWhitespace()
-        // would be the correct call here, but it isn't. It only detects
-        // spaces and tabs.
-        if (isSpace(StringPtr->charAt (CurrPos)))
-        {
-            CurrPos ++;
-        }
-        else
-        {
-            done = true;
-        }
-    }
+    // You would think from the Arduino docs that isWhitespace()
+    // would be the correct call here, but it isn't. It only detects
+    // spaces and tabs.
+    while ((CurrPos < LineLength) && isSpace(Line[CurrPos]))
+        CurrPos ++;
 }
 	
 	
 // --------------------------------------------------------------
-// Constructor - pass in string
-CRSCCmdParser::CRSCCmdParser (String* theString)
+// Constructor
+CRSCCmdParser::CRSCCmdParser (void)
 {
-    StringPtr = theString;
+    SetLine ("", 0);
+}
+
+// --------------------------------------------------------------
+// Point the parser at a new line of length characters and start parsing it
+// from the beginning. The line must stay put until parsing is finished.
+void CRSCCmdParser::SetLine (const char* line, unsigned length)
+{
+    Line = line;
+    LineLength = length;
     Reset();
 }
 
@@ -71,10 +70,7 @@ void CRSCCmdParser::Reset (void)
 // is more data remaining to parse.
 bool CRSCCmdParser::MoreDataAvailable (void)
 {
-    if (CurrPos < StringPtr->length())
-        return (true);
-    else
-        return (false);
+    return (CurrPos < LineLength);
 }
 
 // --------------------------------------------------------------
@@ -89,10 +85,10 @@ unsigned long CRSCCmdParser::GetUnsignedLong (void)
 	
     SkipWhitespace ();
 	
-    while ((CurrPos < StringPtr->length()) && (haveDigit == true))
+    while ((CurrPos < LineLength) && (haveDigit == true))
     {
         // If we have a number
-        char nextChar = StringPtr->charAt(CurrPos++);
+        char nextChar = Line[CurrPos++];
         if ((nextChar >= '0') && (nextChar <= '9'))
         {
             returnValue = returnValue * 10 + (nextChar - '0');
@@ -114,61 +110,61 @@ char CRSCCmdParser::GetChar (void)
 	
     SkipWhitespace();
 
-    if (CurrPos < StringPtr->length())
-        returnValue = StringPtr->charAt(CurrPos++);
+    if (CurrPos < LineLength)
+        returnValue = Line[CurrPos++];
 
     return (returnValue);
 }
 
 // --------------------------------------------------------------
-// Return a string of length up to maxLen after skipping over whitespace. Return 0x00 if there is
-// no string on the command line. Note that this method scans to the end of the command line
-// or maxLen, whichever comes first, and will 
+// Return the rest of the line, less leading and trailing whitespace, in a buffer of maxLen
+// bytes. Return 0x00 if there is no string on the command line or it won't fit.
 void CRSCCmdParser::GetString (char* theResult, unsigned maxLen)
 {
     SkipWhitespace ();
 
-    if (StringPtr->length() - CurrPos > maxLen)
+    unsigned end = LineLength;
+    while ((end > CurrPos) && isSpace(Line[end - 1]))
+        end--;
+
+    if (end - CurrPos >= maxLen)
     {
         theResult[0] = 0x00;
     }
     else
     {
-        // Use c_str instead of substring() to reduce heap fragmentation caused by 
-        // creating temporary string objects all over the place. MaxLen - 1 because
-        // strings we receive from the serial interface always have a line feed at the end.
-        strncpy (theResult, StringPtr->c_str()+CurrPos, maxLen-1);
-        
         // This is as good a place to change everything to uppercase as any
-        for(char* c = theResult; *c = toupper(*c); ++c) ;
+        unsigned i = 0;
+        while (CurrPos < end)
+            theResult[i++] = toupper (Line[CurrPos++]);
+        theResult[i] = 0x00;
     }
 }
 
 // --------------------------------------------------------------
-// Return a string of length up to maxLen after skipping over leading whitespace and stopping at
-// trailing whitespace. Return 0x00 if there is
-// no string on the command line.
+// Return a string in a buffer of maxLen bytes after skipping over leading whitespace and stopping at
+// trailing whitespace. Return 0x00 if there is no string on the command line or it won't fit.
 void CRSCCmdParser::GetStringToWhitespace (char* theResult, unsigned maxLen)
 {
     SkipWhitespace ();
     
-    bool done = false;
-    int i = 0;
+    unsigned i = 0;
         
-    while ((CurrPos < StringPtr->length()) && (i < maxLen) && (done == false))
+    while ((CurrPos < LineLength) && (isSpace(Line[CurrPos]) == false))
     {
-        if (isSpace(StringPtr->charAt(CurrPos)))
-        {
-             // We're done, terminate the result string and leave
-             theResult[i] = 0x00;
-             done = true;
-        }
-        else
-        {
-             // Copy this character into our result string and move to next
-             theResult[i++] = toupper (StringPtr->charAt(CurrPos++));
-         }
-     }      
+        // Copy this character into our result string and move to next. Keep
+        // going past the end of the buffer so the whole word is used up.
+        if (i < maxLen)
+            theResult[i] = toupper (Line[CurrPos]);
+        i++;
+        CurrPos++;
+    }
+
+    // Too long to be what the caller was looking for
+    if (i >= maxLen)
+        i = 0;
+
+    theResult[i] = 0x00;
 }
 
 // --------------------------------------------------------------
@@ -179,8 +175,65 @@ bool CRSCCmdParser::IsMoreCommandLine (void)
 {
     SkipWhitespace ();
 
-    if (StringPtr->length() > CurrPos)
-        return(true);
-    else
-        return(false);
-}
\ No newline at end of file
+    return (CurrPos < LineLength);
+}
+
+// --------------------------------------------------------------
+// Split the rest of the line into whitespace separated tokens in one pass. The
+// first maxTokens are stored in tokens. Returns how many there were, which can
+// be more than maxTokens.
+unsigned CRSCCmdParser::Tokenize (CmdToken_t* tokens, unsigned maxTokens)
+{
+    unsigned returnValue = 0;
+
+    SkipWhitespace ();
+
+    while (CurrPos < LineLength)
+    {
+        unsigned start = CurrPos;
+
+        while ((CurrPos < LineLength) && (isSpace(Line[CurrPos]) == false))
+            CurrPos++;
+
+        if (returnValue < maxTokens)
+        {
+            tokens[returnValue].Start = Line + start;
+            tokens[returnValue].Length = CurrPos - start;
+        }
+        returnValue++;
+
+        SkipWhitespace ();
+    }
+    return (returnValue);
+}
+
+// --------------------------------------------------------------
+// Return a flag which, when set, indicates that the token matches text,
+// ignoring case
+bool CRSCCmdParser::TokenEquals (const CmdToken_t* token, const char* text)
+{
+    unsigned i = 0;
+
+    while ((i < token->Length) && (toupper(token->Start[i]) == toupper(text[i])))
+        i++;
+
+    return ((i == token->Length) && (text[i] == 0x00));
+}
+
+// --------------------------------------------------------------
+// Copy a token, in uppercase, into a buffer of maxLen bytes. If it won't fit
+// the result is 0x00 and false is returned.
+bool CRSCCmdParser::CopyToken (const CmdToken_t* token, char* theResult, unsigned maxLen)
+{
+    bool returnValue = (token->Length < maxLen);
+    unsigned i = 0;
+
+    if (returnValue == true)
+    {
+        for (i = 0; i < token->Length; i++)
+            theResult[i] = toupper (token->Start[i]);
+    }
+    theResult[i] = 0x00;
+
+    return (returnValue);
+}
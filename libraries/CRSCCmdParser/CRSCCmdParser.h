@@ -29,25 +29,39 @@ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <arduino.h>
+#include <Arduino.h>
+
+// A word on the command line. It points into the line being parsed - nothing
+// is copied, so it's only good for as long as the line is.
+typedef struct
+{
+    const char* Start;
+    unsigned Length;
+} CmdToken_t;
 
 class CRSCCmdParser
 {
 protected:
 
-    //Pointer to the string we're parsing
-    String* StringPtr;
+    // The line we're parsing. This is a view into someone else's buffer - the
+    // parser never copies or owns it.
+    const char* Line;
+    unsigned LineLength;
 	
-    //Storage for the current position in the string
-    int CurrPos;
+    //Storage for the current position in the line
+    unsigned CurrPos;
 	
-    //Skip whitespace in the string
+    //Skip whitespace in the line
     void SkipWhitespace (void);
     
 public:
 
-    // Constructor - pass in string
-    CRSCCmdParser (String* theString);
+    // Constructor
+    CRSCCmdParser (void);
+	
+    // Point the parser at a new line of length characters and start parsing it
+    // from the beginning. The line must stay put until parsing is finished.
+    void SetLine (const char* line, unsigned length);
 	
     // Function to terminate current parsing activities and restart
     void Reset (void);
@@ -65,12 +79,12 @@ public:
     // characters, return 0x00
     char GetChar (void);
 	
-    // Return a string of length up to maxLen after skipping over whitespace. Return 0x00 if there is
-    // no string on the command line.
+    // Return the rest of the line, less leading and trailing whitespace, in a buffer of maxLen
+    // bytes. Return 0x00 if there is no string on the command line or it won't fit.
     void GetString (char* theResult, unsigned maxLen);
     
-    // Return a string of length up to maxLen after skipping over leading whitespace and stopping at
-    // trailing whitespace. Return 0x00 if there is no string on the command line.
+    // Return a string in a buffer of maxLen bytes after skipping over leading whitespace and stopping at
+    // trailing whitespace. Return 0x00 if there is no string on the command line or it won't fit.
     void GetStringToWhitespace (char* theResult, unsigned maxLen);
     
     // Skips over whitespace until either a non-whitespace character or the end of the buffer is encountered. Return
@@ -78,6 +92,19 @@ public:
     // to ensure that there are no unexpected parameters.
     bool IsMoreCommandLine (void);
 
+    // Split the rest of the line into whitespace separated tokens in one pass. The
+    // first maxTokens are stored in tokens. Returns how many there were, which can
+    // be more than maxTokens.
+    unsigned Tokenize (CmdToken_t* tokens, unsigned maxTokens);
+
+    // Return a flag which, when set, indicates that the token matches text,
+    // ignoring case
+    static bool TokenEquals (const CmdToken_t* token, const char* text);
+
+    // Copy a token, in uppercase, into a buffer of maxLen bytes. If it won't fit
+    // the result is 0x00 and false is returned.
+    static bool CopyToken (const CmdToken_t* token, char* theResult, unsigned maxLen);
+
 };
 
 
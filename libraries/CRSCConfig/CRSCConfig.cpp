@@ -27,20 +27,52 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <CRSCConfig.h>
+#include <CRSCConsole.h>
+#include <CRSCTrace.h>
 #include <EEPROM.h>
 #include <Arduino.h>
 
+// The flash sector the core keeps the emulated EEPROM in. The journal sits in
+// the CONFIG_JOURNAL_SECTORS sectors below it, which is where the core puts the
+// end of the file system - so it can only be used with a layout that has none.
+// The file system sectors run from CONFIG_FS_START_SECTOR up to, but not
+// including, CONFIG_FS_END_SECTOR.
+#ifdef HOST_EEPROM_SECTOR
+#define CONFIG_EEPROM_SECTOR HOST_EEPROM_SECTOR
+#define CONFIG_FS_START_SECTOR HOST_FS_START_SECTOR
+#define CONFIG_FS_END_SECTOR HOST_FS_END_SECTOR
+#else
+extern "C" uint32_t _EEPROM_start;
+extern "C" uint32_t _FS_start;
+extern "C" uint32_t _FS_end;
+#define CONFIG_EEPROM_SECTOR ((((uint32_t)&_EEPROM_start) - 0x40200000) / SPI_FLASH_SEC_SIZE)
+#define CONFIG_FS_START_SECTOR ((((uint32_t)&_FS_start) - 0x40200000) / SPI_FLASH_SEC_SIZE)
+#define CONFIG_FS_END_SECTOR ((((uint32_t)&_FS_end) - 0x40200000) / SPI_FLASH_SEC_SIZE)
+#endif
+
+// The configuration and its checksum have to fit in the EEPROM sector
+static_assert (sizeof (config_t) + 1 <= SPI_FLASH_SEC_SIZE, "config_t is too big for the EEPROM sector");
+
 // ----------------------------------------------------------------------
 // Return the one's complement checksum of the configuration structure. This
 // checksum is stored in EEPROM along with the configuration itself. The one's complement
 // stops zeroed-out EEPROM from being taken as valid.
 unsigned char CRSCConfigClass::CalculateChecksum (void)
 {
-	unsigned char* configurationBytes = (unsigned char*)&TheConfiguration;
+	return (CalculateChecksum (&TheConfiguration));
+}
+
+// ----------------------------------------------------------------------
+// Return the one's complement checksum of a configuration structure, as it's
+// stored after the structure in EEPROM. Public so host tools can build
+// EEPROM images the board will accept.
+unsigned char CRSCConfigClass::CalculateChecksum (config_t* theConfiguration)
+{
+	unsigned char* configurationBytes = (unsigned char*)theConfiguration;
 	
 	unsigned char returnValue = 0;
 	
-	for (int i = 0; i < sizeof(TheConfiguration); i++)
+	for (size_t i = 0; i < sizeof(config_t); i++)
 	{
 		returnValue += *configurationBytes++;
 	}
@@ -68,7 +100,7 @@ unsigned long CRSCConfigClass::CalculateFingerprint (char* theID)
 {   
     unsigned long thePrint = 0;
  	
-    for (int i = 0; i < BOARD_ID_BYTES; i++)
+    for (int i = 0; i < CRSCGame::FingerprintBits; i++)
     {
         thePrint = thePrint << 1;
         if (*(theID+i) & 0x01)
@@ -80,9 +112,23 @@ unsigned long CRSCConfigClass::CalculateFingerprint (char* theID)
     return (thePrint);
 }
 
+// ----------------------------------------------------------------------
+// Return a flag which, when set, indicates that the journal's sectors are clear
+// of the file system. The linker symbols aren't known until link time, so this
+// can't be a static_assert.
+bool CRSCConfigClass::JournalFits (void)
+{
+    uint32_t journalStart = CONFIG_EEPROM_SECTOR - CONFIG_JOURNAL_SECTORS;
+    uint32_t fsStart = CONFIG_FS_START_SECTOR;
+    uint32_t fsEnd = CONFIG_FS_END_SECTOR;
+
+    return ((fsStart >= fsEnd) || (journalStart >= fsEnd) || (CONFIG_EEPROM_SECTOR <= fsStart));
+}
+
 // ----------------------------------------------------------------------
 // Constructor - allocate EEPROM space
 CRSCConfigClass::CRSCConfigClass (void)
+    : Journal (CONFIG_EEPROM_SECTOR - CONFIG_JOURNAL_SECTORS, CONFIG_JOURNAL_SECTORS)
 {
     // Clear the configuration structure. Not strictly necessary as it's
     // done in Initialize(), but just in case someone changes the code later ...
@@ -94,6 +140,16 @@ CRSCConfigClass::CRSCConfigClass (void)
     
     WifiTestModeActive = false;
 
+    NumPendingRecords = 0;
+    WritePending = false;
+    RetireJournalPending = false;
+    FirstChangeMillis = 0;
+    WriteBackWindow = 0;
+    Commits = 0;
+    CommitsAvoided = 0;
+    JournalEnabled = JournalFits();
+    Metrics = NULL;
+
 }
 		
 
@@ -135,7 +191,7 @@ bool CRSCConfigClass::Read(void)
 	
     // Read the stored checksum
     readAddr += sizeof (config_t);
-    unsigned char storedChecksum;
+    unsigned char storedChecksum = 0;
     EEPROM.get (readAddr, storedChecksum);
 
     if (checksum != storedChecksum)
@@ -144,56 +200,321 @@ bool CRSCConfigClass::Read(void)
     return (returnValue);
 }
 
+// ----------------------------------------------------------------------
+// Play back the journal on top of the configuration just read from EEPROM. Records
+// go through the same checks as a new ID would, so replaying one that's already
+// in the configuration - because we lost power between writing the full
+// configuration and starting a new journal - does no harm.
+void CRSCConfigClass::ReplayJournal (void)
+{
+    journal_record_t theRecord;
+    char theID[BOARD_ID_BUF_LEN];
+    uint32_t theSequence;
+
+    if (JournalEnabled == false)
+        return;
+
+    Journal.Begin();
+
+    while (Journal.ReadNext (&theRecord))
+    {
+        if (theRecord.Type == CONFIG_RECORD_SCAVENGED_ID)
+        {
+            memcpy (theID, theRecord.Payload, BOARD_ID_LEN);
+            theID[BOARD_ID_LEN] = 0x00;
+            AcceptScavengedID (theID);
+        }
+        else if (theRecord.Type == CONFIG_RECORD_HUNT_COMPLETE)
+        {
+            TheConfiguration.HuntComplete = true;
+        }
+        else if (theRecord.Type == CONFIG_RECORD_MESSAGE_QUEUED)
+        {
+            memcpy (&theSequence, theRecord.Payload, sizeof (theSequence));
+            AcceptQueuedMessage (theSequence, theRecord.Payload[sizeof (theSequence)]);
+        }
+        else if (theRecord.Type == CONFIG_RECORD_MESSAGE_SENT)
+        {
+            memcpy (&theSequence, theRecord.Payload, sizeof (theSequence));
+            AcceptSentMessage (theSequence);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------
+// Bookkeeping after a change has been queued. wasDirty is whether there
+// were already changes waiting.
+void CRSCConfigClass::ChangeQueued (bool wasDirty)
+{
+    if (wasDirty == true)
+        CommitsAvoided++;
+    else
+        FirstChangeMillis = millis();
+
+    if (WriteBackWindow == 0)
+        Flush();
+}
+
+// ----------------------------------------------------------------------
+// Record a change in the journal at the next flush. Nothing needs recording if
+// the whole configuration is going to be written anyway.
+void CRSCConfigClass::QueueRecord (unsigned char theType, const void* thePayload, size_t payloadLen)
+{
+    // Without a journal every change is a full write
+    if (JournalEnabled == false)
+    {
+        QueueWrite (false);
+        return;
+    }
+
+    bool wasDirty = IsDirty();
+
+    if (WritePending == false)
+    {
+        // Can't happen with the list as big as it is, but don't overrun it
+        if (NumPendingRecords >= sizeof (PendingRecords) / sizeof (PendingRecords[0]))
+            Flush();
+
+        journal_record_t* theRecord = &PendingRecords[NumPendingRecords++];
+        memset (theRecord, 0, sizeof (journal_record_t));
+        theRecord->Type = theType;
+        if (payloadLen > 0)
+            memcpy (theRecord->Payload, thePayload, payloadLen);
+    }
+
+    ChangeQueued (wasDirty);
+}
+
+// ----------------------------------------------------------------------
+// Write the whole configuration at the next flush, retiring the journal
+// first if retireJournal is set. Any records waiting are covered by the write.
+void CRSCConfigClass::QueueWrite (bool retireJournal)
+{
+    bool wasDirty = IsDirty();
+
+    WritePending = true;
+    RetireJournalPending |= (retireJournal && JournalEnabled);
+    NumPendingRecords = 0;
+
+    ChangeQueued (wasDirty);
+}
+
+// ----------------------------------------------------------------------
+// Write back any changes now. Call before anything that resets the board.
+void CRSCConfigClass::Flush (void)
+{
+    if (IsDirty() == true)
+    {
+        unsigned long startMicros = micros();
+
+        // Retire the journal before writing, so none of the old changes can be
+        // played back on top of the new configuration
+        if (RetireJournalPending == true)
+        {
+            Journal.Begin();
+            Journal.Reset();
+        }
+
+        if (WritePending == true)
+        {
+            Write();
+        }
+        else if (Journal.Append (PendingRecords, NumPendingRecords) == false)
+        {
+            // The journal is full. Write the whole configuration and start a new
+            // journal - in that order, so a power cut in between leaves every change
+            // in one or the other.
+            Write();
+            Journal.Reset();
+        }
+
+        NumPendingRecords = 0;
+        WritePending = false;
+        RetireJournalPending = false;
+        Commits++;
+
+        unsigned long elapsedMicros = micros() - startMicros;
+        TheTrace.Record (CRSCTrace::TRACE_CONFIG_COMMIT, elapsedMicros);
+        if (Metrics != NULL)
+            Metrics->Record (CRSCMetrics::METRIC_COMMIT_MICROS, elapsedMicros);
+    }
+}
+
+// ----------------------------------------------------------------------
+// Write back any changes whose window has closed. Call once per pass through
+// loop(), or when GetWriteBackDelay() says to.
+void CRSCConfigClass::Update (void)
+{
+    if ((IsDirty() == true) && (millis() - FirstChangeMillis >= WriteBackWindow))
+        Flush();
+}
+
+// ----------------------------------------------------------------------
+// Return how many milliseconds until Update() has changes to write back -
+// 0 if they're due now. Only meaningful while IsDirty() is true.
+unsigned long CRSCConfigClass::GetWriteBackDelay (void)
+{
+    unsigned long returnValue = 0;
+    unsigned long elapsed = millis() - FirstChangeMillis;
+
+    if (elapsed < WriteBackWindow)
+        returnValue = WriteBackWindow - elapsed;
+
+    return (returnValue);
+}
+
 // ----------------------------------------------------------------------
 // Load the configuration from EEPROM. This must be called after the object is
 // created but before any of the other methods can be used. Returns 0 on success and -1
 // if something goes wrong.
 bool CRSCConfigClass::Load (void)
 {
+    // Anything we haven't written yet would be lost
+    Flush();
+
+    if (JournalEnabled == false)
+        TheConsole.println (F("The flash layout has a file system where the journal goes - not journalling changes"));
+
     // Read our configuration from EEPROM
     bool returnValue = Read();
 	
-    // If all is okay, calculate our fingerprint
+    // If all is okay, calculate our fingerprint and catch up on changes made since
+    // the configuration was last written
     if (returnValue == true)
+    {
         Fingerprint = CalculateFingerprint(TheConfiguration.MyBoardID);
+        ReplayJournal();
+    }
 	
     return (returnValue);
 }
 
+// ----------------------------------------------------------------------
+// Pack the data characters of a board ID into a number. Returns false if the ID
+// has a character that isn't in BOARD_ID_CHARS.
+bool CRSCConfigClass::PackBoardID (char* theID, uint32_t* packedID)
+{
+    static const char idChars[] = BOARD_ID_CHARS;
+    uint32_t thePack = 0;
+
+    for (int i = 0; i < BOARD_ID_BYTES; i++)
+    {
+        const char* digit = (const char*)memchr (idChars, theID[i], BOARD_ID_RADIX);
+
+        if ((theID[i] == 0x00) || (digit == NULL))
+            return (false);
+
+        thePack = thePack * BOARD_ID_RADIX + (digit - idChars);
+    }
+
+    *packedID = thePack;
+    return (true);
+}
+
+// ----------------------------------------------------------------------
+// Unpack a packed board ID back into an ID with check bytes and terminator
+void CRSCConfigClass::UnpackBoardID (uint32_t packedID, char* theID)
+{
+    static const char idChars[] = BOARD_ID_CHARS;
+
+    for (int i = BOARD_ID_BYTES - 1; i >= 0; i--)
+    {
+        theID[i] = idChars[packedID % BOARD_ID_RADIX];
+        packedID /= BOARD_ID_RADIX;
+    }
+
+    CalculateCheckBytes (theID, theID + BOARD_ID_BYTES);
+    theID[BOARD_ID_LEN] = 0x00;
+}
+
+// ----------------------------------------------------------------------
+// Binary search the scavenged list for a packed ID. Returns where it is, or
+// where it would go if it isn't there, and sets found accordingly.
+int CRSCConfigClass::FindScavengedID (uint32_t packedID, bool* found)
+{
+    int low = 0;
+    int high = (int)TheConfiguration.NumScavengedBoards;
+
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+
+        if (TheConfiguration.ScavengedBoardList[middle] < packedID)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    *found = (low < (int)TheConfiguration.NumScavengedBoards) && (TheConfiguration.ScavengedBoardList[low] == packedID);
+    return (low);
+}
+
 // ----------------------------------------------------------------------
 // Return a string containing the specified scavenged board ID, including
 // the check digit. Valid indices go from 0 to GetNumScavengedBoardIDs() - 1.
 // Return value is true if theIndex is valid and false otherwise
+bool CRSCConfigClass::GetScavengedBoardID (int theIndex, char* theID)
+{
+    bool returnValue = false;
+
+    if ((theIndex >= 0) && (theIndex < (int)TheConfiguration.NumScavengedBoards))
+    {
+        UnpackBoardID (TheConfiguration.ScavengedBoardList[theIndex], theID);
+        returnValue = true;
+    }
+    return (returnValue);
+}
+
+// ----------------------------------------------------------------------
+// Print the list of scavenged board IDs
 void CRSCConfigClass::PrintScavengedBoardList(void)
 {
-    Serial.print (F("You have ")); Serial.print ((int)TheConfiguration.NumScavengedBoards);
-    Serial.println (F(" scavenged ID(s)\n"));
+    char theID[BOARD_ID_BUF_LEN];
+
+    TheConsole.printf_P (PSTR("You have %d scavenged ID(s)\n\r\n"), (int)TheConfiguration.NumScavengedBoards);
 	
     for (int i = 0; i < TheConfiguration.NumScavengedBoards; i++)
     {
-        Serial.println (TheConfiguration.ScavengedBoardList[i]);
+        UnpackBoardID (TheConfiguration.ScavengedBoardList[i], theID);
+        TheConsole.println (theID);
     }
-    Serial.println();
+    TheConsole.println();
+}
+
+// ----------------------------------------------------------------------
+// Return a flag which, when set, indicates that the ID is on our scavenged list
+bool CRSCConfigClass::IsScavengedID (char* theID)
+{
+    uint32_t packedID;
+    bool found = false;
+
+    if (PackBoardID (theID, &packedID))
+        FindScavengedID (packedID, &found);
+
+    return (found);
 }
 		
 // ----------------------------------------------------------------------
-// Save new scavenged board ID. Return true on success, false on error. A false would
+// Add the ID to the scavenged list in RAM if it's valid, matches our
+// fingerprint and isn't already there. Returns true if it was added. A false would
 // be returned if:
 //    - scavenged ID list is already full
 //    - the specified ID is already on the list
-//    - the scavenged ID is not valid (check bytes failure or wrong length
+//    - the scavenged ID is not valid (check bytes failure or wrong length, or
+//      a character that isn't used in board IDs)
 //    - the scavenged ID is actually this board's
 //    - the scavenged ID does not match the fingerprint of this board
-
-bool CRSCConfigClass::AddNewScavengedID(char* theID)
+bool CRSCConfigClass::AcceptScavengedID(char* theID)
 {
     bool returnValue = false;
+    uint32_t packedID;
+    int position = 0;
 
     // If the list is full ...
-    if (TheConfiguration.NumScavengedBoards < SCAVENGED_BOARD_LIST_LEN)
+    if (TheConfiguration.NumScavengedBoards < SCAVENGED_BOARD_STORE_LEN)
     {
         // List not full. Is this a valid board ID?
-        if (IsValidBoardID (theID) == true)
+        if ((IsValidBoardID (theID) == true) && (PackBoardID (theID, &packedID) == true))
         {
             // For the more creative among us, make sure it's not our Board ID
             if (memcmp(&TheConfiguration.MyBoardID, theID, BOARD_ID_BUF_LEN) != 0)
@@ -201,16 +522,11 @@ bool CRSCConfigClass::AddNewScavengedID(char* theID)
 	    	    // Valid board ID. Does it match our fingerprint?
 	    	    if (HasSameFingerprint(theID))
 	    	    {
-	    	        // Matches our fingerprint. Make sure it's not already on our list
-	    	        returnValue = true;
-	    	        int i = 0;
-	    	        while ((i < (int)TheConfiguration.NumScavengedBoards) && (returnValue == true))
-	    	        {
-	    	            if (strcmp(TheConfiguration.ScavengedBoardList[i], theID) == 0)
-	    	                returnValue = false;
-	    	            else
-	    	                i++;
-	    	        }
+	    	        // Matches our fingerprint. Make sure it's not already on our list - the
+	    	        // list is kept in order, so this also finds where it should go.
+	    	        bool found;
+	    	        position = FindScavengedID (packedID, &found);
+	    	        returnValue = !found;
 	    	    }
 	    	}
 	    }
@@ -219,16 +535,180 @@ bool CRSCConfigClass::AddNewScavengedID(char* theID)
 	// If we get here and returnValue is true, the board ID is new and valid, so add it
 	if (returnValue == true)
 	{
-	    // Save new ID
-	    memcpy (TheConfiguration.ScavengedBoardList[TheConfiguration.NumScavengedBoards], theID, BOARD_ID_BUF_LEN);
+	    uint32_t* theList = TheConfiguration.ScavengedBoardList;
+
+	    memmove (&theList[position + 1], &theList[position],
+	             (TheConfiguration.NumScavengedBoards - position) * sizeof (theList[0]));
+	    theList[position] = packedID;
 	    TheConfiguration.NumScavengedBoards++;
-	
-	    // And update the configuration in EEPROM
-	    Write();
 	}
 	return (returnValue);
 }
 
+// ----------------------------------------------------------------------
+// Save new scavenged board ID. Return true on success, false on error - see
+// AcceptScavengedID() for the reasons an ID is turned away. The new ID is
+// appended to the journal, which costs a 16 byte flash write rather than a
+// sector erase and rewrite - and with a write-back window, shares that write with
+// any other changes made in the window.
+bool CRSCConfigClass::AddNewScavengedID(char* theID)
+{
+    bool returnValue = AcceptScavengedID (theID);
+
+    if (returnValue == true)
+        QueueRecord (CONFIG_RECORD_SCAVENGED_ID, theID, BOARD_ID_LEN);
+
+    return (returnValue);
+}
+
+// ----------------------------------------------------------------------
+// Set the flag that indicates the hunt is over. Stops board from contacting ifttt.com 
+// every time it is powered up.
+void CRSCConfigClass::SetHuntComplete (void)
+{
+    if (TheConfiguration.HuntComplete == false)
+    {
+        TheConfiguration.HuntComplete = true;
+        QueueRecord (CONFIG_RECORD_HUNT_COMPLETE, NULL, 0);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Put a notification in the outbox. Replaying a record twice does no harm.
+// A full write doesn't retire the journal, so it can still hold records older
+// than the configuration - ones already delivered, or whose slot has since been
+// reused for a newer notification. Those are ignored.
+void CRSCConfigClass::AcceptQueuedMessage (uint32_t theSequence, uint8_t theMessage)
+{
+    outbox_t* theOutbox = &TheConfiguration.Outbox;
+
+    if ((theSequence <= theOutbox->SentSequence) || (theSequence + OUTBOX_LEN <= theOutbox->LastSequence))
+        return;
+
+    theOutbox->Messages[theSequence % OUTBOX_LEN] = theMessage;
+    if (theSequence > theOutbox->LastSequence)
+        theOutbox->LastSequence = theSequence;
+}
+
+// ------------------------------------------------------------------------------
+// Mark the outbox delivered up to and including theSequence
+void CRSCConfigClass::AcceptSentMessage (uint32_t theSequence)
+{
+    if ((theSequence > TheConfiguration.Outbox.SentSequence) && (theSequence <= TheConfiguration.Outbox.LastSequence))
+        TheConfiguration.Outbox.SentSequence = theSequence;
+}
+
+// ------------------------------------------------------------------------------
+// Queue a notification for ifttt.com and write it to flash straight away, so
+// it is sent even if the board is unplugged first. Does nothing if the same
+// notification is already waiting. Returns false if the outbox is full.
+bool CRSCConfigClass::QueueMessage (outbox_message_t theMessage)
+{
+    outbox_t* theOutbox = &TheConfiguration.Outbox;
+    uint8_t payload[sizeof (uint32_t) + 1];
+
+    for (uint32_t i = theOutbox->SentSequence + 1; i <= theOutbox->LastSequence; i++)
+    {
+        if (theOutbox->Messages[i % OUTBOX_LEN] == theMessage)
+            return (true);
+    }
+
+    if (GetQueuedMessages() >= OUTBOX_LEN)
+        return (false);
+
+    uint32_t theSequence = theOutbox->LastSequence + 1;
+    AcceptQueuedMessage (theSequence, theMessage);
+
+    memcpy (payload, &theSequence, sizeof (theSequence));
+    payload[sizeof (theSequence)] = theMessage;
+    QueueRecord (CONFIG_RECORD_MESSAGE_QUEUED, payload, sizeof (payload));
+
+    // Don't leave it to the write-back window - losing this is losing the message
+    Flush();
+
+    return (true);
+}
+
+// ------------------------------------------------------------------------------
+// Get the oldest notification waiting to go to ifttt.com and its sequence
+// number. Returns false if there aren't any.
+bool CRSCConfigClass::GetQueuedMessage (outbox_message_t* theMessage, uint32_t* theSequence)
+{
+    bool returnValue = (GetQueuedMessages() > 0);
+
+    if (returnValue == true)
+    {
+        *theSequence = TheConfiguration.Outbox.SentSequence + 1;
+        *theMessage = (outbox_message_t)TheConfiguration.Outbox.Messages[*theSequence % OUTBOX_LEN];
+    }
+    return (returnValue);
+}
+
+// ------------------------------------------------------------------------------
+// Mark the notification with this sequence number, and any before it, as
+// delivered. Written back like any other change, so a batch of them costs
+// one write.
+void CRSCConfigClass::SetMessageSent (uint32_t theSequence)
+{
+    if ((theSequence > TheConfiguration.Outbox.SentSequence) && (theSequence <= TheConfiguration.Outbox.LastSequence))
+    {
+        AcceptSentMessage (theSequence);
+        QueueRecord (CONFIG_RECORD_MESSAGE_SENT, &theSequence, sizeof (theSequence));
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Send notifications to a collector at theHost:thePort with theTransport
+// instead of ifttt.com. An empty host goes back to ifttt.com, over HTTP.
+// Returns false if the host name is too long.
+bool CRSCConfigClass::SetCollector (const char* theHost, uint16_t thePort, collector_transport_t theTransport)
+{
+    bool returnValue = (strlen (theHost) < COLLECTOR_HOST_LEN);
+
+    if (returnValue == true)
+    {
+        memset (TheConfiguration.CollectorHost, 0, COLLECTOR_HOST_LEN);
+        strcpy (TheConfiguration.CollectorHost, theHost);
+        TheConfiguration.CollectorPort = (theHost[0] != 0x00) ? thePort : 0;
+        TheConfiguration.CollectorTransport = (theHost[0] != 0x00) ? theTransport : COLLECTOR_HTTP;
+        QueueWrite (false);
+    }
+    return (returnValue);
+}
+
+// ------------------------------------------------------------------------------
+// Copy the details of the last good Wifi join into theCache. Returns false
+// if there aren't any.
+bool CRSCConfigClass::GetWifiCache (wifi_cache_t* theCache)
+{
+    memcpy (theCache, &TheConfiguration.WifiCache, sizeof (wifi_cache_t));
+    return (TheConfiguration.WifiCache.Channel != 0);
+}
+
+// ------------------------------------------------------------------------------
+// Remember the details of a good Wifi join. Only written to flash if they've changed.
+// The journal is left alone - replaying it over the new configuration does no harm,
+// as every kind of record it holds is checked against what's already there.
+void CRSCConfigClass::SetWifiCache (const wifi_cache_t* theCache)
+{
+    if (memcmp (&TheConfiguration.WifiCache, theCache, sizeof (wifi_cache_t)) != 0)
+    {
+        memcpy (&TheConfiguration.WifiCache, theCache, sizeof (wifi_cache_t));
+        QueueWrite (false);
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Forget the details of the last Wifi join, so the next one starts from scratch
+void CRSCConfigClass::ClearWifiCache (void)
+{
+    if (TheConfiguration.WifiCache.Channel != 0)
+    {
+        memset (&TheConfiguration.WifiCache, 0, sizeof (wifi_cache_t));
+        QueueWrite (false);
+    }
+}
+
 // ------------------------------------------------------------------------------
 // Calculate the check bytes of a board ID
 void CRSCConfigClass::CalculateCheckBytes (char* theID, char* checkBytes)
@@ -294,7 +774,7 @@ bool CRSCConfigClass::HasSameFingerprint (char* idString)
     // First, make sure the ID passed in is valid
     if (IsValidBoardID(idString))
     {
-        for (int i = 0; i < BOARD_ID_BYTES; i++)
+        for (int i = 0; i < CRSCGame::FingerprintBits; i++)
         {
             newFingerprint = newFingerprint << 1;
 
@@ -319,17 +799,18 @@ void CRSCConfigClass::Initialize (char* theWifiSSID, char* theWifiPassword, char
     // Clear the entire configuration structure
     memset (&TheConfiguration, 0, sizeof(TheConfiguration));
     
-    // Load the parameters
-    strncpy (TheConfiguration.WifiSSID, theWifiSSID, WIFI_SSID_LEN);
-    strncpy (TheConfiguration.WifiPassword, theWifiPassword, WIFI_PASSWORD_LEN);
-    strncpy (TheConfiguration.IFTTTKey, theIFTTTKey, IFTTT_KEY_LEN);
+    // Load the parameters, leaving room for the terminators the memset() put there
+    strncpy (TheConfiguration.WifiSSID, theWifiSSID, WIFI_SSID_LEN - 1);
+    strncpy (TheConfiguration.WifiPassword, theWifiPassword, WIFI_PASSWORD_LEN - 1);
+    strncpy (TheConfiguration.IFTTTKey, theIFTTTKey, IFTTT_KEY_LEN - 1);
     TheConfiguration.HuntComplete = false;
 	
     // BoardID and scavenged board information were zeroed by the memset()
     // at the top of this method.
     
-    // And save
-    Write();
+    // And save, retiring the journal so none of the old board's changes can be
+    // played back on top of the new configuration
+    QueueWrite (true);
 }
 
 // ------------------------------------------------------------------------------
@@ -341,14 +822,16 @@ bool CRSCConfigClass::SetBoardID(char* newID)
 	
     if (IsValidBoardID (newID))
     {
-        strncpy (TheConfiguration.MyBoardID, newID, BOARD_ID_BUF_LEN);
+        memcpy (TheConfiguration.MyBoardID, newID, BOARD_ID_LEN);
+        TheConfiguration.MyBoardID[BOARD_ID_LEN] = 0x00;
         
         // If we're setting the board ID, should erase any existing scavenged IDs,
         // I think.
         TheConfiguration.NumScavengedBoards = 0;
         
-        // Save changes to EEPROM
-        Write();
+        // Save changes to EEPROM, retiring the journal so the old IDs don't
+        // come back the next time we load
+        QueueWrite (true);
         returnValue = true;
     }
     return (returnValue);
@@ -356,13 +839,13 @@ bool CRSCConfigClass::SetBoardID(char* newID)
 
 // ------------------------------------------------------------------------------
 // Return the current fingerprint in the string provided - used for diagnostics only.
-// String returned consists of 4 characters that are either 0 or 1, plus the
-// terminator.
+// String returned consists of one character per fingerprint bit, each either 0
+// or 1, plus the terminator.
 void CRSCConfigClass::GetFingerprint (char* thePrint)
 {
     unsigned long temp = Fingerprint;
     
-    for (int i = 0; i < 4; i++)
+    for (int i = 0; i < CRSCGame::FingerprintBits; i++)
     {
         if (temp & 0x01)
             thePrint[i] = '1';
@@ -371,6 +854,6 @@ void CRSCConfigClass::GetFingerprint (char* thePrint)
        
         temp = temp >> 1;
     }
-    thePrint[4] = 0x00;
+    thePrint[CRSCGame::FingerprintBits] = 0x00;
 }
 		
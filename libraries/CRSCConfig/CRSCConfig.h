@@ -31,6 +31,8 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // The definition of the configuration for the current sketch. 
 #include <CRSCConfigDefs.h>
+#include <CRSCJournal.h>
+#include <CRSCMetrics.h>
 
 class CRSCConfigClass
 {
@@ -42,6 +44,20 @@ class CRSCConfigClass
         // connectivity by sending a message to ifttt.com. Intended to be used only
         // for production.
         bool WifiTestModeActive;
+
+        // Changes made since the configuration was last written in full. Adding a
+        // scavenged ID or finishing the hunt appends a record here instead of
+        // rewriting the whole EEPROM sector; Load() plays the records back.
+        CRSCJournal Journal;
+
+        // Types of the records we keep in the journal
+        typedef enum
+        {
+            CONFIG_RECORD_SCAVENGED_ID = 1,   // Payload is the ID, without terminator
+            CONFIG_RECORD_HUNT_COMPLETE = 2,  // No payload
+            CONFIG_RECORD_MESSAGE_QUEUED = 3, // Payload is the sequence number, then the outbox_message_t
+            CONFIG_RECORD_MESSAGE_SENT = 4    // Payload is the sequence number
+        } ConfigRecord_t;
 		
         // Return the one's complement checksum of the configuration structure
         unsigned char CalculateChecksum (void);
@@ -52,6 +68,69 @@ class CRSCConfigClass
 		
         // Calculate a fingerprint based in the ID string passed in
         unsigned long CalculateFingerprint (char* theID);
+
+        // Binary search the scavenged list for a packed ID. Returns where it is, or
+        // where it would go if it isn't there, and sets found accordingly.
+        int FindScavengedID (uint32_t packedID, bool* found);
+
+        // Add the ID to the scavenged list in RAM if it's valid, matches our
+        // fingerprint and isn't already there. Returns true if it was added.
+        bool AcceptScavengedID (char* theID);
+
+        // Put a notification in the outbox, or mark the outbox delivered up to a
+        // sequence number. Used for new changes and when replaying the journal.
+        // Records older than the outbox - delivered, or overtaken by a newer
+        // notification in the same slot - are ignored.
+        void AcceptQueuedMessage (uint32_t theSequence, uint8_t theMessage);
+        void AcceptSentMessage (uint32_t theSequence);
+
+        // Play back the journal on top of the configuration just read from EEPROM
+        void ReplayJournal (void);
+
+        // A flag which, when set, indicates that the journal can be used. It's
+        // cleared if the journal's sectors would overlap the file system, and
+        // then every change writes the whole configuration instead.
+        bool JournalEnabled;
+
+        // Return a flag which, when set, indicates that the journal's sectors are
+        // clear of the file system
+        bool JournalFits (void);
+
+        // Changes waiting to be written back. Journal records are held here until
+        // the next flush, or until there are too many to hold.
+        journal_record_t PendingRecords[8];
+        unsigned NumPendingRecords;
+
+        // Flags which, when set, indicate that the whole configuration has to be
+        // written at the next flush, and that the journal has to be retired first
+        bool WritePending;
+        bool RetireJournalPending;
+
+        // millis() when the oldest unflushed change was made
+        unsigned long FirstChangeMillis;
+
+        // How long changes are held before they're written back. 0 writes every
+        // change straight away.
+        unsigned long WriteBackWindow;
+
+        // Number of flushes that wrote to flash, and number of changes that were
+        // merged into a flush that was already pending instead of costing their own
+        unsigned long Commits;
+        unsigned long CommitsAvoided;
+
+        // Where commit times go, if anywhere
+        CRSCMetrics* Metrics;
+
+        // Record a change in the journal at the next flush
+        void QueueRecord (unsigned char theType, const void* thePayload, size_t payloadLen);
+
+        // Write the whole configuration at the next flush, retiring the journal
+        // first if retireJournal is set
+        void QueueWrite (bool retireJournal);
+
+        // Bookkeeping after a change has been queued. wasDirty is whether there
+        // were already changes waiting.
+        void ChangeQueued (bool wasDirty);
         
     protected:
         // Write configuration information to EEPROM, adding a checksum
@@ -77,6 +156,17 @@ class CRSCConfigClass
 				
         // Calculate the check bytes of a board ID
         void CalculateCheckBytes (char* theID, char* checkBytes);
+
+        // Return the one's complement checksum of a configuration structure, as it's
+        // stored after the structure in EEPROM. Public so host tools can build
+        // EEPROM images the board will accept.
+        static unsigned char CalculateChecksum (config_t* theConfiguration);
+
+        // Pack the data characters of a board ID into a number, or unpack one back
+        // into an ID with check bytes and terminator. Packing returns false if the ID
+        // has a character that isn't in BOARD_ID_CHARS.
+        bool PackBoardID (char* theID, uint32_t* packedID);
+        void UnpackBoardID (uint32_t packedID, char* theID);
   	  
   	    // Return the current number of scavenged board IDs
   	    int GetNumScavengedBoardIDs(void)
@@ -87,19 +177,25 @@ class CRSCConfigClass
   	       { return (Fingerprint); }
   	       
   	    // Return the current fingerprint in the string provided - used for diagnostics only.
-  	    // String returned consists of 4 characters that are either 0 or 1, plus the
-  	    // terminator.
+  	    // String returned consists of one character per fingerprint bit, each either 0
+  	    // or 1, plus the terminator.
         void GetFingerprint (char* thePrint);
 		
   	    // Return a string containing the specified scavenged board ID, including
   	    // the check digits. Valid indices go from 0 to GetNumScavengedBoardIDs() - 1.
   	    // Return value is true if theIndex is valid and false otherwise.
+  	    bool GetScavengedBoardID(int theIndex, char* theID);
+
+  	    // Print the list of scavenged board IDs
   	    void PrintScavengedBoardList(void);
 		
   	    // Save new scavenged board ID. Return 0 on success, -1 on error. A -1 would
   	    // be returned if scavenged ID list is already full or if the specified ID
   	    // is already on the list.
   	    bool AddNewScavengedID(char* theID);
+
+  	    // Return a flag which, when set, indicates that the ID is on our scavenged list
+  	    bool IsScavengedID(char* theID);
 		
   	    // Return a pointer to our stored WifiSSID
   	    char* GetWifiSSID(void)
@@ -112,6 +208,22 @@ class CRSCConfigClass
   	    // Return a pointer to our stored IFTTT key
   	    char* GetIFTTTKey(void)
   	       { return (TheConfiguration.IFTTTKey); }
+
+        // Return the host notifications are sent to instead of ifttt.com - empty if
+        // they go to ifttt.com - and its port
+        char* GetCollectorHost (void)
+           { return (TheConfiguration.CollectorHost); }
+        uint16_t GetCollectorPort (void)
+           { return (TheConfiguration.CollectorPort); }
+
+        // Return how notifications get to the collector
+        collector_transport_t GetCollectorTransport (void)
+           { return ((collector_transport_t)TheConfiguration.CollectorTransport); }
+
+        // Send notifications to a collector at theHost:thePort with theTransport
+        // instead of ifttt.com. An empty host goes back to ifttt.com, over HTTP.
+        // Returns false if the host name is too long.
+        bool SetCollector (const char* theHost, uint16_t thePort, collector_transport_t theTransport = COLLECTOR_HTTP);
 		
   	    // Return a pointer to our own Board ID
   	    char* GetBoardID(void)
@@ -151,13 +263,75 @@ class CRSCConfigClass
         
         // Set the flag that indicates the hunt is over. Stops board from contacting ifttt.com 
         // every time it is powered up.
-        void SetHuntComplete(void)
-        { TheConfiguration.HuntComplete = true; Write(); }
+        void SetHuntComplete(void);
+
+        // Queue a notification for ifttt.com and write it to flash straight away, so
+        // it is sent even if the board is unplugged first. Does nothing if the same
+        // notification is already waiting. Returns false if the outbox is full.
+        bool QueueMessage (outbox_message_t theMessage);
+
+        // Return the number of notifications waiting to go to ifttt.com
+        unsigned GetQueuedMessages (void)
+        { return (TheConfiguration.Outbox.LastSequence - TheConfiguration.Outbox.SentSequence); }
+
+        // Get the oldest notification waiting to go to ifttt.com and its sequence
+        // number. Returns false if there aren't any.
+        bool GetQueuedMessage (outbox_message_t* theMessage, uint32_t* theSequence);
+
+        // Mark the notification with this sequence number, and any before it, as
+        // delivered. Written back like any other change, so a batch of them costs
+        // one write.
+        void SetMessageSent (uint32_t theSequence);
         
+        // Hold changes for up to theWindow milliseconds so a burst of them costs a
+        // single write to flash. Changes made in the window are lost if the power
+        // goes before it closes. 0, the default, writes every change straight away.
+        void SetWriteBackWindow (unsigned long theWindow)
+        { WriteBackWindow = theWindow; }
+
+        // Record how long each commit takes in theMetrics
+        void SetMetrics (CRSCMetrics* theMetrics)
+        { Metrics = theMetrics; }
+
+        // Write back any changes whose window has closed. Call once per pass through
+        // loop(), or when GetWriteBackDelay() says to.
+        void Update (void);
+
+        // Return how many milliseconds until Update() has changes to write back -
+        // 0 if they're due now. Only meaningful while IsDirty() is true.
+        unsigned long GetWriteBackDelay (void);
+
+        // Write back any changes now. Call before anything that resets the board.
+        void Flush (void);
+
+        // Return a flag which, when set, indicates that there are changes not yet in flash
+        bool IsDirty (void)
+        { return ((NumPendingRecords > 0) || (WritePending == true)); }
+
+        // Return the number of flushes that wrote to flash
+        unsigned long GetCommits (void)
+        { return (Commits); }
+
+        // Return the number of changes that were merged into another flush instead
+        // of costing their own
+        unsigned long GetCommitsAvoided (void)
+        { return (CommitsAvoided); }
+
         // Return a flag which, when set, indicates that the hunt is over because all
-        // required board IDs have been entered and ifttt.com has been notified
+        // required board IDs have been entered. The notification for ifttt.com is
+        // in the outbox, or has already gone.
         bool GetHuntComplete (void)
         { return (TheConfiguration.HuntComplete); }
+
+        // Copy the details of the last good Wifi join into theCache. Returns false
+        // if there aren't any.
+        bool GetWifiCache (wifi_cache_t* theCache);
+
+        // Remember the details of a good Wifi join. Only written to flash if they've changed.
+        void SetWifiCache (const wifi_cache_t* theCache);
+
+        // Forget the details of the last Wifi join, so the next one starts from scratch
+        void ClearWifiCache (void);
 };
 
 
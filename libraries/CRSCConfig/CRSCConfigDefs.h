@@ -29,24 +29,85 @@ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <Arduino.h>
+
+// The rules of the game this build is for. The sizes below all come from it.
+#include "CRSCGamePolicy.h"
 
 // Lengths for fixed fields in the configuration structure
 #define WIFI_SSID_LEN     25
 #define WIFI_PASSWORD_LEN 25
 #define IFTTT_KEY_LEN     30
+#define COLLECTOR_HOST_LEN 40
+
+
+// Number of scavenged board IDs needed to complete the hunt
+#define SCAVENGED_BOARD_LIST_LEN (CRSCGame::ScavengedListLen)
 
+// Number of scavenged board IDs we can store in our configuration. IDs are packed
+// into 4 bytes each, so several hundred fit in the EEPROM sector.
+#define SCAVENGED_BOARD_STORE_LEN (CRSCGame::ScavengedStoreLen)
 
-// Number of scavenged board IDs we can store in our configuration
-#define SCAVENGED_BOARD_LIST_LEN 5
+// Number of flash sectors, directly below the emulated EEPROM, that hold the
+// journal of changes made since the configuration was last written in full.
+// Build with a flash layout that has no file system so these are free.
+#define CONFIG_JOURNAL_SECTORS 4
 
-// Number of bytes in a boardID. 4 bytes of data and two check bytes.
-#define BOARD_ID_BYTES 4
-#define BOARD_ID_CHECK_BYTES 2
-#define BOARD_ID_LEN BOARD_ID_BYTES+BOARD_ID_CHECK_BYTES
-#define BOARD_ID_BUF_LEN BOARD_ID_LEN+1     // Store null terminator - just makes everything easier
+// Number of bytes in a boardID. 4 bytes of data (in the standard game) and two check bytes.
+#define BOARD_ID_BYTES (CRSCGame::BoardIDBytes)
+#define BOARD_ID_CHECK_BYTES (CRSCGame::BoardIDCheckBytes)
+#define BOARD_ID_LEN (CRSCGame::BoardIDLen)
+#define BOARD_ID_BUF_LEN (BOARD_ID_LEN+1)     // Store null terminator - just makes everything easier
 
 // This is what an uninitialized board ID looks like
-const char UninitializedID[BOARD_ID_LEN] = {0,0,0,0,0,0};
+const char UninitializedID[BOARD_ID_LEN] = {0};
+
+// The characters board IDs are made from - the ones host/tools/CRSCIDGen issues. There's
+// no 'O' so it can't be mistaken for a zero. A packed board ID is its data
+// characters read as a base 35 number using these as the digits.
+#define BOARD_ID_CHARS "0123456789ABCDEFGHIJKLMNPQRSTUVWXYZ"
+#define BOARD_ID_RADIX 35
+
+// What we need to rejoin the access point without scanning or asking for an
+// address - the access point we last joined, its channel and the lease DHCP
+// gave us. Addresses are as held by IPAddress. CRSCWifiConnector decides
+// whether the lease is still fresh enough to use.
+typedef struct
+{
+      uint8_t BSSID[6];
+      uint8_t Channel;         // 0 when nothing is cached
+      uint32_t LocalIP;
+      uint32_t Gateway;
+      uint32_t Subnet;
+      uint32_t DNS;
+} wifi_cache_t;
+
+// Number of notifications that can wait in the outbox for ifttt.com
+#define OUTBOX_LEN 4
+
+// What a notification in the outbox says
+typedef enum
+{
+      OUTBOX_HUNT_COMPLETE = 1,  // The scavenger hunt is complete
+      OUTBOX_WIFI_TEST = 2       // Connectivity test asked for over serial
+} outbox_message_t;
+
+// How notifications get to a collector. ifttt.com only takes HTTP.
+typedef enum
+{
+      COLLECTOR_HTTP = 0,        // The HTTP POST ifttt.com takes
+      COLLECTOR_UDP = 1          // One signed datagram each way (CRSCDatagram)
+} collector_transport_t;
+
+// Notifications waiting to go to ifttt.com, oldest first. Each one gets the next
+// sequence number - they carry on across reboots - and stays until a send of it
+// succeeds. Waiting are LastSequence - SentSequence of them.
+typedef struct
+{
+      uint32_t LastSequence;            // Sequence number of the newest notification, 0 if none yet
+      uint32_t SentSequence;            // Everything up to and including this one has been delivered
+      uint8_t Messages[OUTBOX_LEN];     // outbox_message_t, indexed by sequence number % OUTBOX_LEN
+} outbox_t;
 
 // Structure to save the configuration for this sketch in EEPROM
 typedef struct
@@ -55,9 +116,14 @@ typedef struct
       char WifiPassword[WIFI_PASSWORD_LEN];
       char IFTTTKey[IFTTT_KEY_LEN];  
       char MyBoardID[BOARD_ID_BUF_LEN];   
-      unsigned char NumScavengedBoards;
-      char ScavengedBoardList[SCAVENGED_BOARD_LIST_LEN][BOARD_ID_BUF_LEN];
-      bool HuntComplete;       // this board has a full ScavengedBoardList and results have been sent to ifttt.com
+      unsigned short NumScavengedBoards;
+      uint32_t ScavengedBoardList[SCAVENGED_BOARD_STORE_LEN];   // Packed IDs, in ascending order
+      bool HuntComplete;       // this board has a full ScavengedBoardList and the news is in the outbox for ifttt.com
+      wifi_cache_t WifiCache;  // the last good join, for a fast rejoin
+      outbox_t Outbox;         // notifications waiting to go to ifttt.com
+      char CollectorHost[COLLECTOR_HOST_LEN];  // where notifications go instead of ifttt.com - empty for ifttt.com
+      uint16_t CollectorPort;
+      uint8_t CollectorTransport;  // collector_transport_t - how notifications get to the collector
 
 }config_t;
 
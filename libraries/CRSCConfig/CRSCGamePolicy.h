@@ -0,0 +1,85 @@
+#ifndef _CRSCGAMEPOLICY_H
+#define _CRSCGAMEPOLICY_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// The rules of one version of the game, all fixed at compile time. Everything
+// sized or timed by the game - config_t, the LED's flash list, the width of the
+// fingerprint - comes from the policy the build selects, so each variant
+// compiles down to fixed-length loops over fixed-size arrays.
+//
+//   IDBytes     - data characters in a board ID. Each one gives the fingerprint
+//                 one bit, and the LED one pulse.
+//   HuntLength  - scavenged IDs needed to complete the hunt
+//   StoreLength - scavenged IDs a board can hold
+//   ShortPulse, LongPulse - LED on times for a 0 and a 1 in the fingerprint (ms)
+//   OffPulse    - LED off time between pulses (ms)
+//   GapPulse    - LED off time between repeats of the fingerprint (ms)
+template <int IDBytes, int HuntLength, int StoreLength,
+          int ShortPulse, int LongPulse, int OffPulse, int GapPulse>
+struct CRSCGamePolicy
+{
+    static constexpr int BoardIDBytes = IDBytes;
+    static constexpr int BoardIDCheckBytes = 2;
+    static constexpr int BoardIDLen = IDBytes + BoardIDCheckBytes;
+
+    static constexpr int FingerprintBits = IDBytes;
+
+    static constexpr int ScavengedListLen = HuntLength;
+    static constexpr int ScavengedStoreLen = StoreLength;
+
+    static constexpr int LEDShortPulse = ShortPulse;
+    static constexpr int LEDLongPulse = LongPulse;
+    static constexpr int LEDOffPulse = OffPulse;
+    static constexpr int LEDGapPulse = GapPulse;
+
+    // An on and an off run per fingerprint bit. The gap is added to the last off run.
+    static constexpr int FlashListLen = FingerprintBits * 2;
+
+    // Packed IDs are base 35 numbers held in 32 bits - 35^6 fits, 35^7 doesn't
+    static_assert ((IDBytes >= 1) && (IDBytes <= 6), "board IDs must have 1 to 6 data characters");
+    static_assert (HuntLength <= StoreLength, "the hunt can't need more IDs than a board can store");
+};
+
+// The game as it has always been played: 4 bit fingerprints, 5 IDs to finish
+typedef CRSCGamePolicy<4, 5, 500, 100, 500, 500, 1500> CRSCStandardGame;
+
+// For bigger events: 6 bit fingerprints give 64 groups, so more IDs are needed
+// to finish. Pulses are shortened a little to keep the sequence readable.
+typedef CRSCGamePolicy<6, 8, 500, 100, 400, 400, 1500> CRSCLargeEventGame;
+
+// The game this build is for. Change the default here for a different event,
+// or define CRSC_GAME_POLICY on the compiler command line.
+#ifndef CRSC_GAME_POLICY
+#define CRSC_GAME_POLICY CRSCStandardGame
+#endif
+
+typedef CRSC_GAME_POLICY CRSCGame;
+
+#endif
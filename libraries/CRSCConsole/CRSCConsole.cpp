@@ -0,0 +1,189 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCConsole.h"
+
+#include <stdarg.h>
+
+CRSCConsole TheConsole;
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCConsole::CRSCConsole (void)
+{
+    Head = 0;
+    Tail = 0;
+    Pending = 0;
+    Buffered = false;
+    Stalls = 0;
+    HighWater = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Move up to theLength bytes from the ring to Serial. Serial waits for room.
+void CRSCConsole::Send (unsigned theLength)
+{
+    while ((theLength > 0) && (Pending > 0))
+    {
+        // Up to the end of the ring, then round again
+        unsigned chunk = BufferLen - Tail;
+        if (chunk > Pending)
+            chunk = Pending;
+        if (chunk > theLength)
+            chunk = theLength;
+
+        Serial.write (Buffer + Tail, chunk);
+
+        Tail = (Tail + chunk) % BufferLen;
+        Pending -= chunk;
+        theLength -= chunk;
+    }
+}
+
+// -----------------------------------------------------------------------------
+size_t CRSCConsole::write (uint8_t c)
+{
+    return (write (&c, 1));
+}
+
+// -----------------------------------------------------------------------------
+// Copy buffer into the ring, making room first if it won't fit
+size_t CRSCConsole::write (const uint8_t* buffer, size_t size)
+{
+    size_t left = size;
+
+    if (Buffered == false)
+        return (Serial.write (buffer, size));
+
+    while (left > 0)
+    {
+        if (Pending == BufferLen)
+        {
+            // Full. Wait for the UART to take what it has room for - at least a
+            // byte - rather than lose anything.
+            Stalls++;
+            int room = Serial.availableForWrite();
+            Send ((room > 0) ? room : 1);
+        }
+
+        unsigned chunk = BufferLen - Head;
+        if (chunk > BufferLen - Pending)
+            chunk = BufferLen - Pending;
+        if (chunk > left)
+            chunk = left;
+
+        memcpy (Buffer + Head, buffer, chunk);
+        Head = (Head + chunk) % BufferLen;
+        Pending += chunk;
+        buffer += chunk;
+        left -= chunk;
+    }
+
+    if (Pending > HighWater)
+        HighWater = Pending;
+
+    return (size);
+}
+
+// -----------------------------------------------------------------------------
+// Room left in the buffer, or in the UART's FIFO before Begin()
+int CRSCConsole::availableForWrite (void)
+{
+    return (Buffered ? (int)(BufferLen - Pending) : Serial.availableForWrite());
+}
+
+// -----------------------------------------------------------------------------
+// Format like printf() into the buffer, without using the heap
+size_t CRSCConsole::printf (const char* format, ...)
+{
+    char buffer[MaxFormattedLen];
+    va_list args;
+
+    va_start (args, format);
+    int length = vsnprintf (buffer, sizeof (buffer), format, args);
+    va_end (args);
+
+    if (length < 0)
+        return (0);
+    if (length >= (int)sizeof (buffer))
+        length = sizeof (buffer) - 1;
+
+    return (write ((const uint8_t*)buffer, length));
+}
+
+// -----------------------------------------------------------------------------
+// The same, with the format in PROGMEM
+size_t CRSCConsole::printf_P (PGM_P format, ...)
+{
+    char buffer[MaxFormattedLen];
+    va_list args;
+
+    va_start (args, format);
+    int length = vsnprintf_P (buffer, sizeof (buffer), format, args);
+    va_end (args);
+
+    if (length < 0)
+        return (0);
+    if (length >= (int)sizeof (buffer))
+        length = sizeof (buffer) - 1;
+
+    return (write ((const uint8_t*)buffer, length));
+}
+
+// -----------------------------------------------------------------------------
+// Send what the UART can take without waiting. Returns true if there's still
+// something to send.
+bool CRSCConsole::Update (void)
+{
+    int room = Serial.availableForWrite();
+
+    if (room > 0)
+        Send (room);
+
+    return (Pending > 0);
+}
+
+// -----------------------------------------------------------------------------
+// Return a flag which, when set, indicates that there's output waiting and
+// enough room in the UART to make Update() worth calling
+bool CRSCConsole::CanSend (void)
+{
+    if (Pending == 0)
+        return (false);
+
+    int room = Serial.availableForWrite();
+    return ((room >= (int)MinSendLen) || (room >= (int)Pending));
+}
+
+// -----------------------------------------------------------------------------
+// Send everything, waiting for the UART
+void CRSCConsole::Flush (void)
+{
+    Send (Pending);
+    Serial.flush();
+}
@@ -0,0 +1,123 @@
+#ifndef _CRSCCONSOLE_H
+#define _CRSCCONSOLE_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+// Everything the firmware prints goes through here rather than straight to
+// Serial. Once Begin() has been called, output is copied into a fixed ring
+// buffer and returns at once; Update(), called from loop() whenever CanSend()
+// says the UART has room, moves it on a FIFO-full at a time. A burst like the
+// help text or the D dump then costs a copy, not the 100 ms or more the UART
+// needs to send it, so the LED, Wifi and serial input carry on meanwhile.
+//
+// If a burst is bigger than the buffer, the write that finds it full waits
+// for the UART to make room, just as Serial.print() would. GetStalls() counts
+// how often that happens.
+//
+// Until Begin() is called everything is written straight through to Serial,
+// so sketches and host programs that never call it see no difference.
+class CRSCConsole : public Print
+{
+public:
+    // Size of the ring buffer. The help text and D dump fit with room to spare.
+    static const unsigned BufferLen = 2048;
+
+    // Longest line printf() formats - anything beyond is cut off
+    static const unsigned MaxFormattedLen = 128;
+
+    // Don't bother running Update() for less room in the UART's FIFO than this,
+    // unless that's all there is left to send
+    static const unsigned MinSendLen = 32;
+
+protected:
+    // The ring. Bytes go in at Head and out to Serial from Tail.
+    uint8_t Buffer[BufferLen];
+    unsigned Head;
+    unsigned Tail;
+    unsigned Pending;
+
+    // A flag which, when set, indicates that output is buffered
+    bool Buffered;
+
+    // Writes that had to wait for the UART, and the most ever waiting to go
+    unsigned long Stalls;
+    unsigned HighWater;
+
+    // Move up to theLength bytes from the ring to Serial. Serial waits for room.
+    void Send (unsigned theLength);
+
+public:
+    // Constructor
+    CRSCConsole (void);
+
+    // Start buffering output. Call from setup(), before anything is printed.
+    void Begin (void)
+        { Buffered = true; }
+
+    // Print's interface
+    size_t write (uint8_t c);
+    size_t write (const uint8_t* buffer, size_t size);
+    using Print::write;
+
+    // Room left in the buffer, or in the UART's FIFO before Begin()
+    int availableForWrite (void);
+
+    // Format like printf() into the buffer, without using the heap. printf_P()
+    // takes a format in PROGMEM - PSTR("...").
+    size_t printf (const char* format, ...) __attribute__ ((format (printf, 2, 3)));
+    size_t printf_P (PGM_P format, ...);
+
+    // Send what the UART can take without waiting. Returns true if there's
+    // still something to send.
+    bool Update (void);
+
+    // Return a flag which, when set, indicates that there's output waiting and
+    // enough room in the UART to make Update() worth calling
+    bool CanSend (void);
+
+    // Send everything, waiting for the UART. Call before ESP.restart() or anything
+    // else that would lose what's waiting.
+    void Flush (void);
+
+    // Return how many bytes are waiting to go, how often a write found the
+    // buffer full, and the most that have ever been waiting
+    unsigned GetPending (void)
+        { return (Pending); }
+    unsigned long GetStalls (void)
+        { return (Stalls); }
+    unsigned GetHighWater (void)
+        { return (HighWater); }
+};
+
+// There's only one serial port, so there's only one console
+extern CRSCConsole TheConsole;
+
+#endif
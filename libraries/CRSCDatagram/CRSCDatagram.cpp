@@ -0,0 +1,305 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCDatagram.h"
+#include "CRSCConsole.h"
+
+// -----------------------------------------------------------------------------
+// Little endian helpers - the board and the host agree on the layout whatever
+// their own byte order
+static void PutUint16 (uint8_t* theBuffer, uint16_t theValue)
+{
+    theBuffer[0] = (uint8_t)theValue;
+    theBuffer[1] = (uint8_t)(theValue >> 8);
+}
+
+static void PutUint32 (uint8_t* theBuffer, uint32_t theValue)
+{
+    for (int i = 0; i < 4; i++)
+        theBuffer[i] = (uint8_t)(theValue >> (8 * i));
+}
+
+static uint32_t GetUint32 (const uint8_t* theBuffer)
+{
+    return ((uint32_t)theBuffer[0] | ((uint32_t)theBuffer[1] << 8) |
+            ((uint32_t)theBuffer[2] << 16) | ((uint32_t)theBuffer[3] << 24));
+}
+
+static uint64_t GetUint64 (const uint8_t* theBuffer)
+{
+    return ((uint64_t)GetUint32 (theBuffer) | ((uint64_t)GetUint32 (theBuffer + 4) << 32));
+}
+
+// Where the fields are
+static const unsigned KindOffset = 3;
+static const unsigned IDOffset = 4;
+static const unsigned EventOffset = 12;
+static const unsigned StatusOffset = 14;
+static const unsigned SequenceOffset = 16;
+static const unsigned TimestampOffset = 20;
+static const unsigned MACOffset = 24;
+
+// -----------------------------------------------------------------------------
+// Make the 16 byte SipHash key from an IFTTT key. Keys longer than 16
+// characters are folded in, so every character counts.
+void CRSCDatagram::MakeKey (const char* theAPIKey, uint8_t* theKey)
+{
+    memset (theKey, 0, DATAGRAM_KEY_LEN);
+    for (size_t i = 0; theAPIKey[i] != 0x00; i++)
+        theKey[i % DATAGRAM_KEY_LEN] ^= (uint8_t)theAPIKey[i];
+}
+
+// -----------------------------------------------------------------------------
+// SipHash-2-4 of length bytes of theData (Aumasson and Bernstein). Quick on
+// short inputs, which is all we have, and needs no tables.
+uint64_t CRSCDatagram::SipHash (const uint8_t* theKey, const uint8_t* theData, size_t length)
+{
+    uint64_t k0 = GetUint64 (theKey);
+    uint64_t k1 = GetUint64 (theKey + 8);
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+#define SIP_ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+#define SIP_ROUND()                                                            \
+    do {                                                                       \
+        v0 += v1; v1 = SIP_ROTL (v1, 13); v1 ^= v0; v0 = SIP_ROTL (v0, 32);    \
+        v2 += v3; v3 = SIP_ROTL (v3, 16); v3 ^= v2;                            \
+        v0 += v3; v3 = SIP_ROTL (v3, 21); v3 ^= v0;                            \
+        v2 += v1; v1 = SIP_ROTL (v1, 17); v1 ^= v2; v2 = SIP_ROTL (v2, 32);    \
+    } while (0)
+
+    size_t blocks = length & ~(size_t)7;
+    for (size_t i = 0; i < blocks; i += 8)
+    {
+        uint64_t m = GetUint64 (theData + i);
+        v3 ^= m;
+        SIP_ROUND (); SIP_ROUND ();
+        v0 ^= m;
+    }
+
+    // The last few bytes, with the length in the top byte
+    uint64_t last = (uint64_t)length << 56;
+    for (size_t i = blocks; i < length; i++)
+        last |= (uint64_t)theData[i] << (8 * (i - blocks));
+
+    v3 ^= last;
+    SIP_ROUND (); SIP_ROUND ();
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    SIP_ROUND (); SIP_ROUND (); SIP_ROUND (); SIP_ROUND ();
+
+#undef SIP_ROUND
+#undef SIP_ROTL
+
+    return (v0 ^ v1 ^ v2 ^ v3);
+}
+
+// -----------------------------------------------------------------------------
+// Lay theDatagram out in theBuffer (DATAGRAM_LEN bytes) and sign it
+void CRSCDatagram::Pack (const datagram_t* theDatagram, const uint8_t* theKey, uint8_t* theBuffer)
+{
+    memset (theBuffer, 0, DATAGRAM_LEN);
+    theBuffer[0] = 'C';
+    theBuffer[1] = 'N';
+    theBuffer[2] = DATAGRAM_VERSION;
+    theBuffer[KindOffset] = theDatagram->Kind;
+    memcpy (theBuffer + IDOffset, theDatagram->BoardID, strnlen (theDatagram->BoardID, DATAGRAM_ID_LEN));
+    theBuffer[EventOffset] = theDatagram->Event;
+    PutUint16 (theBuffer + StatusOffset, theDatagram->Status);
+    PutUint32 (theBuffer + SequenceOffset, theDatagram->Sequence);
+    PutUint32 (theBuffer + TimestampOffset, theDatagram->Timestamp);
+
+    uint64_t mac = SipHash (theKey, theBuffer, MACOffset);
+    PutUint32 (theBuffer + MACOffset, (uint32_t)mac);
+    PutUint32 (theBuffer + MACOffset + 4, (uint32_t)(mac >> 32));
+}
+
+// -----------------------------------------------------------------------------
+// Check and pull apart the length bytes in theBuffer. Returns false if it
+// isn't one of ours, or wasn't signed with theKey.
+bool CRSCDatagram::Unpack (const uint8_t* theBuffer, size_t length, const uint8_t* theKey, datagram_t* theDatagram)
+{
+    if ((length != DATAGRAM_LEN) || (theBuffer[0] != 'C') || (theBuffer[1] != 'N') ||
+        (theBuffer[2] != DATAGRAM_VERSION))
+        return (false);
+
+    // Look at every byte of the signature, so how long this takes says nothing
+    // about how much of it was right
+    uint64_t mac = SipHash (theKey, theBuffer, MACOffset) ^ GetUint64 (theBuffer + MACOffset);
+    if (mac != 0)
+        return (false);
+
+    theDatagram->Kind = theBuffer[KindOffset];
+    memcpy (theDatagram->BoardID, theBuffer + IDOffset, DATAGRAM_ID_LEN);
+    theDatagram->BoardID[DATAGRAM_ID_LEN] = 0x00;
+    theDatagram->Event = theBuffer[EventOffset];
+    theDatagram->Status = (uint16_t)(theBuffer[StatusOffset] | (theBuffer[StatusOffset + 1] << 8));
+    theDatagram->Sequence = GetUint32 (theBuffer + SequenceOffset);
+    theDatagram->Timestamp = GetUint32 (theBuffer + TimestampOffset);
+    return (true);
+}
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCDatagramTransport::CRSCDatagramTransport (void)
+{
+    Host = NULL;
+    Port = 0;
+    DeviceID[0] = 0x00;
+    memset (Key, 0, sizeof (Key));
+    memset (Notification, 0, sizeof (Notification));
+    Sequence = 0;
+    LastSendMillis = 0;
+    ResendMillis = FirstResendMillis;
+    Resends = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Set up for sending from deviceID to theHost:thePort, signing with theAPIKey
+void CRSCDatagramTransport::Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                                        const char* theHost, uint16_t thePort)
+{
+    (void)deviceType;
+
+    Host = ((theHost != NULL) && (theHost[0] != 0x00)) ? theHost : NULL;
+    Port = (thePort != 0) ? thePort : 80;
+
+    strncpy (DeviceID, deviceID, DATAGRAM_ID_LEN);
+    DeviceID[DATAGRAM_ID_LEN] = 0x00;
+    CRSCDatagram::MakeKey (theAPIKey, Key);
+}
+
+// -----------------------------------------------------------------------------
+// Build the notification for theEvent and theSequence. The text isn't sent.
+// Returns false if there's no collector to send it to.
+bool CRSCDatagramTransport::BuildRequest (const char* theMessage, uint8_t theEvent, uint32_t theSequence)
+{
+    datagram_t theDatagram;
+
+    (void)theMessage;
+    if (Host == NULL)
+        return (false);
+
+    // Resends carry the same timestamp, so the collector sees when the board
+    // first tried rather than when it got through
+    theDatagram.Kind = DATAGRAM_NOTIFICATION;
+    memcpy (theDatagram.BoardID, DeviceID, sizeof (theDatagram.BoardID));
+    theDatagram.Event = theEvent;
+    theDatagram.Status = 0;
+    theDatagram.Sequence = theSequence;
+    theDatagram.Timestamp = millis();
+
+    CRSCDatagram::Pack (&theDatagram, Key, Notification);
+    Sequence = theSequence;
+    ResendMillis = FirstResendMillis;
+
+    // Look the collector up again for each send, in case it has moved
+    Lookup.Reset();
+    return (true);
+}
+
+// -----------------------------------------------------------------------------
+// Look up the collector, without waiting for the answer, and open a socket
+IFTTTTransport::ConnectStatus_t CRSCDatagramTransport::Connect (void)
+{
+    ConnectStatus_t returnValue = TRANSPORT_CONNECTING;
+    IFTTTHostLookup::LookupState_t lookup = Lookup.Poll (Host, &HostIP);
+
+    if (lookup == IFTTTHostLookup::LOOKUP_FAILED)
+    {
+        returnValue = TRANSPORT_FAILED;
+    }
+    else if (lookup == IFTTTHostLookup::LOOKUP_DONE)
+    {
+        if (TheUDP.begin (0) == 1)
+        {
+            TheConsole.printf_P (PSTR("Sending to %s\r\n"), Host);
+            returnValue = TRANSPORT_CONNECTED;
+        }
+        else
+        {
+            TheConsole.printf_P (PSTR("Failed to open a socket for %s\r\n"), Host);
+            returnValue = TRANSPORT_FAILED;
+        }
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Send the notification. Returns true if it went out.
+bool CRSCDatagramTransport::SendNotification (void)
+{
+    bool returnValue = false;
+
+    if (TheUDP.beginPacket (HostIP, Port) == 1)
+    {
+        TheUDP.write (Notification, DATAGRAM_LEN);
+        returnValue = (TheUDP.endPacket() == 1);
+    }
+
+    LastSendMillis = millis();
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Look for the acknowledgement, sending the notification again if it's been a
+// while. Returns true once it's in, with theCode set to its status.
+bool CRSCDatagramTransport::ReadReply (int* theCode)
+{
+    uint8_t theBuffer[DATAGRAM_LEN];
+    datagram_t theAck;
+    int length;
+
+    // Anything that isn't the collector acknowledging this notification - strays,
+    // forgeries, acknowledgements of an earlier try - is dropped
+    while ((length = TheUDP.parsePacket()) > 0)
+    {
+        if (((uint32_t)TheUDP.remoteIP() != (uint32_t)HostIP) || (length != DATAGRAM_LEN))
+            continue;
+
+        TheUDP.read (theBuffer, DATAGRAM_LEN);
+        if (CRSCDatagram::Unpack (theBuffer, DATAGRAM_LEN, Key, &theAck) && (theAck.Kind == DATAGRAM_ACK) &&
+            (theAck.Sequence == Sequence) && (strcmp (theAck.BoardID, DeviceID) == 0))
+        {
+            *theCode = theAck.Status;
+            return (true);
+        }
+    }
+
+    // Nothing yet - it or the acknowledgement may have been lost
+    if (millis() - LastSendMillis >= ResendMillis)
+    {
+        Resends++;
+        SendNotification();
+        ResendMillis = (ResendMillis * 2 < MaxResendMillis) ? ResendMillis * 2 : MaxResendMillis;
+    }
+    return (false);
+}
@@ -0,0 +1,178 @@
+#ifndef _CRSCDATAGRAM_H
+#define _CRSCDATAGRAM_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+
+#include "IFTTTMessage.h"
+
+// A notification, or the collector's acknowledgement of one, as it goes over
+// UDP. Both are the same 32 bytes, integers little endian:
+//
+//    0  'C' 'N'
+//    2  version (DATAGRAM_VERSION)
+//    3  kind (datagram_kind_t)
+//    4  board ID, padded with zeros to 8 characters
+//   12  event type - what the sketch's outbox calls it (outbox_message_t)
+//   13  0
+//   14  status, uint16 - 0 in a notification, an HTTP status in an acknowledgement
+//   16  sequence number, uint32 - the outbox sequence number
+//   20  timestamp, uint32 - the board's millis() when the notification was first sent
+//   24  SipHash-2-4 of bytes 0 to 23, keyed from the IFTTT key
+//
+// The acknowledgement echoes the board ID, event, sequence and timestamp of the
+// notification it answers.
+#define DATAGRAM_LEN 32
+#define DATAGRAM_VERSION 1
+#define DATAGRAM_ID_LEN 8
+#define DATAGRAM_KEY_LEN 16
+
+typedef enum
+{
+      DATAGRAM_NOTIFICATION = 1,    // Board to collector
+      DATAGRAM_ACK = 2              // Collector to board
+} datagram_kind_t;
+
+typedef struct
+{
+      uint8_t Kind;                       // datagram_kind_t
+      char BoardID[DATAGRAM_ID_LEN + 1];  // Terminated
+      uint8_t Event;
+      uint16_t Status;
+      uint32_t Sequence;
+      uint32_t Timestamp;
+} datagram_t;
+
+// Packing, unpacking and signing datagrams. Shared by the board's transport
+// and the collector.
+class CRSCDatagram
+{
+public:
+    // Make the 16 byte SipHash key from an IFTTT key
+    static void MakeKey (const char* theAPIKey, uint8_t* theKey);
+
+    // Lay theDatagram out in theBuffer (DATAGRAM_LEN bytes) and sign it
+    static void Pack (const datagram_t* theDatagram, const uint8_t* theKey, uint8_t* theBuffer);
+
+    // Check and pull apart the length bytes in theBuffer. Returns false if it
+    // isn't one of ours, or wasn't signed with theKey.
+    static bool Unpack (const uint8_t* theBuffer, size_t length, const uint8_t* theKey, datagram_t* theDatagram);
+
+    // SipHash-2-4 of length bytes of theData
+    static uint64_t SipHash (const uint8_t* theKey, const uint8_t* theData, size_t length);
+};
+
+// Sends the notification as one signed datagram to a collector and waits for
+// the signed acknowledgement, sending it again at growing intervals until one
+// arrives - IFTTTMessageClass gives up on it after its reply timeout, as it would
+// on an HTTP server. That's one small packet each way in place of a TCP
+// handshake, request, response and teardown, and no connection state on the
+// collector. ifttt.com doesn't take these, so this is only
+// for events with a collector.
+class CRSCDatagramTransport : public IFTTTTransport
+{
+protected:
+    WiFiUDP TheUDP;
+
+    // Where notifications go. Host points into the configuration, which stays
+    // put for the life of the sketch. HostIP is looked up again for each send.
+    const char* Host;
+    uint16_t Port;
+    IPAddress HostIP;
+    IFTTTHostLookup Lookup;
+
+    // Who we are, and the key notifications are signed with
+    char DeviceID[DATAGRAM_ID_LEN + 1];
+    uint8_t Key[DATAGRAM_KEY_LEN];
+
+    // The notification being sent, as it goes on the wire, and its sequence number
+    uint8_t Notification[DATAGRAM_LEN];
+    uint32_t Sequence;
+
+    // millis() when the notification last went out, and how long to wait for the
+    // acknowledgement before sending it again
+    unsigned long LastSendMillis;
+    unsigned long ResendMillis;
+
+    // How many times notifications have had to be sent again
+    unsigned long Resends;
+
+    // Wait before the first resend, and the longest between resends (milliseconds)
+    static const unsigned long FirstResendMillis = 250;
+    static const unsigned long MaxResendMillis = 2000;
+
+    // Send the notification. Returns true if it went out.
+    bool SendNotification (void);
+
+public:
+    // Constructor
+    CRSCDatagramTransport (void);
+
+    // Set up for sending from deviceID to theHost:thePort, signing with theAPIKey
+    void Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                     const char* theHost, uint16_t thePort);
+
+    // Build the notification for theEvent and theSequence. The text isn't sent.
+    // Returns false if there's no collector to send it to.
+    bool BuildRequest (const char* theMessage, uint8_t theEvent, uint32_t theSequence);
+
+    // Look up the collector, without waiting for the answer, and open a socket
+    ConnectStatus_t Connect (void);
+
+    // Send the notification. Returns true if it went out.
+    bool WriteRequest (void)
+        { return (SendNotification()); }
+
+    // Look for the acknowledgement, sending the notification again if it's been a
+    // while. Returns true once it's in, with theCode set to its status.
+    bool ReadReply (int* theCode);
+
+    // There's no connection to lose
+    bool IsConnected (void)
+        { return (true); }
+
+    // Close the socket. Acknowledgements that turn up after this are dropped.
+    void Stop (void)
+        { TheUDP.stop(); }
+
+    // Where notifications go, and the code is the status in the acknowledgement
+    const char* GetHost (void)
+        { return ((Host != NULL) ? Host : "no collector"); }
+    const char* GetCodeName (void)
+        { return ("ack status"); }
+
+    // Return how many times notifications have had to be sent again
+    unsigned long GetResends (void)
+        { return (Resends); }
+};
+
+#endif
@@ -0,0 +1,324 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCJournal.h"
+
+// Marks slot 0 of a sector as a journal sector header, and the magic number it carries
+#define JOURNAL_TYPE_HEADER  0xa5
+#define JOURNAL_MAGIC        0x4c4e524aUL     // "JRNL"
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCJournal::CRSCJournal (uint32_t firstSector, unsigned numSectors)
+{
+    FirstSector = firstSector;
+    NumSectors = numSectors;
+
+    Epoch = 0;
+    Sequence = 0;
+    CurrentSector = NumSectors - 1;
+    LiveSectors = 0;
+    NextSlot = SlotsPerSector;
+
+    ReadSector = 0;
+    ReadSectorsLeft = 0;
+    ReadSlot = 1;
+}
+
+// -----------------------------------------------------------------------------
+// Return the one's complement checksum of a record
+unsigned char CRSCJournal::CalculateChecksum (journal_record_t* theRecord)
+{
+    unsigned char returnValue = theRecord->Type;
+
+    returnValue += theRecord->Reserved[0] + theRecord->Reserved[1];
+    for (int i = 0; i < JOURNAL_PAYLOAD_LEN; i++)
+        returnValue += theRecord->Payload[i];
+
+    return (0xff - returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Return a flag which, when set, indicates that the record has never been written
+bool CRSCJournal::IsErased (journal_record_t* theRecord)
+{
+    unsigned char* recordBytes = (unsigned char*)theRecord;
+
+    for (unsigned i = 0; i < sizeof (journal_record_t); i++)
+    {
+        if (recordBytes[i] != 0xff)
+            return (false);
+    }
+    return (true);
+}
+
+// -----------------------------------------------------------------------------
+// Read or write one record. Slot 0 of each sector is its header.
+bool CRSCJournal::ReadRecord (unsigned sector, unsigned slot, journal_record_t* theRecord)
+{
+    uint32_t offset = (FirstSector + sector) * SPI_FLASH_SEC_SIZE + slot * sizeof (journal_record_t);
+
+    return (ESP.flashRead (offset, (uint32_t*)theRecord, sizeof (journal_record_t)));
+}
+
+bool CRSCJournal::WriteRecord (unsigned sector, unsigned slot, journal_record_t* theRecord)
+{
+    uint32_t offset = (FirstSector + sector) * SPI_FLASH_SEC_SIZE + slot * sizeof (journal_record_t);
+
+    return (ESP.flashWrite (offset, (uint32_t*)theRecord, sizeof (journal_record_t)));
+}
+
+// -----------------------------------------------------------------------------
+// Read the header of a sector. Returns true if it has a valid one.
+bool CRSCJournal::ReadHeader (unsigned sector, uint32_t* epoch, uint32_t* sequence)
+{
+    bool returnValue = false;
+    journal_record_t header;
+    uint32_t magic;
+
+    if (ReadRecord (sector, 0, &header) &&
+        (header.Type == JOURNAL_TYPE_HEADER) && (header.Checksum == CalculateChecksum (&header)))
+    {
+        memcpy (&magic, header.Payload, sizeof (magic));
+        memcpy (epoch, header.Payload + 4, sizeof (*epoch));
+        memcpy (sequence, header.Payload + 8, sizeof (*sequence));
+
+        returnValue = (magic == JOURNAL_MAGIC);
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Erase the sector after the current one and make it the newest live sector
+bool CRSCJournal::StartSector (void)
+{
+    unsigned nextSector = (CurrentSector + 1) % NumSectors;
+    journal_record_t header;
+    uint32_t magic = JOURNAL_MAGIC;
+    uint32_t nextSequence = Sequence + 1;
+
+    // If every sector is live, the next one holds the oldest records
+    if (LiveSectors >= NumSectors)
+        return (false);
+
+    if (ESP.flashEraseSector (FirstSector + nextSector) == false)
+        return (false);
+
+    memset (&header, 0, sizeof (header));
+    header.Type = JOURNAL_TYPE_HEADER;
+    memcpy (header.Payload, &magic, sizeof (magic));
+    memcpy (header.Payload + 4, &Epoch, sizeof (Epoch));
+    memcpy (header.Payload + 8, &nextSequence, sizeof (nextSequence));
+    header.Checksum = CalculateChecksum (&header);
+
+    if (WriteRecord (nextSector, 0, &header) == false)
+        return (false);
+
+    CurrentSector = nextSector;
+    Sequence = nextSequence;
+    LiveSectors++;
+    NextSlot = 1;
+
+    return (true);
+}
+
+// -----------------------------------------------------------------------------
+// Scan the flash and find the live records and the end of the journal. Must be
+// called before anything else. Torn or corrupt records are skipped.
+void CRSCJournal::Begin (void)
+{
+    uint32_t epoch, sequence;
+    bool found = false;
+
+    Epoch = 0;
+    Sequence = 0;
+    CurrentSector = NumSectors - 1;
+    LiveSectors = 0;
+    NextSlot = SlotsPerSector;
+
+    // The newest sector is the one with the highest epoch and sequence number
+    for (unsigned sector = 0; sector < NumSectors; sector++)
+    {
+        if (ReadHeader (sector, &epoch, &sequence) &&
+            ((found == false) || (epoch > Epoch) || ((epoch == Epoch) && (sequence > Sequence))))
+        {
+            Epoch = epoch;
+            Sequence = sequence;
+            CurrentSector = sector;
+            found = true;
+        }
+    }
+
+    if (found == true)
+    {
+        // Walk back from the newest sector for as long as the sectors carry on the sequence
+        LiveSectors = 1;
+        while (LiveSectors < NumSectors)
+        {
+            unsigned sector = (CurrentSector + NumSectors - LiveSectors) % NumSectors;
+
+            if ((ReadHeader (sector, &epoch, &sequence) == false) ||
+                (epoch != Epoch) || (sequence != Sequence - LiveSectors))
+                break;
+
+            LiveSectors++;
+        }
+
+        // The journal ends at the first erased slot in the newest sector. Slots are
+        // written in order, so everything after that is erased too and a binary
+        // search finds it.
+        journal_record_t theRecord;
+        unsigned low = 1;
+        unsigned high = SlotsPerSector;
+        while (low < high)
+        {
+            unsigned middle = (low + high) / 2;
+
+            if (ReadRecord (CurrentSector, middle, &theRecord) && IsErased (&theRecord))
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        NextSlot = low;
+    }
+
+    Rewind ();
+}
+
+// -----------------------------------------------------------------------------
+// Go back to the oldest live record
+void CRSCJournal::Rewind (void)
+{
+    ReadSector = (CurrentSector + NumSectors + 1 - LiveSectors) % NumSectors;
+    ReadSectorsLeft = LiveSectors;
+    ReadSlot = 1;
+}
+
+// -----------------------------------------------------------------------------
+// Read the next live record, oldest first. Returns false when there are no more.
+bool CRSCJournal::ReadNext (journal_record_t* theRecord)
+{
+    while (ReadSectorsLeft > 0)
+    {
+        // The newest sector is only written up to NextSlot
+        unsigned lastSlot = (ReadSectorsLeft == 1) ? NextSlot : SlotsPerSector;
+
+        while (ReadSlot < lastSlot)
+        {
+            bool readOK = ReadRecord (ReadSector, ReadSlot++, theRecord);
+
+            if (readOK && (IsErased (theRecord) == false) && (theRecord->Checksum == CalculateChecksum (theRecord)))
+                return (true);
+        }
+
+        ReadSector = (ReadSector + 1) % NumSectors;
+        ReadSectorsLeft--;
+        ReadSlot = 1;
+    }
+    return (false);
+}
+
+// -----------------------------------------------------------------------------
+// Add a record to the end of the journal. Returns false if the journal is
+// full, or the flash write failed.
+bool CRSCJournal::Append (unsigned char theType, const void* thePayload, size_t payloadLen)
+{
+    journal_record_t theRecord;
+
+    if (payloadLen > JOURNAL_PAYLOAD_LEN)
+        return (false);
+
+    memset (&theRecord, 0, sizeof (theRecord));
+    theRecord.Type = theType;
+    if (payloadLen > 0)
+        memcpy (theRecord.Payload, thePayload, payloadLen);
+
+    return (Append (&theRecord, 1));
+}
+
+// -----------------------------------------------------------------------------
+// Add several records to the end of the journal. Type and payload must be filled
+// in; the checksums are filled in here. Records that share a sector go out in a
+// single flash write. Returns false if the journal filled up part way, or a flash
+// write failed.
+bool CRSCJournal::Append (journal_record_t* theRecords, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++)
+        theRecords[i].Checksum = CalculateChecksum (&theRecords[i]);
+
+    while (count > 0)
+    {
+        // Move on to a fresh sector if the current one is used up
+        if ((LiveSectors == 0) || (NextSlot >= SlotsPerSector))
+        {
+            if (StartSector () == false)
+                return (false);
+        }
+
+        unsigned run = SlotsPerSector - NextSlot;
+        if (run > count)
+            run = count;
+
+        uint32_t offset = (FirstSector + CurrentSector) * SPI_FLASH_SEC_SIZE + NextSlot * sizeof (journal_record_t);
+        bool writeOK = ESP.flashWrite (offset, (uint32_t*)theRecords, run * sizeof (journal_record_t));
+
+        // The slots are used up even if the write fails - they can't be written twice
+        NextSlot += run;
+        theRecords += run;
+        count -= run;
+
+        if (writeOK == false)
+            return (false);
+    }
+    return (true);
+}
+
+// -----------------------------------------------------------------------------
+// Retire every record written so far. Takes one sector erase.
+bool CRSCJournal::Reset (void)
+{
+    Epoch++;
+    LiveSectors = 0;
+
+    bool returnValue = StartSector ();
+
+    Rewind ();
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Return the number of records that can be appended before the journal is full
+unsigned CRSCJournal::GetFreeRecords (void)
+{
+    unsigned returnValue = (NumSectors - LiveSectors) * (SlotsPerSector - 1);
+
+    if (LiveSectors > 0)
+        returnValue += SlotsPerSector - NextSlot;
+
+    return (returnValue);
+}
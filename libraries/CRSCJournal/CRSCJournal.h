@@ -0,0 +1,135 @@
+#ifndef _CRSCJOURNAL_H
+#define _CRSCJOURNAL_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <spi_flash.h>
+
+// Number of payload bytes in a journal record
+#define JOURNAL_PAYLOAD_LEN 12
+
+// One record in the journal. Records are 16 bytes so they stay on the 4 byte
+// boundaries flash writes need.
+typedef struct
+{
+    unsigned char Type;                          // What the record holds. Erased flash reads as 0xff.
+    unsigned char Checksum;                      // One's complement checksum of the rest of the record
+    unsigned char Reserved[2];
+    unsigned char Payload[JOURNAL_PAYLOAD_LEN];
+} __attribute__((aligned(4))) journal_record_t;
+
+// An append-only log of small records kept in raw flash sectors. Appending a
+// record programs 16 bytes - no erase - so it's cheap and gentle on the flash
+// compared with rewriting a whole emulated EEPROM sector.
+//
+// The sectors are used as a ring. Each one starts with a header holding an
+// epoch and a sequence number. Only sectors in the newest epoch are live, and
+// they are read back in sequence order. Reset() starts a new epoch, which
+// retires everything written before it without erasing anything; old sectors
+// are erased one at a time as the ring comes back round to them, so erases
+// are spread evenly over all the sectors.
+//
+// The records' owner is expected to keep a snapshot somewhere else. When
+// Append() reports the journal is full, fold the records into the snapshot,
+// save it, then call Reset().
+class CRSCJournal
+{
+protected:
+    // The first flash sector we use and how many there are
+    uint32_t FirstSector;
+    unsigned NumSectors;
+
+    // The current epoch and the sequence number of the newest live sector
+    uint32_t Epoch;
+    uint32_t Sequence;
+
+    // The newest live sector (the one being appended to), how many sectors are
+    // live and the next free slot in the newest sector. When nothing is live,
+    // CurrentSector is the sector before the one the next record will go in.
+    unsigned CurrentSector;
+    unsigned LiveSectors;
+    unsigned NextSlot;
+
+    // Where ReadNext() is up to
+    unsigned ReadSector;
+    unsigned ReadSectorsLeft;
+    unsigned ReadSlot;
+
+    // Number of records in a sector, including the header
+    const unsigned SlotsPerSector = SPI_FLASH_SEC_SIZE / sizeof (journal_record_t);
+
+    // Return the one's complement checksum of a record
+    unsigned char CalculateChecksum (journal_record_t* theRecord);
+
+    // Return a flag which, when set, indicates that the record has never been written
+    bool IsErased (journal_record_t* theRecord);
+
+    // Read or write one record. Slot 0 of each sector is its header.
+    bool ReadRecord (unsigned sector, unsigned slot, journal_record_t* theRecord);
+    bool WriteRecord (unsigned sector, unsigned slot, journal_record_t* theRecord);
+
+    // Read the header of a sector. Returns true if it has a valid one.
+    bool ReadHeader (unsigned sector, uint32_t* epoch, uint32_t* sequence);
+
+    // Erase the sector after the current one and make it the newest live sector
+    bool StartSector (void);
+
+public:
+    // Constructor. The journal uses numSectors sectors starting at firstSector.
+    CRSCJournal (uint32_t firstSector, unsigned numSectors);
+
+    // Scan the flash and find the live records and the end of the journal. Must be
+    // called before anything else. Torn or corrupt records are skipped.
+    void Begin (void);
+
+    // Go back to the oldest live record
+    void Rewind (void);
+
+    // Read the next live record, oldest first. Returns false when there are no more.
+    bool ReadNext (journal_record_t* theRecord);
+
+    // Add a record to the end of the journal. Returns false if the journal is
+    // full, or the flash write failed.
+    bool Append (unsigned char theType, const void* thePayload, size_t payloadLen);
+
+    // Add several records to the end of the journal. Type and payload must be filled
+    // in; the checksums are filled in here. Records that share a sector go out in a
+    // single flash write. Returns false if the journal filled up part way, or a flash
+    // write failed.
+    bool Append (journal_record_t* theRecords, unsigned count);
+
+    // Retire every record written so far. Takes one sector erase.
+    bool Reset (void);
+
+    // Return the number of records that can be appended before the journal is full
+    unsigned GetFreeRecords (void);
+};
+
+#endif
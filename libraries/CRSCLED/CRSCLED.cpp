@@ -31,67 +31,59 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CRSCLED.h"
 
 
-const int LEDShortPulse = 100;      // milliseconds
-const int LEDLongPulse  = 500;      // milliseconds
-const int LEDOffPulse   = 500;      // milliseconds - off time betweeen on pulses
-const int LEDGapPulse   = 1500;     // milliseconds - off time between sequences
+// Pulse lengths come from the game policy
+const int LEDShortPulse = CRSCGame::LEDShortPulse;    // milliseconds
+const int LEDLongPulse  = CRSCGame::LEDLongPulse;     // milliseconds
+const int LEDOffPulse   = CRSCGame::LEDOffPulse;      // milliseconds - off time betweeen on pulses
+const int LEDGapPulse   = CRSCGame::LEDGapPulse;      // milliseconds - off time between sequences
 
+// Runs are held in 16 bits
+static_assert ((LEDLongPulse <= 0xffff) && (LEDShortPulse <= 0xffff) && (LEDOffPulse + LEDGapPulse <= 0xffff),
+               "LED pulses are too long for a FlashEntry_t");
 
 	
 // -----------------------------------------------------------------------------
-// Initialize the flash list using the current fingerprint
+// Compile the flash list from the current fingerprint
 void CRSCLED::InitializeFlashList (void)
 {
 	unsigned long thePrint = Fingerprint;
 	
-  // Going up by 2 here because each character in the ID string corresponds to 
-  // the LED being on for an amount of time and off for an amount of time
-  for (int i = 0; i < (BOARD_ID_BYTES*2); i+= 2)
+  // Going up by 2 here because each bit in the fingerprint results in the LED
+  // being on for an amount of time and then off for an amount of time
+  for (int i = 0; i < CRSCGame::FlashListLen; i += 2)
   {
   	 // This is the on part. A 1 results in a long pulse and a 0 results in
   	 // a short pulse.
-     if (thePrint & 0x01)
-     {
-          FlashList[i].StateMilliseconds = LEDLongPulse;
-     }
-     else
-     {
-          FlashList[i].StateMilliseconds = LEDShortPulse;
-     }
- 
-     FlashList[i].MillisecondsSoFar = 0;
-     FlashList[i].LEDState = 0;           // 0 is on
-
-     FlashList[i+1].StateMilliseconds = LEDOffPulse;
-     FlashList[i+1].MillisecondsSoFar = 0;
-     FlashList[i+1].LEDState = 1;         // 1 is off
+     FlashList[i].Milliseconds = (thePrint & 0x01) ? LEDLongPulse : LEDShortPulse;
+     FlashList[i].LEDState = LED_ON;
+
+     FlashList[i+1].Milliseconds = LEDOffPulse;
+     FlashList[i+1].LEDState = LED_OFF;
      
      thePrint = thePrint >> 1;
   }
 
-  // Last one - the gap between flash sequences
-  FlashList[BOARD_ID_BYTES*2].StateMilliseconds = LEDGapPulse;
-  FlashList[BOARD_ID_BYTES*2].MillisecondsSoFar = 0;
-  FlashList[BOARD_ID_BYTES*2].LEDState = 1;  // 1 is off
+  // Last one - the gap between flash sequences runs straight on from the
+  // last off pulse
+  FlashList[CRSCGame::FlashListLen - 1].Milliseconds += LEDGapPulse;
     
   // And reset our flash list index to the last element. This causes the
   // flash to start with a gap.
-  FlashListIndex = (BOARD_ID_BYTES*2);
+  FlashListIndex = (CRSCGame::FlashListLen - 1);
 }
 	
 
 // -----------------------------------------------------------------------------
-// Called every UpdateInterval seconds to update the LED (for flashing)
+// Called by the timer at the end of each run
 void CRSCLED::LEDTickerCallback(CRSCLED* thisLED)
 {
-    thisLED->Update();
+    thisLED->NextRun();
 }
 
 // -----------------------------------------------------------------------------
-CRSCLED::CRSCLED(int theLEDPin, float updateInterval)
+CRSCLED::CRSCLED(int theLEDPin)
 { 
 	Fingerprint = 0x00; 
-	UpdateInterval = updateInterval;
 	TheLEDPin = theLEDPin;
 	
 	// Set up control pin for LED and turn it off
@@ -105,36 +97,27 @@ CRSCLED::CRSCLED(int theLEDPin, float updateInterval)
 }
 	
 // -----------------------------------------------------------------------------
-// Set the fingerprint value
+// Set the fingerprint value and start flashing it
 void CRSCLED::SetFingerprint (unsigned long newPrint)
 { 
 	Fingerprint = newPrint; 
 	InitializeFlashList();
 	
-	// Attach the callback that causes the LED to flash
-    LEDFlasher.attach <CRSCLED*> (UpdateInterval/1000.0, LEDTickerCallback, this); 
+	// Start with the gap
+    digitalWrite (TheLEDPin, FlashList[FlashListIndex].LEDState);  
+    LEDFlasher.once_ms <CRSCLED*> (FlashList[FlashListIndex].Milliseconds, LEDTickerCallback, this); 
 }
 	
 // -----------------------------------------------------------------------------
-// Update the LED. Should be called every UpdateInterval.
-void CRSCLED::Update (void)
+// Move on to the next run - set the LED and arm the timer for the end of the run
+void CRSCLED::NextRun (void)
 {
-    FlashList[FlashListIndex].MillisecondsSoFar += UpdateInterval;
-
-    // If we've been in this state for the appropriate amount of time
-    if (FlashList[FlashListIndex].MillisecondsSoFar >= FlashList[FlashListIndex].StateMilliseconds)
-    {
-        // Reset it for next time
-        FlashList[FlashListIndex].MillisecondsSoFar = 0;
-
-        // And move to the next state
-        FlashListIndex ++;
-        if (FlashListIndex > BOARD_ID_BYTES*2)
-            FlashListIndex = 0;
-
-        // Set the LED accordingly
-        digitalWrite (TheLEDPin, FlashList[FlashListIndex].LEDState);  
-    }     
+    FlashListIndex ++;
+    if (FlashListIndex >= CRSCGame::FlashListLen)
+        FlashListIndex = 0;
+
+    digitalWrite (TheLEDPin, FlashList[FlashListIndex].LEDState);  
+    LEDFlasher.once_ms <CRSCLED*> (FlashList[FlashListIndex].Milliseconds, LEDTickerCallback, this); 
 }
 
 // -----------------------------------------------------------------------------
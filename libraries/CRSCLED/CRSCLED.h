@@ -36,58 +36,54 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LED_ON  0
 
 
+// Flashes the board's fingerprint on the LED. The flash sequence is compiled
+// into a list of runs - a level and how long to hold it - and played by a
+// one-shot timer that is re-armed at each edge, so the timer only fires when
+// the LED actually changes and every edge lands when the policy says it should.
 class CRSCLED
 {
 protected:
     
-    // Takes care of running the LED flashing function periodically
+    // Fires once at the end of each run
     Ticker LEDFlasher;
 	
-    // Structure to store the LED flash sequence associated with this board ID
-    // Delta list-like structure to describe led flash codes
+    // One run of the flash sequence
     typedef struct 
 	{
-	    // number of milliseconds we should be in this state
-	    int StateMilliseconds;
-
-	    // Number of milliseconds we've been in this state so far
-	    int MillisecondsSoFar;
-
-	    // The state of LED for this entry (0= off; 1 = on)
-	    unsigned char LEDState;      
+	    // number of milliseconds to hold the LED at this level
+	    uint16_t Milliseconds;
+	    // LED_ON or LED_OFF
+	    uint8_t LEDState;      
 	} FlashEntry_t;
 
-	// Array to store all LED states to implement flashing. Each
-	// byte in the board ID requires two states (on and off) and there
-	// is a single state at the end to provide a longer "off" gap between
-	// flash sequences.
-	FlashEntry_t FlashList[BOARD_ID_BYTES*2+1];
+	// The flash sequence. Each bit in the fingerprint is an on run and an off
+	// run. The off run after the last bit also holds the longer "off" gap
+	// between flash sequences.
+	FlashEntry_t FlashList[CRSCGame::FlashListLen];
   	  
 	// Index into our FlashList
-	int FlashListIndex;
+	uint8_t FlashListIndex;
   	  
 	// The hardware pin the LED is connected to
 	int TheLEDPin;
-  	
-	float UpdateInterval;  // How often LED is updated, in seconds
 	
 	unsigned long Fingerprint;  // The fingerprint of our board ID, used to determine flash sequence
 	
-	// Initialize the flash list using the current fingerprint
+	// Compile the flash list from the current fingerprint
 	void InitializeFlashList (void);
 	
-	// Called every UpdateInterval seconds to update the LED (for flashing)
+	// Move on to the next run - set the LED and arm the timer for the end of the run
+	void NextRun (void);
+	
+	// Called by the timer at the end of each run
 	static void LEDTickerCallback(CRSCLED* thisLED);
 	
 public:
 	
-    CRSCLED (int theLEDPin, float updateInterval);
+    CRSCLED (int theLEDPin);
 	
-    // Set the fingerprint value
+    // Set the fingerprint value and start flashing it
     void SetFingerprint (unsigned long newPrint);
-	
-    // Update the LED. Should be called every UpdateInterval.
-    void Update (void);
     
     // Force the LED On
     void SetOn(void);
@@ -96,5 +92,4 @@ public:
     void SetOff(void);
     
 };
-
 #endif
@@ -0,0 +1,181 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCMetrics.h"
+
+const char* const CRSCMetrics::MetricNames[NUM_METRICS] =
+{
+    "loop_us",
+    "cmd_us",
+    "commit_us",
+    "wifi_ms",
+    "send_ms"
+};
+
+const char* const CRSCMetrics::CounterNames[NUM_COUNTERS] =
+{
+    "wifi_fail",
+    "send_fail"
+};
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCMetrics::CRSCMetrics (void)
+{
+    Reset();
+}
+
+// -----------------------------------------------------------------------------
+// Forget everything recorded so far
+void CRSCMetrics::Reset (void)
+{
+    memset (Histograms, 0, sizeof (Histograms));
+    memset (Counters, 0, sizeof (Counters));
+
+    for (unsigned i = 0; i < NUM_METRICS; i++)
+        Histograms[i].Min = 0xffffffff;
+
+    MinFreeHeap = 0xffffffff;
+    MinMaxFreeBlock = 0xffffffff;
+}
+
+// -----------------------------------------------------------------------------
+// Add a measurement to a histogram
+void CRSCMetrics::Record (Metric_t theMetric, uint32_t theValue)
+{
+    Histogram_t* theHistogram = &Histograms[theMetric];
+
+    // The bucket is the number of significant bits
+    unsigned bucket = (theValue == 0) ? 0 : 32 - __builtin_clz (theValue);
+    if (bucket >= NumBuckets)
+        bucket = NumBuckets - 1;
+
+    theHistogram->Count++;
+    theHistogram->Sum += theValue;
+    theHistogram->Buckets[bucket]++;
+    if (theValue < theHistogram->Min)
+        theHistogram->Min = theValue;
+    if (theValue > theHistogram->Max)
+        theHistogram->Max = theValue;
+}
+
+// -----------------------------------------------------------------------------
+// Note how much heap is free, and the largest block, keeping the lowest of each
+void CRSCMetrics::SampleHeap (void)
+{
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t maxFreeBlock = ESP.getMaxFreeBlockSize();
+
+    if (freeHeap < MinFreeHeap)
+        MinFreeHeap = freeHeap;
+    if (maxFreeBlock < MinMaxFreeBlock)
+        MinMaxFreeBlock = maxFreeBlock;
+}
+
+// -----------------------------------------------------------------------------
+// Print a 64 bit number - Print only goes to 32
+void CRSCMetrics::PrintUint64 (Print* out, uint64_t theValue)
+{
+    char digits[21];
+    unsigned i = sizeof (digits) - 1;
+
+    digits[i] = 0x00;
+    do
+    {
+        digits[--i] = '0' + (theValue % 10);
+        theValue /= 10;
+    } while (theValue != 0);
+
+    out->print (digits + i);
+}
+
+// -----------------------------------------------------------------------------
+// Print everything on one line, labelled with theID - as key=value pairs, or
+// as a JSON object if asJSON is set. Histograms print their count, sum, min, max
+// and buckets, with the buckets after the last one in use left off.
+void CRSCMetrics::Report (Print* out, const char* theID, bool asJSON)
+{
+    // Same values either way, different punctuation
+    const char* open = asJSON ? "{\"id\":\"" : "id=";
+    const char* keyStart = asJSON ? ",\"" : " ";
+    const char* keyEnd = asJSON ? "\":" : "=";
+
+    SampleHeap();
+
+    out->print (open); out->print (theID); if (asJSON) out->print ('"');
+    out->print (keyStart); out->print (F("uptime_ms")); out->print (keyEnd); out->print (millis());
+    out->print (keyStart); out->print (F("heap_free")); out->print (keyEnd); out->print (ESP.getFreeHeap());
+    out->print (keyStart); out->print (F("heap_free_min")); out->print (keyEnd); out->print (MinFreeHeap);
+    out->print (keyStart); out->print (F("heap_block")); out->print (keyEnd); out->print ((uint32_t)ESP.getMaxFreeBlockSize());
+    out->print (keyStart); out->print (F("heap_block_min")); out->print (keyEnd); out->print (MinMaxFreeBlock);
+
+    for (unsigned i = 0; i < NUM_COUNTERS; i++)
+    {
+        out->print (keyStart); out->print (CounterNames[i]); out->print (keyEnd); out->print (Counters[i]);
+    }
+
+    for (unsigned i = 0; i < NUM_METRICS; i++)
+    {
+        Histogram_t* theHistogram = &Histograms[i];
+        unsigned usedBuckets = NumBuckets;
+
+        while ((usedBuckets > 0) && (theHistogram->Buckets[usedBuckets - 1] == 0))
+            usedBuckets--;
+
+        if (asJSON)
+        {
+            out->print (keyStart); out->print (MetricNames[i]); out->print (F("\":{\"n\":"));
+            out->print (theHistogram->Count);
+            out->print (F(",\"sum\":")); PrintUint64 (out, theHistogram->Sum);
+            out->print (F(",\"min\":")); out->print ((theHistogram->Count != 0) ? theHistogram->Min : 0);
+            out->print (F(",\"max\":")); out->print (theHistogram->Max);
+            out->print (F(",\"hist\":["));
+        }
+        else
+        {
+            // loop_us=n,sum,min,max,bucket0/bucket1/...
+            out->print (' '); out->print (MetricNames[i]); out->print ('=');
+            out->print (theHistogram->Count); out->print (',');
+            PrintUint64 (out, theHistogram->Sum); out->print (',');
+            out->print ((theHistogram->Count != 0) ? theHistogram->Min : 0); out->print (',');
+            out->print (theHistogram->Max); out->print (',');
+        }
+
+        for (unsigned b = 0; b < usedBuckets; b++)
+        {
+            if (b > 0)
+                out->print (asJSON ? ',' : '/');
+            out->print (theHistogram->Buckets[b]);
+        }
+
+        if (asJSON)
+            out->print (F("]}"));
+    }
+
+    out->println (asJSON ? "}" : "");
+}
@@ -0,0 +1,121 @@
+#ifndef _CRSCMETRICS_H
+#define _CRSCMETRICS_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+// Counters and histograms of what the board spends its time on, for the M
+// command to print in a form a script can collect. Libraries are given one with
+// SetMetrics() and record into it as they go; without one they record nothing.
+//
+// Recording is a handful of adds and a count-leading-zeros, with no heap and no
+// floating point, so it can sit on every pass through loop(). Histograms use
+// power of two buckets: bucket 0 counts zeros, bucket b counts values from
+// 2^(b-1) up to 2^b - 1, and the last bucket also takes everything bigger.
+class CRSCMetrics
+{
+public:
+    // What's timed. The unit is part of the name.
+    typedef enum
+    {
+        METRIC_LOOP_MICROS,           // Passes through loop() that ran a task - time spent in tasks
+        METRIC_COMMAND_MICROS,        // Serial commands - time to parse and act on the line
+        METRIC_COMMIT_MICROS,         // Configuration commits - time to write flash
+        METRIC_WIFI_CONNECT_MILLIS,   // Wifi connections - time from Connect() to connected
+        METRIC_SEND_MILLIS,           // Notifications delivered - time from start of send to reply
+        NUM_METRICS
+    } Metric_t;
+
+    // What's counted
+    typedef enum
+    {
+        COUNTER_WIFI_FAILURES,        // Wifi connection attempts that timed out
+        COUNTER_SEND_FAILURES,        // Notification sends that didn't get a 2xx
+        NUM_COUNTERS
+    } Counter_t;
+
+    // Buckets per histogram. The last one starts at 2^(NumBuckets - 2).
+    static const unsigned NumBuckets = 16;
+
+protected:
+    typedef struct
+    {
+        uint32_t Count;
+        uint32_t Min;
+        uint32_t Max;
+        uint64_t Sum;
+        uint32_t Buckets[NumBuckets];
+    } Histogram_t;
+
+    Histogram_t Histograms[NUM_METRICS];
+    uint32_t Counters[NUM_COUNTERS];
+
+    // Lowest free heap and largest free block seen by SampleHeap()
+    uint32_t MinFreeHeap;
+    uint32_t MinMaxFreeBlock;
+
+    // Names as they're printed
+    static const char* const MetricNames[NUM_METRICS];
+    static const char* const CounterNames[NUM_COUNTERS];
+
+    // Print a 64 bit number - Print only goes to 32
+    static void PrintUint64 (Print* out, uint64_t theValue);
+
+public:
+    // Constructor
+    CRSCMetrics (void);
+
+    // Forget everything recorded so far
+    void Reset (void);
+
+    // Add a measurement to a histogram
+    void Record (Metric_t theMetric, uint32_t theValue);
+
+    // Add one to a counter
+    void Count (Counter_t theCounter)
+        { Counters[theCounter]++; }
+
+    // Note how much heap is free, and the largest block, keeping the lowest of each
+    void SampleHeap (void);
+
+    // Return what a histogram or counter holds
+    uint32_t GetCount (Metric_t theMetric)
+        { return (Histograms[theMetric].Count); }
+    uint32_t GetMax (Metric_t theMetric)
+        { return (Histograms[theMetric].Max); }
+    uint32_t GetCounter (Counter_t theCounter)
+        { return (Counters[theCounter]); }
+
+    // Print everything on one line, labelled with theID - as key=value pairs, or
+    // as a JSON object if asJSON is set
+    void Report (Print* out, const char* theID, bool asJSON);
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCScheduler.h"
+#include "CRSCTrace.h"
+
+// -----------------------------------------------------------------------------
+// Return a flag which, when set, indicates that millis() value now is at or
+// past theDeadline. Works across millis() wrapping.
+static bool IsDue (unsigned long now, unsigned long theDeadline)
+{
+    return ((long)(now - theDeadline) >= 0);
+}
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCScheduler::CRSCScheduler (void)
+{
+    NumTasks = 0;
+    Passes = 0;
+    IdleWaits = 0;
+    Wakeups = 0;
+    LastEventMillis = 0;
+    Metrics = NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Add a task. It runs on the first pass, then whenever its event function
+// returns true or a deadline it sets comes round. Returns the task's
+// number, or -1 if there is no room for it.
+int CRSCScheduler::AddTask (TaskFunction_t function, void* arg, EventFunction_t event)
+{
+    int returnValue = -1;
+
+    if (NumTasks < MaxTasks)
+    {
+        returnValue = NumTasks++;
+
+        Tasks[returnValue].Function = function;
+        Tasks[returnValue].Event = event;
+        Tasks[returnValue].Arg = arg;
+        Tasks[returnValue].Runs = 0;
+        Wake (returnValue);
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Run a task when millis() reaches dueMillis
+void CRSCScheduler::RunAt (int task, unsigned long dueMillis)
+{
+    Tasks[task].DueMillis = dueMillis;
+    Tasks[task].Scheduled = true;
+}
+
+// -----------------------------------------------------------------------------
+// Run a task theDelay milliseconds from now
+void CRSCScheduler::RunIn (int task, unsigned long theDelay)
+{
+    RunAt (task, millis() + theDelay);
+}
+
+// -----------------------------------------------------------------------------
+// Forget a task's deadline. It will only run again on its event or when woken.
+void CRSCScheduler::Suspend (int task)
+{
+    Tasks[task].Scheduled = false;
+}
+
+// -----------------------------------------------------------------------------
+// Return a flag which, when set, indicates that the task has input waiting
+bool CRSCScheduler::EventWaiting (Task_t* theTask)
+{
+    return ((theTask->Event != NULL) && theTask->Event (theTask->Arg));
+}
+
+// -----------------------------------------------------------------------------
+// Run every task that is due, then wait until one is. Call from loop().
+void CRSCScheduler::RunOnce (void)
+{
+    bool ranTask = false;
+    unsigned long startMicros = micros();
+
+    for (unsigned i = 0; i < NumTasks; i++)
+    {
+        Task_t* theTask = &Tasks[i];
+
+        bool hasEvent = EventWaiting (theTask);
+        if (hasEvent)
+            LastEventMillis = millis();
+
+        if ((theTask->Scheduled && IsDue (millis(), theTask->DueMillis)) || hasEvent)
+        {
+            // The deadline is used up. The task sets a new one if it wants one.
+            theTask->Scheduled = false;
+            theTask->Runs++;
+
+            unsigned long taskStartMillis = millis();
+            theTask->Function (theTask->Arg);
+            unsigned long taskMillis = millis() - taskStartMillis;
+            if (taskMillis >= SlowTaskMillis)
+                TheTrace.Record (CRSCTrace::TRACE_SLOW_TASK, ((uint32_t)i << 24) | (taskMillis & 0x00ffffff));
+
+            ranTask = true;
+        }
+    }
+
+    if (ranTask)
+    {
+        Passes++;
+
+        if (Metrics != NULL)
+        {
+            Metrics->Record (CRSCMetrics::METRIC_LOOP_MICROS, micros() - startMicros);
+            Metrics->SampleHeap();
+        }
+    }
+
+    Idle();
+}
+
+// -----------------------------------------------------------------------------
+// Wait until a task is due or has input
+void CRSCScheduler::Idle (void)
+{
+    unsigned long now = millis();
+    unsigned long wait = MaxIdleMillis;
+    bool watching = false;
+
+    for (unsigned i = 0; i < NumTasks; i++)
+    {
+        if (Tasks[i].Scheduled)
+        {
+            // Something is already due - don't sleep at all
+            if (IsDue (now, Tasks[i].DueMillis))
+                return;
+
+            if (Tasks[i].DueMillis - now < wait)
+                wait = Tasks[i].DueMillis - now;
+        }
+
+        if (Tasks[i].Event != NULL)
+        {
+            if (EventWaiting (&Tasks[i]))
+                return;
+            watching = true;
+        }
+    }
+
+    IdleWaits++;
+
+    // Sleep until the deadline, looking in on the event sources as we go - often
+    // if there's been an event lately, otherwise now and then
+    unsigned long start = now;
+    while (millis() - start < wait)
+    {
+        unsigned long slice = wait - (millis() - start);
+        unsigned long poll = (millis() - LastEventMillis < ActiveMillis) ? EventPollMillis : QuietPollMillis;
+        if (watching && (slice > poll))
+            slice = poll;
+
+        delay (slice);
+        Wakeups++;
+
+        if (watching)
+        {
+            for (unsigned i = 0; i < NumTasks; i++)
+            {
+                if (EventWaiting (&Tasks[i]))
+                    return;
+            }
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef _CRSCSCHEDULER_H
+#define _CRSCSCHEDULER_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+#include "CRSCMetrics.h"
+
+// Runs the sketch's tasks only when there is something for them to do -
+// either a deadline they asked for has come round or input they watch for has
+// arrived. Between times the board sits in delay(), which lets the WiFi stack
+// run and the CPU idle, instead of going round loop() on a fixed interval.
+//
+// Tasks are cooperative. Each one does a little work and returns. A deadline
+// is used up when the task runs, so a task that wants to run again calls
+// RunIn() before it returns; one that doesn't just waits for its event or for
+// another task to Wake() it.
+class CRSCScheduler
+{
+public:
+    // The work a task does, and a check for input it is waiting on
+    typedef void (*TaskFunction_t) (void* arg);
+    typedef bool (*EventFunction_t) (void* arg);
+
+protected:
+    // Everything we know about a task
+    typedef struct
+    {
+        TaskFunction_t Function;
+        EventFunction_t Event;        // NULL if the task only runs on deadlines
+        void* Arg;
+        bool Scheduled;               // A flag which, when set, indicates DueMillis is live
+        unsigned long DueMillis;
+        unsigned long Runs;
+    } Task_t;
+
+    // Most tasks a sketch can have
+    static const unsigned MaxTasks = 8;
+
+    // While idle, how often to check for input (milliseconds). The ESP8266
+    // core has no way to wake delay() when a character arrives - HardwareSerial
+    // offers no receive callback, and the core owns the UART interrupt - so
+    // input has to be polled for. Within ActiveMillis of an event - someone is
+    // typing, or output is going out - we look every EventPollMillis, so the
+    // end of a line is read straight away. Otherwise every QuietPollMillis: no
+    // longer than the old loop() slept, so the first command after a quiet spell
+    // never waits longer than it used to, and an idle board wakes 20 times a
+    // second. A sketch that takes pasted input needs a Serial receive buffer
+    // that takes longer than that to fill.
+    static const unsigned long EventPollMillis = 1;
+    static const unsigned long QuietPollMillis = 50;
+    static const unsigned long ActiveMillis = 2000;
+
+    // Longest we sit in delay() when nothing at all is scheduled (milliseconds)
+    static const unsigned long MaxIdleMillis = 1000;
+
+    // A task that runs for this long or more is noted in the trace (milliseconds)
+    static const unsigned long SlowTaskMillis = 100;
+
+    Task_t Tasks[MaxTasks];
+    unsigned NumTasks;
+
+    // How many times RunOnce() found something to do, how many times it went
+    // to sleep, and how many times it woke up to look for input or a deadline
+    unsigned long Passes;
+    unsigned long IdleWaits;
+    unsigned long Wakeups;
+
+    // millis() when a task last had an event waiting
+    unsigned long LastEventMillis;
+
+    // Where the time each pass spends in tasks goes, if anywhere
+    CRSCMetrics* Metrics;
+
+    // Return a flag which, when set, indicates that the task has input waiting
+    bool EventWaiting (Task_t* theTask);
+
+    // Wait until a task is due or has input
+    void Idle (void);
+
+public:
+    // Constructor
+    CRSCScheduler (void);
+
+    // Add a task. It runs on the first pass, then whenever its event function
+    // returns true or a deadline it sets comes round. Returns the task's
+    // number, or -1 if there is no room for it.
+    int AddTask (TaskFunction_t function, void* arg = NULL, EventFunction_t event = NULL);
+
+    // Record how long each pass that runs a task spends in tasks, and the heap
+    // left after it, in theMetrics
+    void SetMetrics (CRSCMetrics* theMetrics)
+        { Metrics = theMetrics; }
+
+    // Run a task when millis() reaches dueMillis, or theDelay milliseconds from now
+    void RunAt (int task, unsigned long dueMillis);
+    void RunIn (int task, unsigned long theDelay);
+
+    // Run a task on the next pass
+    void Wake (int task)
+        { RunIn (task, 0); }
+
+    // Forget a task's deadline. It will only run again on its event or when woken.
+    void Suspend (int task);
+
+    // Run every task that is due, then wait until one is. Call from loop().
+    void RunOnce (void);
+
+    // Return the number of passes that ran at least one task, the number of
+    // times we went idle, the number of times we woke from delay() and the
+    // number of times a task has run
+    unsigned long GetPasses (void)
+        { return (Passes); }
+    unsigned long GetIdleWaits (void)
+        { return (IdleWaits); }
+    unsigned long GetWakeups (void)
+        { return (Wakeups); }
+    unsigned long GetTaskRuns (int task)
+        { return (Tasks[task].Runs); }
+};
+
+#endif
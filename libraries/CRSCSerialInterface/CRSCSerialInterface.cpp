@@ -27,281 +27,490 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "CRSCSerialInterface.h"
+#include "CRSCConsole.h"
+#include "CRSCTrace.h"
 
 
-// Size of buffer for incoming serial characters
-#define BUF_SIZE 80
-
 // The code to use to enable host configuration commands - minimal security
 const char SecurityCode[] = "XNY556";
 
+// The commands, indexed by letter. The ones after G are for production and
+// not announced to users.
+constexpr CRSCSerialInterface::CommandEntry_t CRSCSerialInterface::CommandTable[26] =
+{
+    {'A', 1, false, &CRSCSerialInterface::ProcessACommand},   // Add a board ID to the scavenged list
+    {0x00, 0, false, NULL},
+    {'C', 1, true, &CRSCSerialInterface::ProcessCCommand},    // Send notifications to a collector instead of ifttt.com
+    {'D', 0, true, &CRSCSerialInterface::ProcessDCommand},    // Dump the configuration
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {'G', 0, false, &CRSCSerialInterface::ProcessGCommand},   // Display our own board ID
+    {'H', 0, false, &CRSCSerialInterface::ProcessHCommand},   // Help
+    {'I', 1, false, &CRSCSerialInterface::ProcessICommand},   // Set our board ID - reboots
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {'L', 0, false, &CRSCSerialInterface::ProcessLCommand},   // List the scavenged board IDs
+    {'M', 1, true, &CRSCSerialInterface::ProcessMCommand},    // Print metrics for a script to collect
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {'R', 1, true, &CRSCSerialInterface::ProcessRCommand},    // Reset EEPROM, optionally set board ID - reboots
+    {0x00, 0, false, NULL},
+    {'T', 1, true, &CRSCSerialInterface::ProcessTCommand},    // Dump the trace kept across resets
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {'W', 0, true, &CRSCSerialInterface::ProcessWCommand},    // Send a test message to ifttt.com
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL},
+    {0x00, 0, false, NULL}
+};
+
+
+// --------------------------------------------------------------------------- 
+// Return a flag which, when set, indicates that every entry in the command
+// table from i on is at the index for its letter
+constexpr bool CRSCSerialInterface::CommandTableInOrder (unsigned i)
+{
+    return ((i == 26) ||
+            (((CommandTable[i].Letter == 0x00) || (CommandTable[i].Letter == 'A' + i)) &&
+             CommandTableInOrder (i + 1)));
+}
+
 	
 // --------------------------------------------------------------------------- 
 // Constructor
 CRSCSerialInterface::CRSCSerialInterface (CRSCConfigClass* theConfiguration)
-	: Parser(&InputString) 
 { 
-    InputString = ""; 
     TheConfiguration = theConfiguration;
 
-    CommandComplete = false;
-    
-    // Reserve space for incoming commands to minimize heap fragmentation.
-    InputString.reserve(BUF_SIZE);
+    ReadPos = 0;
+    LineStart = 0;
+    WritePos = 0;
+    Wrapped = false;
+    WrapPos = LineBufferSize;
+    LinesQueued = 0;
+    Discarding = false;
+    Overflows = 0;
+    Metrics = NULL;
 }
 	
+// --------------------------------------------------------------------------- 
+// Store one character of the line being received. Returns false if
+// there's no room for it.
+bool CRSCSerialInterface::Store (char inChar)
+{
+    bool returnValue = true;
+
+    if ((Wrapped == false) && (WritePos == LineBufferSize))
+    {
+        unsigned length = WritePos - LineStart;
+
+        // Hit the end of the ring. Move what we have of this line to the
+        // front, as long as that doesn't run into lines still waiting.
+        if (LinesQueued == 0)
+        {
+            memmove (LineBuffer, LineBuffer + LineStart, length);
+            ReadPos = 0;
+        }
+        else if (length < ReadPos)
+        {
+            memmove (LineBuffer, LineBuffer + LineStart, length);
+            WrapPos = LineStart;
+            Wrapped = true;
+        }
+        else
+        {
+            returnValue = false;
+        }
+
+        if (returnValue == true)
+        {
+            LineStart = 0;
+            WritePos = length;
+        }
+    }
+    else if ((Wrapped == true) && (WritePos == ReadPos))
+    {
+        returnValue = false;
+    }
+
+    if (returnValue == true)
+        LineBuffer[WritePos++] = inChar;
+
+    return (returnValue);
+}
+
 // --------------------------------------------------------------------------- 
 // Add a character to the command currently being built up
 void CRSCSerialInterface::Add (char inChar)
 {
-    InputString += inChar;
-	
-    if (inChar == '\n')
-        CommandComplete = true;
+    if (Discarding == true)
+    {
+        // Wait for the end of the line we're throwing away
+        if (inChar == '\n')
+            Discarding = false;
+    }
+    else if ((inChar != '\n') && (WritePos - LineStart >= MaxLineLength))
+    {
+        // Too long to be a command - drop it rather than act on part of it
+        Overflows++;
+        WritePos = LineStart;
+        Discarding = true;
+    }
+    else if (Store ((inChar == '\n') ? 0x00 : inChar) == false)
+    {
+        // Commands are coming in faster than we're processing them
+        Overflows++;
+        WritePos = LineStart;
+        Discarding = (inChar != '\n');
+    }
+    else if (inChar == '\n')
+    {
+        LinesQueued++;
+        LineStart = WritePos;
+    }
 }
 	
 // ---------------------------------------------------------------------------
 // Display our help text
 void CRSCSerialInterface::DisplayHelp (void)
 {
-    Serial.println(F("Available commands:\n"));
-    Serial.println(F("H - Help - display this message"));
-    Serial.println(F("A <board ID> - Add a new board ID to your scavenged list"));
-    Serial.println(F("G - Get - Display the ID of this board"));
-    Serial.println(F("L - List - Display the current list of scavenged board IDs\n"));
+    TheConsole.println(F("Available commands:\n"));
+    TheConsole.println(F("H - Help - display this message"));
+    TheConsole.println(F("A <board ID> - Add a new board ID to your scavenged list"));
+    TheConsole.println(F("G - Get - Display the ID of this board"));
+    TheConsole.println(F("L - List - Display the current list of scavenged board IDs\n"));
 }
 
 // --------------------------------------------------------------------------- 
-// If we have a complete command, parse and act on it
+// Parse and act on every complete command we've received
 void CRSCSerialInterface::Update (void)
 {
-    char newID[BOARD_ID_BUF_LEN];
-	
-    bool okay = true;
-	
-    if (CommandComplete == true)
+    while (LinesQueued > 0)
     {
-        Parser.Reset();
-        		
-        char command = Parser.GetChar();
-        command = toupper(command);
-		    
-        switch (command)
+        unsigned length = strlen (LineBuffer + ReadPos);
+
+        unsigned long startMicros = micros();
+
+        Parser.SetLine (LineBuffer + ReadPos, length);
+        ProcessLine();
+
+        if (Metrics != NULL)
+            Metrics->Record (CRSCMetrics::METRIC_COMMAND_MICROS, micros() - startMicros);
+
+        // Move past the line and its terminator. Once everything at the back
+        // of the ring has been used up, carry on from the front.
+        LinesQueued--;
+        ReadPos += length + 1;
+        if ((Wrapped == true) && (ReadPos == WrapPos))
         {
-            // Run
-            case 'H':
-                if (Parser.IsMoreCommandLine())
-                    Serial.println (F("Warning: Unexepected command line characters encountered.\n"));
-                DisplayHelp();
-                break;
-        
-       
-            // Add a Board ID
-            case 'A':        
-                ProcessACommand();
-                break;  
-        
-            // Dump the list of scavenged board IDs
-            case 'L':        
-                if (Parser.IsMoreCommandLine())
-                    Serial.println (F("Warning: Unexepected command line characters encountered. Type 'H' for help.\n"));
-                
-                // Print scavenged ID list
-                TheConfiguration->PrintScavengedBoardList();
-                break;  
-        
-        
-            // Display our own board ID
-            case 'G':
-                if (Parser.IsMoreCommandLine())
-                {
-                    Serial.println (F("Warning: Unexepected command line characters encountered. Type 'H' for help\n"));
-                    DisplayHelp();
-                }
-                Serial.print (F("Your board ID is ")); Serial.print(TheConfiguration->GetBoardID()); Serial.println(F(" \n"));
-                break;
-        
-            // *** These commands are for production and not announced to users ***    
-                
-            // Dump the board's current configuration. Not documented in online help as it's intended to be used only by CANARIE staff.
-            // Requires security code.
-            case 'D':
-                
-               ProcessDCommand();  
-               break;
-            
-            
-            // Set our board ID. This can only be done when the Board ID in EEPROM has been cleared - ie. 000000. Meant to be used by CANARIE
-            // staff only so doesn't appear in help.
-            case 'I':
-                
-                ProcessICommand();   // Warning - this command reboots host
-                break;
-      					
-            // Reset EEPROM - Intended to be used by CANARIE during production/testing and so does not appear in help. You would typically
-            // use this command followed by the I command to reload the board ID
-            case 'R':
-      				
-                ProcessRCommand();  // Warning - this command reboots host
-                break;
-                
-            // This is for production purposes only. If you type the "W" command and the security code,
-            // a message will be sent to ifttt.com. This is used to verify connectivity and the Wifi hardware
-            case 'W':
-                
-                // Not really getting a board ID, but buffer was there so let's reuse it.
-                Parser.GetStringToWhitespace(newID, BOARD_ID_BUF_LEN);
-                      				 
-                if (strcmp(newID, SecurityCode) == 0)
-                {
-                    TheConfiguration->RequestWifiTest();
-                }
-                else
-                {
-                    Serial.println (F("\nWifi test cancelled - invalid security code\n"));
-                }
-                break;
-            
-                
-            case 0x00:
+            ReadPos = 0;
+            Wrapped = false;
+        }
+    }
 
-                // Just a new line. Let it go and don't bother user with invalid command error message.
-                Serial.println();
-                break;
-      					 
-            default:
-                Serial.println (F("Invalid command\n"));
-                break;
+    // If nothing at all is waiting, start again at the front of the ring so
+    // lines don't need moving as often
+    if ((LineStart == WritePos) && (Wrapped == false))
+    {
+        ReadPos = 0;
+        LineStart = 0;
+        WritePos = 0;
+    }
+}
+
+// --------------------------------------------------------------------------- 
+// Parse and act on one command line
+void CRSCSerialInterface::ProcessLine (void)
+{
+    CmdToken_t args[MaxCommandArgs];
+    const CommandEntry_t* entry = NULL;
 
+    // Commands are looked up by letter, so every entry has to be in its place
+    static_assert (CommandTableInOrder (0), "CommandTable is out of order");
+
+    char command = toupper(Parser.GetChar());
+
+    if ((command >= 'A') && (command <= 'Z') && (CommandTable[command - 'A'].Handler != NULL))
+        entry = &CommandTable[command - 'A'];
+
+    if (command == 0x00)
+    {
+        // Just a new line. Let it go and don't bother user with invalid command error message.
+        TheConsole.println();
+    }
+    else if (entry == NULL)
+    {
+        TheConsole.println (F("Invalid command\n"));
+    }
+    else
+    {
+        TheTrace.Record (CRSCTrace::TRACE_COMMAND, command);
+
+        unsigned wanted = entry->Arguments + (entry->NeedsSecurityCode ? 1 : 0);
+
+        // Arguments the user leaves off are passed to the handler empty
+        for (unsigned i = 0; i < MaxCommandArgs; i++)
+        {
+            args[i].Start = "";
+            args[i].Length = 0;
         }
-    
-        CommandComplete = false;
-        InputString = ""; 
-        
-    }  
+
+        if (Parser.Tokenize(args, wanted) > wanted)
+            TheConsole.println (F("Warning: Unexepected command line characters encountered. Type 'H' for help.\n"));
+
+        if (entry->NeedsSecurityCode == false)
+            (this->*entry->Handler)(args);
+        else if (CRSCCmdParser::TokenEquals(&args[0], SecurityCode))
+            (this->*entry->Handler)(args + 1);
+        else
+            TheConsole.println (F("\nCommand cancelled - invalid security code\n"));
+    }
 }
 
 // -----------------------------------------------------------------------------
-void CRSCSerialInterface::ProcessACommand (void)
+// A <board ID> - add a board ID to the scavenged list
+void CRSCSerialInterface::ProcessACommand (const CmdToken_t* args)
 {          
     char newID[BOARD_ID_BUF_LEN];
 
-    Parser.GetStringToWhitespace(newID, BOARD_ID_BUF_LEN);
-                
-    if (Parser.IsMoreCommandLine())
-       Serial.println (F("Warning: Unexepected command line characters encountered.\n"));
-
+    CRSCCmdParser::CopyToken(&args[0], newID, BOARD_ID_BUF_LEN);
 		    			
     // Figure out where the next avaiable space is and add this, along with check digit
     bool newIDOkay = TheConfiguration->AddNewScavengedID(newID);
     if (newIDOkay)
     {
-        Serial.print (F("Addition successful - you now have "));
-        Serial.print (TheConfiguration->GetNumScavengedBoardIDs());
-        Serial.println (F(" scavenged ID(s)\n"));
+        TheConsole.print (F("Addition successful - you now have "));
+        TheConsole.print (TheConfiguration->GetNumScavengedBoardIDs());
+        TheConsole.println (F(" scavenged ID(s)\n"));
     }
     else
     {
-        Serial.println(F("Oh no!! Scavenged board ID could not be added"));
-        Serial.println(F("This could be because:"));
-        Serial.println(F(" - It's not a valid board ID - there are check bytes :)"));
-        Serial.println(F(" - It's from a board that doesn't match your flash code"));
-        Serial.println(F(" - It's the ID of your board"));
-        Serial.println(F(" - This board has already been added to your scavenged list\n"));
+        TheConsole.println(F("Oh no!! Scavenged board ID could not be added"));
+        TheConsole.println(F("This could be because:"));
+        TheConsole.println(F(" - It's not a valid board ID - there are check bytes :)"));
+        TheConsole.println(F(" - It's from a board that doesn't match your flash code"));
+        TheConsole.println(F(" - It's the ID of your board"));
+        TheConsole.println(F(" - This board has already been added to your scavenged list\n"));
     }
  
 }
 
 // -----------------------------------------------------------------------------
-void CRSCSerialInterface::ProcessDCommand (void) 
+// C <security code> [udp://]host[:port] - send notifications to a collector at
+// host:port, port 80 if none is given, instead of ifttt.com. With udp:// they go
+// as datagrams rather than HTTP. With no host, go back to ifttt.com. Intended to
+// be used only by CANARIE staff. Takes effect at the next power up.
+void CRSCSerialInterface::ProcessCCommand (const CmdToken_t* args)
 {
-          
-    char buf[BOARD_ID_BUF_LEN];
+    static const char UDPPrefix[] = "udp://";
+    char host[COLLECTOR_HOST_LEN];
+    unsigned long port = 80;
+    collector_transport_t transport = COLLECTOR_HTTP;
+    const char* hostStart = args[0].Start;
+    unsigned hostLength = args[0].Length;
 
-    Parser.GetStringToWhitespace(buf, BOARD_ID_BUF_LEN);
-    
-    if (strcmp(buf, SecurityCode) == 0)
+    // Host names aren't upper-cased like board IDs, so take the token as it is
+    if ((hostLength > sizeof (UDPPrefix) - 1) && (strncasecmp (hostStart, UDPPrefix, sizeof (UDPPrefix) - 1) == 0))
     {
-        Serial.println (F("\n\nDump configuration:\n"));
-        Serial.print (F("Wifi SSID: ")); Serial.println (TheConfiguration->GetWifiSSID());                    
-        Serial.print (F("Wifi Password: ")); Serial.println (TheConfiguration->GetWifiPassword());
-        Serial.print (F("IFTTT Key: ")); Serial.println (TheConfiguration->GetIFTTTKey());
-        Serial.print (F("Board ID: ")); Serial.println (TheConfiguration->GetBoardID());
-        Serial.print (F("Scavenged boards: ")); Serial.println (TheConfiguration->GetNumScavengedBoardIDs());
-                    
-        Serial.print (F("Fingerprint: ")); 
+        transport = COLLECTOR_UDP;
+        hostStart += sizeof (UDPPrefix) - 1;
+        hostLength -= sizeof (UDPPrefix) - 1;
+    }
+
+    const char* colon = (const char*)memchr (hostStart, ':', hostLength);
+    if (colon != NULL)
+    {
+        port = strtoul (colon + 1, NULL, 10);
+        hostLength = colon - hostStart;
+    }
+
+    if ((hostLength >= COLLECTOR_HOST_LEN) || (port == 0) || (port > 65535))
+    {
+        TheConsole.println (F("\nCollector not changed - use C <security code> [udp://]host[:port]\n"));
+        return;
+    }
+
+    memcpy (host, hostStart, hostLength);
+    host[hostLength] = 0x00;
+    TheConfiguration->SetCollector (host, (uint16_t)port, transport);
 
-        TheConfiguration->GetFingerprint(buf);
-        Serial.println (buf);
-                   
-        Serial.print (F("\n\n"));    
+    if (host[0] == 0x00)
+    {
+        TheConsole.println (F("\nNotifications will go to ifttt.com after the next power up\n"));
     }
     else
     {
-        Serial.println (F("Command cancelled - invalid security code\n"));
+        TheConsole.print (F("\nNotifications will go to ")); TheConsole.print ((transport == COLLECTOR_UDP) ? UDPPrefix : "");
+        TheConsole.print (host); TheConsole.print (':'); TheConsole.print (port);
+        TheConsole.println (F(" after the next power up\n"));
     }
 }
 
 // -----------------------------------------------------------------------------
-void CRSCSerialInterface::ProcessICommand (void) 
+// D <security code> - dump the board's current configuration. Intended to be
+// used only by CANARIE staff.
+void CRSCSerialInterface::ProcessDCommand (const CmdToken_t* args) 
+{
+    (void)args;
+    char buf[BOARD_ID_BUF_LEN];
+
+    TheConsole.println (F("\n\nDump configuration:\n"));
+    TheConsole.print (F("Wifi SSID: ")); TheConsole.println (TheConfiguration->GetWifiSSID());                    
+    TheConsole.print (F("Wifi Password: ")); TheConsole.println (TheConfiguration->GetWifiPassword());
+    TheConsole.print (F("IFTTT Key: ")); TheConsole.println (TheConfiguration->GetIFTTTKey());
+    TheConsole.print (F("Collector: "));
+    if (TheConfiguration->GetCollectorHost()[0] == 0x00)
+    {
+        TheConsole.println (F("ifttt.com"));
+    }
+    else
+    {
+        if (TheConfiguration->GetCollectorTransport() == COLLECTOR_UDP)
+            TheConsole.print (F("udp://"));
+        TheConsole.print (TheConfiguration->GetCollectorHost()); TheConsole.print (':');
+        TheConsole.println (TheConfiguration->GetCollectorPort());
+    }
+    TheConsole.print (F("Board ID: ")); TheConsole.println (TheConfiguration->GetBoardID());
+    TheConsole.print (F("Scavenged boards: ")); TheConsole.println (TheConfiguration->GetNumScavengedBoardIDs());
+                
+    TheConsole.print (F("Fingerprint: ")); 
+
+    TheConfiguration->GetFingerprint(buf);
+    TheConsole.println (buf);
+
+    TheConsole.print (F("Config commits: ")); TheConsole.print (TheConfiguration->GetCommits());
+    TheConsole.print (F(" (")); TheConsole.print (TheConfiguration->GetCommitsAvoided()); TheConsole.println (F(" avoided)"));
+    TheConsole.print (F("Serial lines dropped: ")); TheConsole.println (Overflows);
+    TheConsole.print (F("Messages waiting for ifttt.com: ")); TheConsole.println (TheConfiguration->GetQueuedMessages());
+               
+    TheConsole.print (F("\n\n"));    
+}
+
+// -----------------------------------------------------------------------------
+// G - display our own board ID
+void CRSCSerialInterface::ProcessGCommand (const CmdToken_t* args)
+{
+    (void)args;
+    TheConsole.print (F("Your board ID is ")); TheConsole.print(TheConfiguration->GetBoardID()); TheConsole.println(F(" \n"));
+}
+
+// -----------------------------------------------------------------------------
+// H - help
+void CRSCSerialInterface::ProcessHCommand (const CmdToken_t* args)
+{
+    (void)args;
+    DisplayHelp();
+}
+
+// -----------------------------------------------------------------------------
+// I <board ID> - set our board ID. This can only be done when the Board ID in
+// EEPROM has been cleared - ie. 000000. Reboots the board.
+void CRSCSerialInterface::ProcessICommand (const CmdToken_t* args) 
 {
     char buf[BOARD_ID_BUF_LEN];
 
     if (memcmp (TheConfiguration->GetBoardID(), UninitializedID, BOARD_ID_LEN) == 0)
     {
-        Parser.GetStringToWhitespace(buf, BOARD_ID_BUF_LEN);
+        CRSCCmdParser::CopyToken(&args[0], buf, BOARD_ID_BUF_LEN);
         bool okay = TheConfiguration->SetBoardID(buf);
                     
         if (okay)
         {
-             Serial.print(F("\nYour board ID is now ")); Serial.print(TheConfiguration->GetBoardID()); Serial.println(F("\n"));
-             Serial.println (F("Rebooting...There's a bug where reboots fail first time after flashing board"));
-             Serial.println (F("If board doesn't reboot, push reset button\n"));
+             TheConsole.print(F("\nYour board ID is now ")); TheConsole.print(TheConfiguration->GetBoardID()); TheConsole.println(F("\n"));
+             TheConsole.println (F("Rebooting...There's a bug where reboots fail first time after flashing board"));
+             TheConsole.println (F("If board doesn't reboot, push reset button\n"));
+             TheConfiguration->Flush();
+             TheTrace.Record (CRSCTrace::TRACE_RESTART, 'I');
+             TheConsole.Flush();
              ESP.restart();
         }
         else
         {
-             Serial.println(F("\nCommand cancelled - invalid board ID\n"));
+             TheConsole.println(F("\nCommand cancelled - invalid board ID\n"));
         }
     }
     else
     {
-        Serial.println(F("\nCommand cancelled - board ID already set\n"));
+        TheConsole.println(F("\nCommand cancelled - board ID already set\n"));
     }
 }
 
+// -----------------------------------------------------------------------------
+// L - list the scavenged board IDs
+void CRSCSerialInterface::ProcessLCommand (const CmdToken_t* args)
+{
+    (void)args;
+    TheConfiguration->PrintScavengedBoardList();
+}
+
+// -----------------------------------------------------------------------------
+// M <security code> [J] - print the metrics on one line, as key=value pairs or,
+// with J, as JSON. Intended for a script collecting from a room full of boards.
+void CRSCSerialInterface::ProcessMCommand (const CmdToken_t* args)
+{
+    if (Metrics == NULL)
+    {
+        TheConsole.println (F("No metrics on this board\n"));
+    }
+    else
+    {
+        bool asJSON = (args[0].Length == 1) && (toupper (args[0].Start[0]) == 'J');
+        Metrics->Report (&TheConsole, TheConfiguration->GetBoardID(), asJSON);
+    }
+}
 
 // -----------------------------------------------------------------------------
-void CRSCSerialInterface::ProcessRCommand (void) 
+// R <security code> [board ID] - reset EEPROM. Intended to be used by CANARIE
+// during production/testing. You would typically use this command followed by
+// the I command to reload the board ID, or give the board ID here.
+void CRSCSerialInterface::ProcessRCommand (const CmdToken_t* args) 
 {
-    
     char buf[BOARD_ID_BUF_LEN];
 
-    Parser.GetStringToWhitespace(buf, BOARD_ID_BUF_LEN);
-                      				 
-    if (strcmp(buf, SecurityCode) == 0)
+    TheConsole.println (F("Resetting EEPROM"));
+    TheConfiguration->Initialize(DEFAULT_WIFI_SSID, DEFAULT_WIFI_PASSWORD, DEFAULT_IFTTT_KEY);
+               
+    // Now, if there's a board ID on the command line as well, set it to be our board ID
+    CRSCCmdParser::CopyToken(&args[0], buf, BOARD_ID_BUF_LEN);
+    if (TheConfiguration->SetBoardID(buf))
     {
-         Serial.println (F("Resetting EEPROM"));
-         TheConfiguration->Initialize(DEFAULT_WIFI_SSID, DEFAULT_WIFI_PASSWORD, DEFAULT_IFTTT_KEY);
-                    
-         // Now, if there's a board ID on the command line as well, set it to be our board ID
-         Parser.GetString (buf, BOARD_ID_BUF_LEN);
-         if (TheConfiguration->SetBoardID(buf))
-         {
-              Serial.print (F("\nYour board ID is now ")); Serial.print(TheConfiguration->GetBoardID()); Serial.println(F("\n"));
-              Serial.println (F("Rebooting...There's a bug where reboots fail first time after flashing board"));
-              Serial.println (F("If board doesn't reboot, push reset button\n"));
-              ESP.restart();
-         }
-         else
-         {
-              Serial.println (F("\nNo new board ID specified - use the 'I' command to set a new board ID"));
-         }
-
+         TheConsole.print (F("\nYour board ID is now ")); TheConsole.print(TheConfiguration->GetBoardID()); TheConsole.println(F("\n"));
+         TheConsole.println (F("Rebooting...There's a bug where reboots fail first time after flashing board"));
+         TheConsole.println (F("If board doesn't reboot, push reset button\n"));
+         TheConfiguration->Flush();
+         TheTrace.Record (CRSCTrace::TRACE_RESTART, 'R');
+         TheConsole.Flush();
+         ESP.restart();
     }
     else
     {
-        Serial.println (F("\nEEPROM reset failed - invalid security code"));
+         TheConsole.println (F("\nNo new board ID specified - use the 'I' command to set a new board ID"));
     }
-   
+}
+
+// -----------------------------------------------------------------------------
+// T <security code> [C] - print the trace kept in RTC memory, oldest first, for
+// CRSCTraceDecode. With C, clear it afterwards.
+void CRSCSerialInterface::ProcessTCommand (const CmdToken_t* args)
+{
+    TheConsole.println (F("\nTrace:"));
+    TheTrace.Dump (&TheConsole);
+
+    if ((args[0].Length == 1) && (toupper (args[0].Start[0]) == 'C'))
+    {
+        TheTrace.Clear();
+        TheConsole.println (F("Trace cleared"));
+    }
+    TheConsole.println();
+}
+
+// -----------------------------------------------------------------------------
+// W <security code> - send a message to ifttt.com. This is for production
+// purposes only, to verify connectivity and the Wifi hardware.
+void CRSCSerialInterface::ProcessWCommand (const CmdToken_t* args)
+{
+    (void)args;
+    TheConfiguration->RequestWifiTest();
 }
@@ -30,45 +30,132 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
-#include <String.h>
+#include <Arduino.h>
 #include "CRSCCmdParser.h"
 #include "CRSCConfig.h"
+#include "CRSCMetrics.h"
 
 class CRSCSerialInterface
 {
 protected:
-    // String to store received characters
-    String InputString;
+    // Size of the ring that holds received command lines
+    static const unsigned LineBufferSize = 256;
+
+    // Longest command line we accept, not counting the line feed. Anything
+    // longer is dropped whole rather than acted on in part.
+    static const unsigned MaxLineLength = 80;
+
+    // Received command lines, one after the other, each with its line feed
+    // replaced by a 0x00. A line is never split across the end of the ring - if
+    // it would be, what we have of it so far is moved to the front - so the
+    // parser can be handed each line in place.
+    char LineBuffer[LineBufferSize];
+
+    // Where the oldest complete line starts
+    unsigned ReadPos;
+
+    // Where the line currently being received starts
+    unsigned LineStart;
+
+    // Where the next received character goes
+    unsigned WritePos;
+
+    // A flag which, when set, indicates that writing has started over at the
+    // front of the ring and is now behind ReadPos
+    bool Wrapped;
+
+    // When Wrapped is set, where the data at the back of the ring ends
+    unsigned WrapPos;
+
+    // Number of complete lines waiting to be processed
+    unsigned LinesQueued;
+
+    // A flag which, when set, indicates that we're throwing away the rest of
+    // the line currently being received
+    bool Discarding;
+
+    // Number of lines dropped because they were too long or the ring was full
+    unsigned long Overflows;
 	
     // Parser object
     CRSCCmdParser Parser;
 	
-    // A flag which, when set, indicates that we have received a complete
-    // command - ie. last character was a line feed
-    bool CommandComplete;
-	
     // Pointer to the configuration object
     CRSCConfigClass* TheConfiguration;
+
+    // Where command times go, and what the M command prints - NULL if there's nothing
+    CRSCMetrics* Metrics;
     
-    // Handlers for some of the longer commands - to keep Update() readable
-    void ProcessACommand(void);
-    void ProcessDCommand(void);
-    void ProcessICommand(void);
-    void ProcessRCommand(void);
+    // Store one character of the line being received. Returns false if
+    // there's no room for it.
+    bool Store (char inChar);
+
+    // Most arguments any command takes, counting the security code
+    static const unsigned MaxCommandArgs = 2;
+
+    // What the dispatcher needs to know about a command
+    typedef struct
+    {
+        // The command letter, or 0x00 for letters that aren't commands
+        char Letter;
+
+        // Number of arguments taken, not counting the security code
+        uint8_t Arguments;
+
+        // A flag which, when set, indicates that the first argument must be
+        // the security code
+        bool NeedsSecurityCode;
+
+        // The handler. args holds Arguments tokens, after the security code
+        // if there is one. Any the user left off are empty.
+        void (CRSCSerialInterface::*Handler) (const CmdToken_t* args);
+    } CommandEntry_t;
+
+    // The commands, indexed by letter starting at 'A'
+    static const CommandEntry_t CommandTable[26];
+
+    // Return a flag which, when set, indicates that every entry in the command
+    // table from i on is at the index for its letter
+    static constexpr bool CommandTableInOrder (unsigned i);
+
+    // Parse and act on one command line
+    void ProcessLine (void);
+
+    // Command handlers
+    void ProcessACommand (const CmdToken_t* args);
+    void ProcessCCommand (const CmdToken_t* args);
+    void ProcessDCommand (const CmdToken_t* args);
+    void ProcessGCommand (const CmdToken_t* args);
+    void ProcessHCommand (const CmdToken_t* args);
+    void ProcessICommand (const CmdToken_t* args);
+    void ProcessLCommand (const CmdToken_t* args);
+    void ProcessMCommand (const CmdToken_t* args);
+    void ProcessRCommand (const CmdToken_t* args);
+    void ProcessTCommand (const CmdToken_t* args);
+    void ProcessWCommand (const CmdToken_t* args);
     
 public:
     // Constructor
     CRSCSerialInterface (CRSCConfigClass* theConfiguration);
 	
+    // Record how long each command takes in theMetrics, and print them with the M command
+    void SetMetrics (CRSCMetrics* theMetrics)
+        { Metrics = theMetrics; }
+
     // Add a character to the command currently being built up
     void Add (char inChar);
 	
-    // If we have a complete command, parse and act on it
+    // Parse and act on every complete command we've received
     void Update (void);
     
     // Display our help text. Public so it can be called directly at startup
     // or in response the the terminal interface 'H' command.
     void DisplayHelp (void); 
+
+    // Return the number of command lines dropped because they were too long
+    // or arrived faster than they could be processed
+    unsigned long GetOverflows (void)
+        { return (Overflows); }
 };
 
 #endif
\ No newline at end of file
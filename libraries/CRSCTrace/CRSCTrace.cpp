@@ -0,0 +1,187 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCTrace.h"
+
+// Records are written to RTC memory a block at a time
+static_assert ((sizeof (CRSCTrace::TraceRecord_t) % 4) == 0, "TraceRecord_t must be a whole number of blocks");
+
+static const uint32_t BlocksPerRecord = sizeof (CRSCTrace::TraceRecord_t) / 4;
+
+CRSCTrace TheTrace;
+
+const char* const CRSCTrace::EventNames[NUM_TRACE_EVENTS] =
+{
+    "none",
+    "boot",
+    "exception_pc",
+    "setup_done",
+    "command",
+    "restart",
+    "config_commit",
+    "wifi_connect",
+    "wifi_connected",
+    "wifi_failed",
+    "wifi_lost",
+    "send_start",
+    "send_done",
+    "slow_task"
+};
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCTrace::CRSCTrace (void)
+{
+    Next = 0;
+    Sequence = 0;
+    Started = false;
+}
+
+// -----------------------------------------------------------------------------
+// Work out the check word for theRecord. A zeroed record doesn't pass.
+uint16_t CRSCTrace::CheckFor (const TraceRecord_t* theRecord)
+{
+    uint32_t fold = theRecord->Millis ^ (theRecord->Arg * 0x9e3779b1) ^
+                    ((uint32_t)theRecord->Event << 8) ^ theRecord->Sequence ^ 0x5a3c;
+
+    return ((uint16_t)(fold ^ (fold >> 16)));
+}
+
+// -----------------------------------------------------------------------------
+// Read the record in theSlot. Returns false if it isn't a valid record.
+bool CRSCTrace::ReadRecord (unsigned theSlot, TraceRecord_t* theRecord)
+{
+    bool returnValue = ESP.rtcUserMemoryRead (FirstBlock + theSlot * BlocksPerRecord, (uint32_t*)theRecord, sizeof (TraceRecord_t));
+
+    return (returnValue && IsValid (theRecord) && (theRecord->Event != TRACE_NONE));
+}
+
+// -----------------------------------------------------------------------------
+// Find where the trace left off before this boot and record the boot, with
+// why it happened
+void CRSCTrace::Begin (void)
+{
+    TraceRecord_t theRecord;
+    bool found = false;
+
+    // The newest record is the one the others are all behind. Sequence numbers
+    // wrap, but never by more than the length of the ring.
+    Next = 0;
+    Sequence = 0;
+    for (unsigned slot = 0; slot < TraceLen; slot++)
+    {
+        if (ReadRecord (slot, &theRecord) && ((found == false) || ((int8_t)(theRecord.Sequence - Sequence) >= 0)))
+        {
+            Next = (slot + 1) % TraceLen;
+            Sequence = theRecord.Sequence + 1;
+            found = true;
+        }
+    }
+    Started = true;
+
+    struct rst_info* resetInfo = ESP.getResetInfoPtr();
+    Record (TRACE_BOOT, (resetInfo->reason & 0xff) | ((resetInfo->exccause & 0xff) << 8));
+
+    if ((resetInfo->reason == REASON_EXCEPTION_RST) || (resetInfo->reason == REASON_SOFT_WDT_RST))
+        Record (TRACE_EXCEPTION_PC, resetInfo->epc1);
+}
+
+// -----------------------------------------------------------------------------
+// Add an event to the trace
+void CRSCTrace::Record (TraceEvent_t theEvent, uint32_t theArg)
+{
+    TraceRecord_t theRecord;
+    unsigned slot;
+
+    if (Started == false)
+        return;
+
+    // Take a slot. Only this part can't be interrupted - once the slot is ours
+    // nobody else writes to it.
+    noInterrupts();
+    slot = Next;
+    Next = (Next + 1 < TraceLen) ? Next + 1 : 0;
+    theRecord.Sequence = Sequence++;
+    interrupts();
+
+    theRecord.Millis = millis();
+    theRecord.Arg = theArg;
+    theRecord.Event = theEvent;
+    theRecord.Check = CheckFor (&theRecord);
+
+    ESP.rtcUserMemoryWrite (FirstBlock + slot * BlocksPerRecord, (uint32_t*)&theRecord, sizeof (theRecord));
+}
+
+// -----------------------------------------------------------------------------
+// Print theValue as hex, zero padded to theDigits
+static void PrintHex (Print* out, uint32_t theValue, int theDigits)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    for (int shift = (theDigits - 1) * 4; shift >= 0; shift -= 4)
+        out->print (hexDigits[(theValue >> shift) & 0x0f]);
+}
+
+// -----------------------------------------------------------------------------
+// Print the trace, oldest first, one line per record:
+//   T <sequence> <millis> <event> <arg>
+// all in hex
+void CRSCTrace::Dump (Print* out)
+{
+    TraceRecord_t theRecord;
+
+    for (unsigned i = 0; i < TraceLen; i++)
+    {
+        if (ReadRecord ((Next + i) % TraceLen, &theRecord))
+        {
+            out->print (F("T "));
+            PrintHex (out, theRecord.Sequence, 2);      out->print (' ');
+            PrintHex (out, theRecord.Millis, 8);        out->print (' ');
+            PrintHex (out, theRecord.Event, 2);         out->print (' ');
+            PrintHex (out, theRecord.Arg, 8);           out->println();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Forget everything in the trace
+void CRSCTrace::Clear (void)
+{
+    TraceRecord_t theRecord;
+
+    memset (&theRecord, 0, sizeof (theRecord));
+    for (unsigned slot = 0; slot < TraceLen; slot++)
+        ESP.rtcUserMemoryWrite (FirstBlock + slot * BlocksPerRecord, (uint32_t*)&theRecord, sizeof (theRecord));
+}
+
+// -----------------------------------------------------------------------------
+// Return the name of theEvent, for the decoder
+const char* CRSCTrace::GetEventName (unsigned theEvent)
+{
+    return ((theEvent < NUM_TRACE_EVENTS) ? EventNames[theEvent] : "unknown");
+}
@@ -0,0 +1,136 @@
+#ifndef _CRSCTRACE_H
+#define _CRSCTRACE_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+
+// A record of what the board was doing, kept in the ESP8266's RTC user memory
+// so it survives a crash, a watchdog reset or ESP.restart() - everything but a
+// power cut. After the board comes back the T command prints it, and
+// CRSCTraceDecode on a computer turns that into something readable.
+//
+// The trace is a ring of fixed size records, each with millis(), an event and
+// a 32 bit argument. Every record carries a sequence number and a check word,
+// so Begin() can find where the last boot left off and a record half written
+// when the board went down - or the noise RTC memory holds after a power cut -
+// is simply skipped.
+//
+// Record() takes a slot with interrupts masked for the two increments and
+// writes to it without holding anything, so it can be called from a Ticker
+// callback as well as from loop(). It costs one 12 byte write to RTC memory
+// and never touches flash or the heap.
+class CRSCTrace
+{
+public:
+    // What happened. Numbers are what the T command prints, so only ever add to
+    // the end of the list.
+    typedef enum
+    {
+        TRACE_NONE,
+        TRACE_BOOT,               // Arg: reset reason, with the exception cause in bits 8-15
+        TRACE_EXCEPTION_PC,       // Arg: where the exception or soft watchdog hit (epc1)
+        TRACE_SETUP_DONE,         // Arg: 1 if the configuration loaded
+        TRACE_COMMAND,            // Arg: the command letter
+        TRACE_RESTART,            // Arg: the command letter that asked for it
+        TRACE_CONFIG_COMMIT,      // Arg: microseconds it took
+        TRACE_WIFI_CONNECT,       // Arg: 1 for a fast rejoin, 2 for one asking DHCP, 0 for a full join
+        TRACE_WIFI_CONNECTED,     // Arg: milliseconds since Connect()
+        TRACE_WIFI_FAILED,        // Arg: milliseconds until the next attempt
+        TRACE_WIFI_LOST,
+        TRACE_SEND_START,         // Arg: notification sequence number
+        TRACE_SEND_DONE,          // Arg: SendResult_t, with the HTTP status in bits 8-23
+        TRACE_SLOW_TASK,          // Arg: task ID in bits 24-31, milliseconds it ran for below
+        NUM_TRACE_EVENTS
+    } TraceEvent_t;
+
+    // One entry, as it sits in RTC memory
+    typedef struct
+    {
+        uint32_t Millis;
+        uint32_t Arg;
+        uint8_t Event;
+        uint8_t Sequence;
+        uint16_t Check;
+    } TraceRecord_t;
+
+    // Where the ring starts in RTC user memory, in 4 byte blocks. The first 128
+    // bytes are left for the boot loader's OTA command.
+    static const uint32_t FirstBlock = 32;
+
+    // RTC user memory is 512 bytes
+    static const unsigned TraceLen = (512 - FirstBlock * 4) / sizeof (TraceRecord_t);
+
+protected:
+    // Slot the next record goes in, and its sequence number
+    unsigned Next;
+    uint8_t Sequence;
+
+    // A flag which, when set, indicates that Begin() has found our place.
+    // Until then Record() does nothing, so it can't write over the last boot.
+    bool Started;
+
+    // Names for the decoder
+    static const char* const EventNames[NUM_TRACE_EVENTS];
+
+    // Work out the check word for theRecord
+    static uint16_t CheckFor (const TraceRecord_t* theRecord);
+
+    // Read the record in theSlot. Returns false if it isn't a valid record.
+    bool ReadRecord (unsigned theSlot, TraceRecord_t* theRecord);
+
+public:
+    // Constructor
+    CRSCTrace (void);
+
+    // Find where the trace left off before this boot and record the boot, with
+    // why it happened. Call first thing in setup().
+    void Begin (void);
+
+    // Add an event to the trace
+    void Record (TraceEvent_t theEvent, uint32_t theArg = 0);
+
+    // Print the trace, oldest first, one "T" line per record for CRSCTraceDecode
+    void Dump (Print* out);
+
+    // Forget everything in the trace
+    void Clear (void);
+
+    // Return the name of theEvent, for the decoder
+    static const char* GetEventName (unsigned theEvent);
+
+    // Return a flag which, when set, indicates that theRecord is intact
+    static bool IsValid (const TraceRecord_t* theRecord)
+        { return (theRecord->Check == CheckFor (theRecord)); }
+};
+
+// There's only one RTC memory, so there's only one trace
+extern CRSCTrace TheTrace;
+
+#endif
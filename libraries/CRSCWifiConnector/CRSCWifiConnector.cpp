@@ -0,0 +1,273 @@
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "CRSCWifiConnector.h"
+#include "CRSCConsole.h"
+#include "CRSCTrace.h"
+
+// -----------------------------------------------------------------------------
+// Constructor
+CRSCWifiConnector::CRSCWifiConnector (void)
+    : Retry (RetryBaseMillis, RetryMaxMillis)
+{
+    SSID = NULL;
+    Password = NULL;
+    State = WIFI_STATE_IDLE;
+    RadioOn = true;
+
+    memset (&Cache, 0, sizeof (Cache));
+    UseCache = false;
+    FastAttempt = false;
+    StaticAttempt = false;
+    LeaseIP = 0;
+    LeaseStartMillis = 0;
+
+    ConnectStartMillis = 0;
+    AttemptStartMillis = 0;
+    LastProgressMillis = 0;
+    RetryStartMillis = 0;
+    RetryWaitMillis = 0;
+    LastConnectMilliseconds = 0;
+    Metrics = NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Return a flag which, when set, indicates that Cache's address is one DHCP
+// gave us since the board started, recently enough to use without asking again
+bool CRSCWifiConnector::LeaseFresh (void)
+{
+    return ((LeaseIP != 0) && (Cache.LocalIP == LeaseIP) && (millis() - LeaseStartMillis < AddressLifeMillis));
+}
+
+// -----------------------------------------------------------------------------
+// Start a new connection attempt
+void CRSCWifiConnector::StartAttempt (void)
+{
+    TheConsole.printf_P (PSTR("Connecting to %s\r\n"), SSID);
+
+    FastAttempt = UseCache;
+    StaticAttempt = FastAttempt && LeaseFresh();
+    TheTrace.Record (CRSCTrace::TRACE_WIFI_CONNECT, StaticAttempt ? 1 : (FastAttempt ? 2 : 0));
+    if (StaticAttempt)
+    {
+        // Straight to the access point and channel we used last time, with the
+        // address it gave us
+        WiFi.config (IPAddress (Cache.LocalIP), IPAddress (Cache.Gateway), IPAddress (Cache.Subnet), IPAddress (Cache.DNS));
+        WiFi.begin (SSID, Password, Cache.Channel, Cache.BSSID);
+    }
+    else if (FastAttempt)
+    {
+        // Straight to the access point and channel we used last time, but ask
+        // it for an address - the one we had may have gone to another board
+        WiFi.config (IPAddress ((uint32_t)0), IPAddress ((uint32_t)0), IPAddress ((uint32_t)0));
+        WiFi.begin (SSID, Password, Cache.Channel, Cache.BSSID);
+    }
+    else
+    {
+        // Scan for the access point and ask it for an address
+        WiFi.config (IPAddress ((uint32_t)0), IPAddress ((uint32_t)0), IPAddress ((uint32_t)0));
+        WiFi.begin (SSID, Password);
+    }
+
+    AttemptStartMillis = millis();
+    LastProgressMillis = AttemptStartMillis;
+    State = WIFI_STATE_CONNECTING;
+}
+
+// -----------------------------------------------------------------------------
+// Turn the radio on
+void CRSCWifiConnector::PowerUp (void)
+{
+    WiFi.forceSleepWake();
+    delay (1);                  // The SDK needs a moment before the mode can change
+    WiFi.mode (WIFI_STA);
+    RadioOn = true;
+}
+
+// -----------------------------------------------------------------------------
+// Turn the radio off
+void CRSCWifiConnector::PowerDown (void)
+{
+    WiFi.disconnect();
+    WiFi.mode (WIFI_OFF);
+    WiFi.forceSleepBegin();
+    delay (1);                  // Let the SDK put the modem to sleep
+    RadioOn = false;
+}
+
+// -----------------------------------------------------------------------------
+// Turn the radio off until Connect() is called, and stop the SDK saving
+// credentials to flash. Call from setup().
+void CRSCWifiConnector::Begin (void)
+{
+    WiFi.persistent (false);
+    PowerDown();
+}
+
+// -----------------------------------------------------------------------------
+// Ask to be connected to the access point with the credentials provided,
+// powering the radio up if need be. If theCache is given, and has something
+// in it, a fast rejoin is tried first. Does nothing if we're already connected
+// or working on it.
+void CRSCWifiConnector::Connect (const char* ssid, const char* password, const wifi_cache_t* theCache)
+{
+    if (State == WIFI_STATE_IDLE)
+    {
+        if (RadioOn == false)
+            PowerUp();
+
+        if (theCache != NULL)
+            memcpy (&Cache, theCache, sizeof (Cache));
+        else
+            memset (&Cache, 0, sizeof (Cache));
+        UseCache = (Cache.Channel != 0);
+
+        SSID = ssid;
+        Password = password;
+        ConnectStartMillis = millis();
+        StartAttempt();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Fill theCache in with the details of the current connection, for a fast
+// rejoin next time. Returns false if we're not connected, or the address
+// wasn't given to us by DHCP this time.
+bool CRSCWifiConnector::GetWifiCache (wifi_cache_t* theCache)
+{
+    bool returnValue = ((State == WIFI_STATE_CONNECTED) && (StaticAttempt == false));
+
+    memset (theCache, 0, sizeof (wifi_cache_t));
+    if (returnValue == true)
+    {
+        memcpy (theCache->BSSID, WiFi.BSSID(), sizeof (theCache->BSSID));
+        theCache->Channel = WiFi.channel();
+        theCache->LocalIP = (uint32_t)WiFi.localIP();
+        theCache->Gateway = (uint32_t)WiFi.gatewayIP();
+        theCache->Subnet = (uint32_t)WiFi.subnetMask();
+        theCache->DNS = (uint32_t)WiFi.dnsIP();
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------------------------------
+// Drop the connection, or stop trying to make one, and power the radio down
+void CRSCWifiConnector::Disconnect (void)
+{
+    if (State != WIFI_STATE_IDLE)
+    {
+        PowerDown();
+        State = WIFI_STATE_IDLE;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Move the connection process along. Call once per pass through loop().
+CRSCWifiConnector::WifiState_t CRSCWifiConnector::Update (void)
+{
+    unsigned long now = millis();
+
+    switch (State)
+    {
+        case WIFI_STATE_CONNECTING:
+
+            if (WiFi.status() == WL_CONNECTED)  // We're connected
+            {
+                LastConnectMilliseconds = now - ConnectStartMillis;
+                State = WIFI_STATE_CONNECTED;
+                Retry.Succeeded();
+
+                // A new lease - the cached address can be used for a while
+                if (StaticAttempt == false)
+                {
+                    LeaseIP = (uint32_t)WiFi.localIP();
+                    LeaseStartMillis = now;
+                }
+
+                TheTrace.Record (CRSCTrace::TRACE_WIFI_CONNECTED, LastConnectMilliseconds);
+                if (Metrics != NULL)
+                    Metrics->Record (CRSCMetrics::METRIC_WIFI_CONNECT_MILLIS, LastConnectMilliseconds);
+
+                TheConsole.printf_P (PSTR("\nWiFi connected in %lu ms (%s)\n\r\n"), LastConnectMilliseconds,
+                                     StaticAttempt ? "fast rejoin" : (FastAttempt ? "fast rejoin, new lease" : "full join"));
+            }
+            else if (FastAttempt && (now - AttemptStartMillis >= (StaticAttempt ? FastConnectTimeout : FastDHCPConnectTimeout)))
+            {
+                // The access point has moved, or our lease has gone. Forget what
+                // we knew and do it properly.
+                TheConsole.println(F("\nFast rejoin failed - doing a full join"));
+                WiFi.disconnect();
+                UseCache = false;
+                StartAttempt();
+            }
+            else if (now - AttemptStartMillis >= ConnectTimeout)
+            {
+                // Unable to connect. Leave ourselves in a good state and try again later.
+                RetryWaitMillis = Retry.Failed();
+                TheTrace.Record (CRSCTrace::TRACE_WIFI_FAILED, RetryWaitMillis);
+                if (Metrics != NULL)
+                    Metrics->Count (CRSCMetrics::COUNTER_WIFI_FAILURES);
+                TheConsole.printf_P (PSTR("\nWifi connection failed. Will try again in %lu seconds.\r\n"), (RetryWaitMillis + 500) / 1000);
+                TheConsole.println (F("In the mean time, please notify one of the CANARIE staff that you have completed the scavenger hunt\n\n"));
+                WiFi.disconnect();
+
+                RetryStartMillis = now;
+                State = WIFI_STATE_RETRY_WAIT;
+            }
+            else if (now - LastProgressMillis >= ProgressInterval)
+            {
+                TheConsole.print('.');
+                LastProgressMillis = now;
+            }
+            break;
+
+        case WIFI_STATE_RETRY_WAIT:
+
+            if (now - RetryStartMillis >= RetryWaitMillis)
+                StartAttempt();
+            break;
+
+        case WIFI_STATE_CONNECTED:
+
+            // If the access point drops us, start over
+            if (WiFi.status() != WL_CONNECTED)
+            {
+                TheConsole.println(F("\nWiFi connection lost"));
+                TheTrace.Record (CRSCTrace::TRACE_WIFI_LOST);
+                ConnectStartMillis = now;
+                StartAttempt();
+            }
+            break;
+
+        case WIFI_STATE_IDLE:
+        default:
+            break;
+    }
+
+    return (State);
+}
@@ -0,0 +1,215 @@
+#ifndef _CRSCWIFICONNECTOR_H
+#define _CRSCWIFICONNECTOR_H
+
+/*
+Copyright 2019 CANARIE Inc. All Rights Reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY CANARIE Inc. "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#include "CRSCBackoff.h"
+#include "CRSCConfigDefs.h"
+#include "CRSCMetrics.h"
+
+// Connects to the wireless access point a little at a time. Update() is called
+// once per pass through loop() and never waits, so the serial interface and LED
+// keep running while the board is connecting - or waiting to try again after
+// the access point has turned us away.
+//
+// The network is only needed for a message or two a day, so once Begin() has
+// been called the radio is kept powered down (forced modem sleep) except
+// between Connect() and Disconnect().
+//
+// Given the details of an earlier join, Connect() first tries to rejoin the same
+// access point on the same channel. That skips the scan, and, while the lease
+// DHCP gave us is fresh, DHCP too - the cached address is set as a static one.
+// Together those are most of the time a join takes and most of the load on the
+// access point. If that doesn't work it falls back to a full join.
+//
+// A static address is never told to the DHCP server, so it isn't kept past the
+// point a DHCP client would renew it - otherwise the server could hand it to
+// another board. Nothing renews it after a reset, either, as millis() starts
+// over and there's no telling how long the board was down; then the rejoin asks
+// DHCP for an address, and that is the one cached from then on.
+//
+// After a failed attempt the wait before the next one grows, with some jitter,
+// so a room full of boards doesn't keep the access point busy in lockstep.
+class CRSCWifiConnector
+{
+public:
+    // Where we are in the connection process
+    typedef enum
+    {
+        WIFI_STATE_IDLE,          // Not connected and not trying to be
+        WIFI_STATE_CONNECTING,    // WiFi.begin() called, waiting to be associated
+        WIFI_STATE_CONNECTED,     // Connected - the network can be used
+        WIFI_STATE_RETRY_WAIT     // Last attempt timed out, waiting to try again
+    } WifiState_t;
+
+protected:
+    // Credentials for the access point. These point into the configuration,
+    // which stays put for the life of the sketch.
+    const char* SSID;
+    const char* Password;
+
+    // Current state
+    WifiState_t State;
+
+    // A flag which, when set, indicates that the radio is powered. The SDK
+    // starts with it on.
+    bool RadioOn;
+
+    // Details of an earlier join, and whether we have any worth trying
+    wifi_cache_t Cache;
+    bool UseCache;
+
+    // Flags which, when set, indicate that the current attempt is a rejoin
+    // using Cache, and that it uses Cache's address rather than DHCP
+    bool FastAttempt;
+    bool StaticAttempt;
+
+    // The address DHCP last gave us since the board started, and millis() when
+    // it did. LeaseIP is 0 if DHCP hasn't given us one yet.
+    uint32_t LeaseIP;
+    unsigned long LeaseStartMillis;
+
+    // millis() when Connect() was called, and when the current connection
+    // attempt started
+    unsigned long ConnectStartMillis;
+    unsigned long AttemptStartMillis;
+
+    // millis() when we last printed a progress dot
+    unsigned long LastProgressMillis;
+
+    // millis() when we gave up on the last attempt, and how long to wait
+    // before the next one
+    unsigned long RetryStartMillis;
+    unsigned long RetryWaitMillis;
+
+    // Spaces out the attempts after failures
+    CRSCBackoff Retry;
+
+    // How long the last successful connection took from Connect(), in milliseconds
+    unsigned long LastConnectMilliseconds;
+
+    // Where connection times and failures go, if anywhere
+    CRSCMetrics* Metrics;
+
+    // How long to wait for the access point before giving up on an attempt - the
+    // same 20 tries at 500 milliseconds the old blocking code used
+    const unsigned long ConnectTimeout = 10000;
+
+    // How long to give a fast rejoin before falling back to a full join - with
+    // the cached address, and with DHCP
+    const unsigned long FastConnectTimeout = 2000;
+    const unsigned long FastDHCPConnectTimeout = 5000;
+
+    // How long after DHCP gave it to us the cached address may be used as a
+    // static one - half the shortest lease an event network is likely to hand
+    // out, which is when a DHCP client would renew it (milliseconds)
+    const unsigned long AddressLifeMillis = 30UL * 60UL * 1000UL;
+
+    // How often to print a progress dot while connecting
+    const unsigned long ProgressInterval = 500;
+
+    // How long to wait after the first failed attempt before trying again, and
+    // the longest we'll ever wait (milliseconds)
+    static const unsigned long RetryBaseMillis = 10000;
+    static const unsigned long RetryMaxMillis = 120000;
+
+    // Start a new connection attempt
+    void StartAttempt (void);
+
+    // Return a flag which, when set, indicates that Cache's address is one DHCP
+    // gave us since the board started, recently enough to use without asking again
+    bool LeaseFresh (void);
+
+    // Turn the radio on and off
+    void PowerUp (void);
+    void PowerDown (void);
+
+public:
+    // Constructor
+    CRSCWifiConnector (void);
+
+    // Turn the radio off until Connect() is called, and stop the SDK saving
+    // credentials to flash. Call from setup().
+    void Begin (void);
+
+    // Seed the jitter in the waits between attempts from theID, typically the
+    // board ID, so boards that fail together don't try again together
+    void SetRetrySeed (const char* theID)
+        { Retry.Seed (theID); }
+
+    // Record connection times and failed attempts in theMetrics
+    void SetMetrics (CRSCMetrics* theMetrics)
+        { Metrics = theMetrics; }
+
+    // Ask to be connected to the access point with the credentials provided,
+    // powering the radio up if need be. If theCache is given, and has something
+    // in it, a fast rejoin is tried first. Does nothing if we're already connected
+    // or working on it, so it's fine to call this on every pass through loop().
+    void Connect (const char* ssid, const char* password, const wifi_cache_t* theCache = NULL);
+
+    // Drop the connection, or stop trying to make one, and power the radio down
+    void Disconnect (void);
+
+    // Move the connection process along. Call once per pass through loop().
+    // Returns the state we're in afterwards.
+    WifiState_t Update (void);
+
+    // Return the state we're currently in
+    WifiState_t GetState (void)
+        { return (State); }
+
+    // Return a flag which, when set, indicates that we are connected
+    bool IsConnected (void)
+        { return (State == WIFI_STATE_CONNECTED); }
+
+    // Return how long the last successful connection took from Connect(), in
+    // milliseconds - including any failed fast rejoin and retries
+    unsigned long GetLastConnectMilliseconds (void)
+        { return (LastConnectMilliseconds); }
+
+    // Fill theCache in with the details of the current connection, for a fast
+    // rejoin next time. Returns false if we're not connected, or the address
+    // wasn't given to us by DHCP this time - only a DHCP address is cached, so
+    // its lease is timed from when it was given, however often it is reused.
+    bool GetWifiCache (wifi_cache_t* theCache);
+
+    // Return a flag which, when set, indicates that the cache given to Connect()
+    // was tried and didn't work, so it should be forgotten
+    bool CacheFailed (void)
+        { return ((UseCache == false) && (Cache.Channel != 0)); }
+
+    // Return a flag which, when set, indicates that the radio is powered
+    bool IsRadioOn (void)
+        { return (RadioOn); }
+};
+
+#endif
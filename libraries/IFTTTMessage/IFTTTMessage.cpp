@@ -25,115 +25,535 @@ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
 NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
-
 #include "IFTTTMessage.h"
+#include "CRSCConsole.h"
+#include "CRSCTrace.h"
 
 #define IFTTT_URL "maker.ifttt.com"
 
 // -----------------------------------------------------
-IFTTTMessageClass::IFTTTMessageClass (int updateInterval)
+IFTTTHostLookup::IFTTTHostLookup (void)
+{
+    State = LOOKUP_IDLE;
+    Host = NULL;
+    Address = 0;
+}
 
+// -----------------------------------------------------
+// Ask for theHost if it hasn't been asked for, and return how the lookup
+// stands. theAddress is set once it's LOOKUP_DONE.
+IFTTTHostLookup::LookupState_t IFTTTHostLookup::Poll (const char* theHost, IPAddress* theAddress)
 {
-    // Reserve buffers for our strings
-    PostData.reserve(120);
-    PostString.reserve(200);
-    DeviceID.reserve(10);
-    
-    UpdateInterval = updateInterval;
-    MillisecondsToRetry = updateInterval;
+    ip_addr_t found;
+
+    if (State == LOOKUP_IDLE)
+    {
+        Host = theHost;
+        State = LOOKUP_PENDING;
+
+        // lwIP answers at once from its cache, or for a dotted quad, and calls
+        // Found() later otherwise
+        switch (dns_gethostbyname (theHost, &found, Found, this))
+        {
+            case ERR_OK:
+                Address = ip_addr_get_ip4_u32 (&found);
+                State = LOOKUP_DONE;
+                break;
+
+            case ERR_INPROGRESS:
+                break;
+
+            default:
+                State = LOOKUP_FAILED;
+                break;
+        }
+    }
+
+    if (State == LOOKUP_DONE)
+        *theAddress = IPAddress (Address);
+
+    return (State);
 }
 
 // -----------------------------------------------------
-// Initialize - pass in API key for IFTTT and a tag to use in the JSON packet,
-// which is typically a unique identifier for this host. This can't be done in
-// constructor as we have to wait for personality to be read from EEPROM. Call
-// this method once before calling Send()
-void IFTTTMessageClass::Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType)
+// lwIP's answer. theAddress is NULL if there isn't one. An answer to a lookup
+// that has since been given up on, or was for another host, is dropped.
+void IFTTTHostLookup::Found (const char* theName, const ip_addr_t* theAddress, void* theArg)
+{
+    IFTTTHostLookup* lookup = (IFTTTHostLookup*)theArg;
+
+    if ((lookup->State != LOOKUP_PENDING) || (strcmp (theName, lookup->Host) != 0))
+        return;
+
+    if (theAddress != NULL)
+    {
+        lookup->Address = ip_addr_get_ip4_u32 (theAddress);
+        lookup->State = LOOKUP_DONE;
+    }
+    else
+    {
+        lookup->State = LOOKUP_FAILED;
+    }
+}
+
+// -----------------------------------------------------
+IFTTTHttpTransport::IFTTTHttpTransport (void)
+{
+    Pcb = NULL;
+    Connected = false;
+    Failed = false;
+    RemoteClosed = false;
+    Request[0] = 0x00;
+    HeaderLength = 0;
+    RequestLength = 0;
+    DeviceID[0] = 0x00;
+    Host = IFTTT_URL;
+    Port = 80;
+    StatusLineLength = 0;
+    HaveStatusLine = false;
+}
+
+// -----------------------------------------------------
+// Build the headers. If theHost is given, and isn't empty, the request goes
+// to a collector at theHost:thePort instead of ifttt.com.
+void IFTTTHttpTransport::Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                                     const char* theHost, uint16_t thePort)
+{
+    if ((theHost != NULL) && (theHost[0] != 0x00))
+    {
+        Host = theHost;
+        Port = (thePort != 0) ? thePort : 80;
+    }
+    else
+    {
+        Host = IFTTT_URL;
+        Port = 80;
+    }
+
+    strncpy (DeviceID, deviceID, DeviceIDLen - 1);
+    DeviceID[DeviceIDLen - 1] = 0x00;
+
+    // The port only goes in the Host header if it isn't the default
+    char portSuffix[8] = "";
+    if (Port != 80)
+        snprintf (portSuffix, sizeof (portSuffix), ":%u", Port);
+
+    int length = snprintf (Request, RequestLen,
+                           "POST /trigger/crsc_message/with/key/%s HTTP/1.1\r\n"
+                           "Host: %s%s\r\n"
+                           "User-Agent: %s\r\n"
+                           "Connection: close\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Content-Length: ", theAPIKey, Host, portSuffix, deviceType);
 
+    // If the headers don't leave room for a body, every send fails with
+    // IFTTT_RESULT_REQUEST_TOO_LONG
+    HeaderLength = ((length > 0) && ((unsigned)length < RequestLen)) ? length : RequestLen;
+}
+
+// -----------------------------------------------------
+// Start the handshake with HostIP. Returns false if lwIP won't - it's out of
+// connections, or there's no route.
+bool IFTTTHttpTransport::Open (void)
 {
-    DeviceID = deviceID;
-    PostData   = "";
-    
-    PostString =  "POST /trigger/crsc_message/with/key/";
-    PostString += theAPIKey;
-    PostString += " HTTP/1.1\nHost: ";
-    PostString += IFTTT_URL;
-    PostString += "\nUser-Agent: ";
-    PostString += deviceType;
-    PostString += "\nConnection: close\nContent-Type: application/json\nContent-Length: ";
+    ip_addr_t address;
+    bool returnValue = false;
+
+    Pcb = tcp_new();
+    if (Pcb != NULL)
+    {
+        tcp_arg (Pcb, this);
+        tcp_err (Pcb, OnError);
+        tcp_recv (Pcb, OnReceive);
+
+        // The request goes out in one write, so there's nothing for Nagle to wait for
+        tcp_nagle_disable (Pcb);
+
+        ip_addr_set_ip4_u32 (&address, (uint32_t)HostIP);
+        if (tcp_connect (Pcb, &address, Port, OnConnected) == ERR_OK)
+            returnValue = true;
+        else
+            Stop();
+    }
+    return (returnValue);
 }
 
 // -----------------------------------------------------
-// Connect to the ifttt service.
-bool IFTTTMessageClass::Connect (void)
+// Look up and connect to the ifttt service, or the collector standing in for
+// it, without waiting for either. The handshake is started once, on the pass
+// the address comes in, and lwIP sees it through from there.
+IFTTTTransport::ConnectStatus_t IFTTTHttpTransport::Connect (void)
 {
-   // Value which, when set, indicates connection to IFTTT server was successful
-   bool returnValue = true;
-   
-   if(TheClient.connect(IFTTT_URL,80))  // Test the connection to the server
+   ConnectStatus_t returnValue = TRANSPORT_CONNECTING;
+
+   if (Failed)
+   {
+       returnValue = TRANSPORT_FAILED;
+   }
+   else if (Connected)
    {
-     Serial.print("Connected to "); Serial.println(IFTTT_URL);
+       TheConsole.printf_P (PSTR("Connected to %s\r\n"), Host);
+       returnValue = TRANSPORT_CONNECTED;
    }
-   else
+   else if (Pcb == NULL)
    {
-     Serial.println("Failed to connect to "); Serial.println(IFTTT_URL);
-     returnValue = false;
+       switch (Lookup.Poll (Host, &HostIP))
+       {
+           case IFTTTHostLookup::LOOKUP_DONE:
+               if (Open() == false)
+                   returnValue = TRANSPORT_FAILED;
+               break;
+
+           case IFTTTHostLookup::LOOKUP_FAILED:
+               returnValue = TRANSPORT_FAILED;
+               break;
+
+           default:
+               break;
+       }
    }
-   
+
    return (returnValue);
 }
 
 // -----------------------------------------------------
-// Send a message. Return value indicates whether or not message was successfully sent
-bool IFTTTMessageClass::Send (String theMessage)
+// Close the connection, or give up on the handshake. Nothing more is wanted
+// from it, so lwIP isn't to call back about it again.
+void IFTTTHttpTransport::Stop (void)
 {
- 
-    if (Connect())
+    if (Pcb != NULL)
     {
-    	// Note that ifttt only supports labels value1, value2, value3
-  	    PostData = "{\"value1\":\"";
-   	    PostData.concat (DeviceID);
-  	    PostData.concat ("\",\"value2\":\"");
-  	    PostData.concat(theMessage);
-  	    PostData.concat("\"}");
+        tcp_arg (Pcb, NULL);
+        tcp_err (Pcb, NULL);
+        tcp_recv (Pcb, NULL);
 
-  	    TheClient.print (PostString);          // Connection details
-	    TheClient.println(PostData.length());  // length of JSON payload
-        TheClient.println();
-        TheClient.println(PostData);           // JSON payload
+        if (tcp_close (Pcb) != ERR_OK)
+            tcp_abort (Pcb);
+        Pcb = NULL;
     }
 }
 
 // -----------------------------------------------------
-// Attempt to send a message to IFTTT and return a flag which, when set, indicates success.
-// When called repeatedly, this method implements retries with a 10 second delay until
-// the message has been sent successfully.
-bool IFTTTMessageClass::SendMessage (char* theMessage)
+// The handshake is done
+err_t IFTTTHttpTransport::OnConnected (void* theArg, struct tcp_pcb* thePcb, err_t theError)
 {
-  bool returnValue = false;
+    (void)thePcb;
+    (void)theError;
 
-  MillisecondsToRetry -= UpdateInterval;
+    ((IFTTTHttpTransport*)theArg)->Connected = true;
+    return (ERR_OK);
+}
 
-  if (MillisecondsToRetry <= 0)
-  {
-    returnValue = Send (theMessage);
+// -----------------------------------------------------
+// Some of the response has arrived, or, if theData is NULL, the server has
+// hung up. Only the status line is kept - the code is near the start, so only
+// what fits of it - and the rest is dropped.
+err_t IFTTTHttpTransport::OnReceive (void* theArg, struct tcp_pcb* thePcb, struct pbuf* theData, err_t theError)
+{
+    IFTTTHttpTransport* transport = (IFTTTHttpTransport*)theArg;
+
+    (void)theError;
 
-    // If this was not successful ...
-    if (returnValue == false)
+    if (theData == NULL)
     {
-      MillisecondsToRetry = RetryInterval;
-      Serial.println (F("\nConnection to ifttt.com failed. Will try again in 10 seconds."));
-      Serial.println (F("In the mean time, please notify one of the CANARIE staff that you have completed the scavenger hunt\n\n"));
+        transport->RemoteClosed = true;
+        return (ERR_OK);
     }
-    else
+
+    for (u16_t i = 0; (i < theData->tot_len) && (transport->HaveStatusLine == false); i++)
+    {
+        char c = (char)pbuf_get_at (theData, i);
+
+        if (c == '\n')
+            transport->HaveStatusLine = true;
+        else if ((c != '\r') && (transport->StatusLineLength < sizeof (transport->StatusLine) - 1))
+            transport->StatusLine[transport->StatusLineLength++] = c;
+    }
+
+    tcp_recved (thePcb, theData->tot_len);
+    pbuf_free (theData);
+    return (ERR_OK);
+}
+
+// -----------------------------------------------------
+// The handshake failed or the connection was reset. lwIP has already freed it.
+void IFTTTHttpTransport::OnError (void* theArg, err_t theError)
+{
+    IFTTTHttpTransport* transport = (IFTTTHttpTransport*)theArg;
+
+    (void)theError;
+
+    transport->Pcb = NULL;
+    transport->Failed = true;
+}
+
+// -----------------------------------------------------
+// Fill in the rest of the request for theMessage - the Content-Length value,
+// the blank line and the JSON body - after the headers. Returns false if it
+// doesn't fit. ifttt.com only takes text, so the event and sequence aren't used.
+bool IFTTTHttpTransport::BuildRequest (const char* theMessage, uint8_t theEvent, uint32_t theSequence)
+{
+    // Note that ifttt only supports labels value1, value2, value3
+    static const char BodyFormat[] = "{\"value1\":\"%s\",\"value2\":\"%s\"}";
+    const unsigned bodyLength = (sizeof (BodyFormat) - 1 - 4) + strlen (DeviceID) + strlen (theMessage);
+    bool returnValue = false;
+
+    (void)theEvent;
+    (void)theSequence;
+    Connected = false;
+    Failed = false;
+    RemoteClosed = false;
+    StatusLineLength = 0;
+    HaveStatusLine = false;
+
+    // Look the host up again for each send, in case it has moved
+    Lookup.Reset();
+
+    if (HeaderLength < RequestLen)
     {
-        Serial.println (F("\nMessage sent to ifttt.com\n"));
+        int length = snprintf (Request + HeaderLength, RequestLen - HeaderLength, "%u\r\n\r\n", bodyLength);
+
+        if ((length > 0) && (HeaderLength + length < RequestLen))
+        {
+            RequestLength = HeaderLength + length;
+            length = snprintf (Request + RequestLength, RequestLen - RequestLength, BodyFormat, DeviceID, theMessage);
+
+            if ((length > 0) && (RequestLength + length < RequestLen))
+            {
+                RequestLength += length;
+                returnValue = true;
+            }
+        }
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------
+// Write the request for the current message. Returns true if it all went out.
+bool IFTTTHttpTransport::WriteRequest (void)
+{
+    bool returnValue = false;
+
+    // lwIP copies the request, as it may need to send it again after the next
+    // one has been built. The request is far smaller than the send buffer, so
+    // if it doesn't fit the connection has gone.
+    if ((Pcb != NULL) && (tcp_sndbuf (Pcb) >= RequestLength) &&
+        (tcp_write (Pcb, Request, RequestLength, TCP_WRITE_FLAG_COPY) == ERR_OK))
+    {
+        returnValue = (tcp_output (Pcb) == ERR_OK);
+    }
+    return (returnValue);
+}
+
+// -----------------------------------------------------
+// Returns true once the whole status line is in, with theCode set (to 0 if the
+// line isn't an HTTP status line).
+bool IFTTTHttpTransport::ReadReply (int* theCode)
+{
+    if (HaveStatusLine == false)
+        return (false);
+
+    StatusLine[StatusLineLength] = 0x00;
+
+    // Looks like "HTTP/1.1 200 OK"
+    *theCode = 0;
+    if (strncmp (StatusLine, "HTTP/", 5) == 0)
+    {
+        const char* code = strchr (StatusLine, ' ');
+        if (code != NULL)
+            *theCode = atoi (code + 1);
+    }
+    return (true);
+}
+
+// -----------------------------------------------------
+IFTTTMessageClass::IFTTTMessageClass (void)
+    : Retry (RetryBaseMillis, RetryMaxMillis)
+{
+    Transport = &HttpTransport;
+
+    State = IFTTT_STATE_IDLE;
+    Result = IFTTT_RESULT_NONE;
+    SendStartMillis = 0;
+    StageStartMillis = 0;
+    HTTPCode = 0;
+    LatencyMilliseconds = 0;
+    NextAttemptMillis = 0;
+    Metrics = NULL;
+}
+
+// -----------------------------------------------------
+// Send with theTransport instead of HTTP, or go back to HTTP if it's NULL.
+// Call before Initialize().
+void IFTTTMessageClass::SetTransport (IFTTTTransport* theTransport)
+{
+    Transport = (theTransport != NULL) ? theTransport : &HttpTransport;
+}
+
+// -----------------------------------------------------
+// Initialize - pass in API key for IFTTT and a tag to use in the JSON packet,
+// which is typically a unique identifier for this host. This can't be done in
+// constructor as we have to wait for personality to be read from EEPROM. Call
+// this method once before sending anything. If theHost is given, and isn't
+// empty, messages go to a collector at theHost:thePort instead of ifttt.com.
+void IFTTTMessageClass::Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                                    const char* theHost, uint16_t thePort)
+{
+    Retry.Seed (deviceID);
+    Transport->Initialize (theAPIKey, deviceID, deviceType, theHost, thePort);
+}
+
+// -----------------------------------------------------
+// Finish the current send with the result provided
+void IFTTTMessageClass::Finish (SendResult_t theResult)
+{
+    Result = theResult;
+    LatencyMilliseconds = millis() - SendStartMillis;
+    State = IFTTT_STATE_CLOSING;
+
+    TheTrace.Record (CRSCTrace::TRACE_SEND_DONE, Result | ((uint32_t)HTTPCode << 8));
+    if (Metrics != NULL)
+    {
+        if (Result == IFTTT_RESULT_SUCCESS)
+            Metrics->Record (CRSCMetrics::METRIC_SEND_MILLIS, LatencyMilliseconds);
+        else
+            Metrics->Count (CRSCMetrics::COUNTER_SEND_FAILURES);
+    }
+}
+
+// -----------------------------------------------------
+// Start sending a message. The message is copied into the request straight
+// away. Returns false if a send is already in progress.
+bool IFTTTMessageClass::StartSend (const char* theMessage, uint8_t theEvent, uint32_t theSequence)
+{
+    if (State != IFTTT_STATE_IDLE)
+        return (false);
+
+    Result = IFTTT_RESULT_NONE;
+    HTTPCode = 0;
+
+    SendStartMillis = millis();
+    StageStartMillis = SendStartMillis;
+    State = IFTTT_STATE_CONNECTING;
+    TheTrace.Record (CRSCTrace::TRACE_SEND_START, theSequence);
+
+    // No point connecting if the request can't be sent
+    if (Transport->BuildRequest (theMessage, theEvent, theSequence) == false)
+        Finish (IFTTT_RESULT_REQUEST_TOO_LONG);
+
+    return (true);
+}
+
+// -----------------------------------------------------
+// Move the current send along. Call once per pass through loop().
+IFTTTMessageClass::SendState_t IFTTTMessageClass::Update (void)
+{
+    switch (State)
+    {
+        case IFTTT_STATE_CONNECTING:
+            switch (Transport->Connect())
+            {
+                case IFTTTTransport::TRANSPORT_CONNECTED:
+                    StageStartMillis = millis();
+                    State = IFTTT_STATE_WRITING;
+                    break;
+
+                case IFTTTTransport::TRANSPORT_CONNECTING:
+                    if (millis() - StageStartMillis >= ConnectTimeout)
+                        Finish (IFTTT_RESULT_CONNECT_FAILED);
+                    break;
+
+                case IFTTTTransport::TRANSPORT_FAILED:
+                default:
+                    Finish (IFTTT_RESULT_CONNECT_FAILED);
+                    break;
+            }
+            break;
+
+        case IFTTT_STATE_WRITING:
+            if (Transport->WriteRequest())
+            {
+                StageStartMillis = millis();
+                State = IFTTT_STATE_READING_STATUS;
+            }
+            else
+            {
+                Finish (IFTTT_RESULT_WRITE_FAILED);
+            }
+            break;
+
+        case IFTTT_STATE_READING_STATUS:
+            if (Transport->ReadReply (&HTTPCode))
+            {
+                if (HTTPCode == 0)
+                    Finish (IFTTT_RESULT_BAD_RESPONSE);
+                else if ((HTTPCode >= 200) && (HTTPCode < 300))
+                    Finish (IFTTT_RESULT_SUCCESS);
+                else
+                    Finish (IFTTT_RESULT_HTTP_ERROR);
+            }
+            else if (millis() - StageStartMillis >= StatusTimeout)
+            {
+                Finish (IFTTT_RESULT_TIMEOUT);
+            }
+            else if (Transport->IsConnected() == false)
+            {
+                // Server hung up without answering
+                Finish (IFTTT_RESULT_BAD_RESPONSE);
+            }
+            break;
+
+        case IFTTT_STATE_CLOSING:
+            Transport->Stop();
+            State = IFTTT_STATE_IDLE;
+            break;
+
+        case IFTTT_STATE_IDLE:
+        default:
+            break;
+    }
+
+    return (State);
+}
+
+// -----------------------------------------------------
+// Attempt to send a message to IFTTT and return a flag which, when set, indicates
+// the server has accepted it. When called repeatedly, this method implements retries,
+// backing off from 10 seconds up to 2 minutes, until the message has been sent successfully.
+bool IFTTTMessageClass::SendMessage (char* theMessage, uint8_t theEvent, uint32_t theSequence)
+{
+  bool returnValue = false;
+
+  // Start a new attempt if it's time
+  if ((State == IFTTT_STATE_IDLE) && ((long)(millis() - NextAttemptMillis) >= 0))
+  {
+    StartSend (theMessage, theEvent, theSequence);
+  }
+
+  // If this call finishes the attempt ...
+  if ((State != IFTTT_STATE_IDLE) && (Update() == IFTTT_STATE_IDLE))
+  {
+    if (Result == IFTTT_RESULT_SUCCESS)
+    {
+        TheConsole.printf_P (PSTR("\nMessage sent to %s (%s %d, %lu ms)\n\r\n"),
+                             Transport->GetHost(), Transport->GetCodeName(), HTTPCode, LatencyMilliseconds);
+        returnValue = true;
         
         // Get ready for the next time we are called (ideally with a new message)
-        MillisecondsToRetry = UpdateInterval;
+        NextAttemptMillis = millis();
+        Retry.Succeeded();
+    }
+    else
+    {
+      unsigned long retryWait = Retry.Failed();
+
+      TheConsole.printf_P (PSTR("\nConnection to %s failed (result %d, %s %d). Will try again in %lu seconds.\r\n"),
+                           Transport->GetHost(), (int)Result, Transport->GetCodeName(), HTTPCode, (unsigned long)((retryWait + 500) / 1000));
+      TheConsole.println (F("In the mean time, please notify one of the CANARIE staff that you have completed the scavenger hunt\n\n"));
+
+      NextAttemptMillis = millis() + retryWait;
     }
   }  
   return (returnValue);
 
 }
-   
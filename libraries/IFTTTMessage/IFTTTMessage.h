@@ -32,82 +32,327 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Arduino.h>
 
-#include <WiFiServerSecure.h>
-#include <WiFiClientSecure.h>
-#include <WiFiClientSecureBearSSL.h>
 #include <ESP8266WiFi.h>
-#include <ESP8266WiFiMulti.h>
-#include <WiFiUdp.h>
-#include <ESP8266WiFiType.h>
-#include <CertStoreBearSSL.h>
-#include <ESP8266WiFiAP.h>
-#include <WiFiClient.h>
-#include <BearSSLHelpers.h>
-#include <WiFiServer.h>
-#include <ESP8266WiFiScan.h>
-#include <WiFiServerSecureBearSSL.h>
-#include <ESP8266WiFiGeneric.h>
-#include <ESP8266WiFiSTA.h>
-#include <WiFiClientSecureAxTLS.h>
-#include <WiFiServerSecureAxTLS.h>
+#include <lwip/dns.h>
+#include <lwip/tcp.h>
 
+#include "CRSCBackoff.h"
+#include "CRSCMetrics.h"
 
+
+// How a message gets to the server and how the answer comes back. IFTTTMessageClass
+// runs the send - the stages, their timeouts, the retries and the reporting - and
+// calls on a transport for each stage. The HTTP POST ifttt.com takes is the
+// default; a collector on the event network can take something lighter.
+class IFTTTTransport
+{
+  public:
+    // How far Connect() got
+    typedef enum
+    {
+        TRANSPORT_CONNECTED,    // The request can be written
+        TRANSPORT_CONNECTING,   // Not there yet - call Connect() again on the next pass
+        TRANSPORT_FAILED        // No point trying again
+    } ConnectStatus_t;
+
+    virtual ~IFTTTTransport (void) {}
+
+    // Set up for sending from deviceID to theHost:thePort. Called by
+    // IFTTTMessageClass::Initialize().
+    virtual void Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                             const char* theHost, uint16_t thePort) = 0;
+
+    // Get what goes on the wire ready for a message. theEvent and theSequence say
+    // what it is and which one, for transports that don't send the text. Returns
+    // false if it can't be sent.
+    virtual bool BuildRequest (const char* theMessage, uint8_t theEvent, uint32_t theSequence) = 0;
+
+    // Open the way to the server without waiting for it. Called on every pass
+    // until it stops returning TRANSPORT_CONNECTING, or IFTTTMessageClass runs
+    // out of patience.
+    virtual ConnectStatus_t Connect (void) = 0;
+
+    // Send what BuildRequest() got ready. Returns true if it all went out.
+    virtual bool WriteRequest (void) = 0;
+
+    // Look for the server's answer. Returns true once it's in, with theCode set
+    // to its HTTP status (0 if it didn't make sense).
+    virtual bool ReadReply (int* theCode) = 0;
+
+    // Return a flag which, when clear, indicates the server has gone away without answering
+    virtual bool IsConnected (void) = 0;
+
+    // Close whatever Connect() opened
+    virtual void Stop (void) = 0;
+
+    // Where messages go, and what the code ReadReply() returns is, for reporting
+    virtual const char* GetHost (void) = 0;
+    virtual const char* GetCodeName (void) = 0;
+};
+
+
+// Looks a host name up for a transport without holding up loop(). lwIP sends
+// the query, and sends it again if need be, while the sketch carries on; the
+// transport polls on each pass until the answer is in. A dotted quad needs no
+// lookup.
+class IFTTTHostLookup
+{
+  public:
+    typedef enum
+    {
+        LOOKUP_IDLE,        // Not asked yet
+        LOOKUP_PENDING,     // Asked, no answer yet - poll again on the next pass
+        LOOKUP_DONE,        // Have the address
+        LOOKUP_FAILED       // No such host, or the server never answered
+    } LookupState_t;
+
+  private:
+    // Set by Found(), which lwIP calls between passes
+    volatile LookupState_t State;
+    const char* Host;
+    uint32_t Address;
+
+    // lwIP's answer. theAddress is NULL if there isn't one.
+    static void Found (const char* theName, const ip_addr_t* theAddress, void* theArg);
+
+  public:
+    // Constructor
+    IFTTTHostLookup (void);
+
+    // Forget the last answer, so the next Poll() asks again
+    void Reset (void)
+        { State = LOOKUP_IDLE; }
+
+    // Ask for theHost if it hasn't been asked for, and return how the lookup
+    // stands. theAddress is set once it's LOOKUP_DONE.
+    LookupState_t Poll (const char* theHost, IPAddress* theAddress);
+};
+
+
+// The HTTP POST ifttt.com's maker channel takes - or a collector standing in for it.
+//
+// The request is built in a fixed buffer and goes to lwIP in a single write, so
+// it leaves in one segment instead of a handful of small ones held up by Nagle,
+// and nothing on the send path uses the heap.
+//
+// The connection is lwIP's raw TCP interface rather than a WiFiClient, whose
+// connect() waits for the handshake to finish. Here the handshake is started and
+// left to lwIP, which resends the SYN on its own schedule, and each pass only
+// looks at whether it has finished - so a slow server or a busy access point
+// costs the sketch nothing while it waits. lwIP calls back between passes.
+class IFTTTHttpTransport : public IFTTTTransport
+{
+  private:
+
+     // The connection, NULL when there isn't one. lwIP frees it itself when the
+     // handshake fails or the connection is reset, and says so through Error().
+     struct tcp_pcb* Pcb;
+
+     // What lwIP has said about the connection since the send started
+     volatile bool Connected;
+     volatile bool Failed;
+     volatile bool RemoteClosed;
+
+     // Size of the request buffer, and of the first label of the JSON packet
+     static const unsigned RequestLen = 320;
+     static const unsigned DeviceIDLen = 16;
+
+     // The request for the current message, headers and JSON body. Everything up
+     // to the Content-Length value is filled in once, by Initialize().
+     char Request[RequestLen];
+     unsigned HeaderLength;
+     unsigned RequestLength;
+
+     // The first label of the JSON packet, typically a unique identifier for the host
+     char DeviceID[DeviceIDLen];
+
+     // Where messages go - ifttt.com unless Initialize() was given a collector.
+     // Host points into the configuration, which stays put for the life of the sketch.
+     // HostIP is looked up again for each send.
+     const char* Host;
+     uint16_t Port;
+     IPAddress HostIP;
+     IFTTTHostLookup Lookup;
+
+     // The status line of the response, as Receive() is handed it, and a flag
+     // which, when set, indicates all of it is in
+     char StatusLine[40];
+     volatile unsigned StatusLineLength;
+     volatile bool HaveStatusLine;
+
+     // Start the handshake with HostIP. Returns false if lwIP won't.
+     bool Open (void);
+
+     // lwIP's callbacks. theArg is the transport.
+     static err_t OnConnected (void* theArg, struct tcp_pcb* thePcb, err_t theError);
+     static err_t OnReceive (void* theArg, struct tcp_pcb* thePcb, struct pbuf* theData, err_t theError);
+     static void OnError (void* theArg, err_t theError);
+
+  public:
+    // Constructor
+    IFTTTHttpTransport (void);
+
+    // Build the headers. If theHost is given, and isn't empty, the request goes
+    // to a collector at theHost:thePort instead of ifttt.com.
+    void Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                     const char* theHost, uint16_t thePort);
+
+    // Fill in the rest of the request for theMessage. Returns false if it doesn't fit.
+    bool BuildRequest (const char* theMessage, uint8_t theEvent, uint32_t theSequence);
+
+    // Look up and connect to the ifttt service, or the collector standing in for
+    // it, without waiting for either
+    ConnectStatus_t Connect (void);
+
+    // Write the request for the current message. Returns true if it all went out.
+    bool WriteRequest (void);
+
+    // Returns true once the whole status line is in, with theCode set
+    bool ReadReply (int* theCode);
+
+    // Return a flag which, when clear, indicates the server has hung up
+    bool IsConnected (void)
+        { return ((Pcb != NULL) && (RemoteClosed == false)); }
+
+    // Close the connection, or give up on the handshake. We asked for
+    // "Connection: close" and only care about the status, so there's no need
+    // to read the rest of the response.
+    void Stop (void);
+
+    // Where messages go - ifttt.com or the collector - and the code is the HTTP status
+    const char* GetHost (void)
+        { return (Host); }
+    const char* GetCodeName (void)
+        { return ("HTTP"); }
+};
+
+
+// Sends a message to ifttt.com without holding up loop(). A send goes through
+// connect, write request, read the reply and close, one step per call to
+// Update(), and each stage has its own timeout. When it's done, the HTTP status
+// code and how long the whole thing took are available. The wire work is done
+// by a transport - HTTP unless SetTransport() says otherwise.
 class IFTTTMessageClass
 {
+  public:
+     // Where we are in sending the current message
+     typedef enum
+     {
+         IFTTT_STATE_IDLE,             // Nothing in progress
+         IFTTT_STATE_CONNECTING,       // About to open the connection
+         IFTTT_STATE_WRITING,          // Connected, about to send the request
+         IFTTT_STATE_READING_STATUS,   // Waiting for the reply
+         IFTTT_STATE_CLOSING           // Have a result, about to close the connection
+     } SendState_t;
+
+     // How the last send turned out
+     typedef enum
+     {
+         IFTTT_RESULT_NONE,            // No send has finished yet
+         IFTTT_RESULT_SUCCESS,         // Server accepted the message (HTTP 2xx)
+         IFTTT_RESULT_CONNECT_FAILED,  // Couldn't connect to the server
+         IFTTT_RESULT_WRITE_FAILED,    // Connection dropped while sending the request
+         IFTTT_RESULT_TIMEOUT,         // No reply before the read timeout
+         IFTTT_RESULT_BAD_RESPONSE,    // Reply didn't make sense
+         IFTTT_RESULT_HTTP_ERROR,      // Server answered with something other than 2xx
+         IFTTT_RESULT_REQUEST_TOO_LONG // Key, device ID and message don't fit in the request buffer
+     } SendResult_t;
+
   private:
-      
-     // Storage for the ifttt.com API key  
-     char* APIKey;
-    
-     // Client we use to communicate with the outside world
-     WiFiClient TheClient;
-    
-     // String used for the variable parts of the message sent to IFTTT.
-     // Defined here to avoid possible heap fragmentation associated with
-     // string manipulation.
-     String PostData;
-    
-     // String used for static parts of message sent to IFTTT
-     String PostString;    
-    
-     // String used to hold the first label of the JSON packet, typically a
-     // unique identifier for the host
-     String DeviceID;
-    
-     // Connect to the ifttt service. Returns true if connection was successful
-     virtual bool Connect (void);
-
-     // Send a message. Return value indicates whether or not message was successfully sent
-     virtual bool Send (String theMessage);
-   
-     // The period, in milliseconds, at which SendMessage will be called in case
-     // a communications failure requires retries.
-     int UpdateInterval;  
-     
-     // In the case of a failure to communicate with ifttt, this variable counts how
-     // long we should wait until we try again.
-     int MillisecondsToRetry;
+
+     // The transport used unless SetTransport() is given another, and the one in use
+     IFTTTHttpTransport HttpTransport;
+     IFTTTTransport* Transport;
+
+     // Where we are in sending the current message, and how the last one went
+     SendState_t State;
+     SendResult_t Result;
+
+     // millis() when the current send started, and when the current stage started
+     unsigned long SendStartMillis;
+     unsigned long StageStartMillis;
+
+     // HTTP status code of the last response (0 if there wasn't one) and how long
+     // the last send took from start to reply, in milliseconds
+     int HTTPCode;
+     unsigned long LatencyMilliseconds;
+
+     // When SendMessage() should next try. Used to space out retries after a failure.
+     unsigned long NextAttemptMillis;
+
+     // How long to wait after each failure in a row. Seeded from the device ID so
+     // boards that fail together don't all come back together.
+     CRSCBackoff Retry;
+
+     // Where send times and failures go, if anywhere
+     CRSCMetrics* Metrics;
+
+     // How long to wait for the lookup and handshake, and how long to wait for
+     // the reply once the request has been sent
+     const unsigned long ConnectTimeout = 5000;
+     const unsigned long StatusTimeout = 10000;
      
      // The time in milliseconds to wait after a failed attempt to communicate with ifttt
-     // before trying again.
-     const int RetryInterval = 10000;
+     // before trying again, and the longest we'll ever wait after several.
+     static const unsigned long RetryBaseMillis = 10000;
+     static const unsigned long RetryMaxMillis = 120000;
+
+     // Finish the current send with the result provided
+     void Finish (SendResult_t theResult);
 
 
   public:
     // Constructor - doens't do much because we have to wait until configuration
     // is loaded before initializing most of this object
-    IFTTTMessageClass (int updateInterval);
+    IFTTTMessageClass (void);
+
+    // Send with theTransport instead of HTTP, or go back to HTTP if it's NULL.
+    // Call before Initialize().
+    void SetTransport (IFTTTTransport* theTransport);
+
+    // Record how long each delivered message took, and failed sends, in theMetrics
+    void SetMetrics (CRSCMetrics* theMetrics)
+        { Metrics = theMetrics; }
 
     // Initialize - pass in API key for IFTTT and a tag to use in the JSON packet,
     // which is typically a unique identifier for this host. This can't be done in
     // constructor as we have to wait for personality to be read from EEPROM. Call
-    // this method once before calling Send()
-    void Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType);
+    // this method once before sending anything. If theHost is given, and isn't
+    // empty, messages go to a collector at theHost:thePort instead of ifttt.com.
+    void Initialize (const char* theAPIKey, const char* deviceID, const char* deviceType,
+                     const char* theHost = NULL, uint16_t thePort = 80);
+
+    // Start sending a message. The message is copied into the request straight
+    // away. theEvent and theSequence say what the message is, for transports
+    // that don't send the text. Returns false, and does nothing, if a send is
+    // already in progress.
+    bool StartSend (const char* theMessage, uint8_t theEvent = 0, uint32_t theSequence = 0);
+
+    // Move the current send along. Call once per pass through loop(). Returns the
+    // state we're in afterwards - IFTTT_STATE_IDLE once the send has finished.
+    SendState_t Update (void);
+
+    // Return a flag which, when set, indicates that a send is in progress
+    bool IsBusy (void)
+        { return (State != IFTTT_STATE_IDLE); }
+
+    // Return how the last send turned out
+    SendResult_t GetResult (void)
+        { return (Result); }
+
+    // Return the HTTP status code of the last response, or 0 if there wasn't one
+    int GetHTTPCode (void)
+        { return (HTTPCode); }
+
+    // Return how long the last send took, in milliseconds
+    unsigned long GetLatencyMilliseconds (void)
+        { return (LatencyMilliseconds); }
 
-    // Attempt to send a message to IFTTT and return a flag which, when set, indicates success.
-    // When called repeatedly, this method implements retries with a 10 second delay until
-    // the message has been sent successfully.
-    bool SendMessage (char* theMessage);
+    // Attempt to send a message to IFTTT and return a flag which, when set, indicates
+    // the server has accepted it. Call repeatedly - each call moves the send along, and
+    // a failed send is retried, backing off from 10 seconds up to 2 minutes, until it
+    // gets through.
+    bool SendMessage (char* theMessage, uint8_t theEvent = 0, uint32_t theSequence = 0);
 };
 
 #endif